@@ -25,9 +25,44 @@
 
 #include "circular_buffer.h"
 
+#if defined(WIN32) || defined(_WIN32_WCE)
+#include <windows.h>
+#endif
+
 
 //#define DEBUG
 
+/*
+ * Nodes are never locked: the producer and the consumers only update the node counters
+ * with atomic operations (which all act as full memory barriers) and sleep on the node
+ * semaphores when the node they want is not ready (consumers) or not released (producer).
+ */
+#if defined(WIN32) || defined(_WIN32_WCE)
+#define dc_atomic_inc(_v)	InterlockedIncrement((LONG volatile *)(_v))
+#define dc_atomic_dec(_v)	InterlockedDecrement((LONG volatile *)(_v))
+#define dc_atomic_get(_v)	InterlockedCompareExchange((LONG volatile *)(_v), 0, 0)
+#define dc_atomic_set(_v, _val)	InterlockedExchange((LONG volatile *)(_v), (_val))
+#define dc_atomic_cas(_v, _old, _new)	(InterlockedCompareExchange((LONG volatile *)(_v), (_new), (_old)) == (_old))
+#else
+#define dc_atomic_inc(_v)	__sync_add_and_fetch((_v), 1)
+#define dc_atomic_dec(_v)	__sync_sub_and_fetch((_v), 1)
+#define dc_atomic_get(_v)	__sync_fetch_and_add((_v), 0)
+#define dc_atomic_set(_v, _val)	{ __sync_synchronize(); *(_v) = (_val); __sync_synchronize(); }
+#define dc_atomic_cas(_v, _old, _new)	__sync_bool_compare_and_swap((_v), (_old), (_new))
+#endif
+
+/* the node is the last node, or holds valid data and its producer is done with it */
+#define DC_NODE_READY(_node)	((dc_atomic_get(&(_node)->marked) == 2) || (dc_atomic_get(&(_node)->marked) && !dc_atomic_get(&(_node)->num_producers)))
+/* all consumers are done with the node */
+#define DC_NODE_FREE(_node)	(!dc_atomic_get(&(_node)->marked) && !dc_atomic_get(&(_node)->num_consumers))
+
+/* wakes up the threads sleeping on the given node semaphore, if any */
+static void dc_node_notify(volatile int *num_waiting, GF_Semaphore *sema)
+{
+	int num = dc_atomic_get(num_waiting);
+	if (num > 0)
+		gf_sema_notify(sema, num);
+}
 
 void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode mode, int max_num_consumers)
 {
@@ -36,6 +71,7 @@ void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode
 	circular_buf->list = (Node*)gf_malloc(size * sizeof(Node));
 	circular_buf->mode = mode;
 	circular_buf->max_num_consumers = max_num_consumers;
+	circular_buf->num_produced = 0;
 
 	for (i=0; i<size; i++) {
 		circular_buf->list[i].num_producers = 0;
@@ -43,9 +79,9 @@ void dc_circular_buffer_create(CircularBuffer *circular_buf, u32 size, LockMode
 		circular_buf->list[i].num_consumers_accessed = 0;
 		circular_buf->list[i].marked = 0;
 		circular_buf->list[i].num_consumers_waiting = 0;
+		circular_buf->list[i].num_producers_waiting = 0;
 		circular_buf->list[i].consumers_semaphore = gf_sema_new(1000, 0);
 		circular_buf->list[i].producers_semaphore = gf_sema_new(1000, 0);
-		circular_buf->list[i].mutex = gf_mx_new("Circular Buffer Mutex");
 	}
 }
 
@@ -55,7 +91,6 @@ void dc_circular_buffer_destroy(CircularBuffer *circular_buf)
 	for (i = 0; i < circular_buf->size; i++) {
 		gf_sema_del(circular_buf->list[i].consumers_semaphore);
 		gf_sema_del(circular_buf->list[i].producers_semaphore);
-		gf_mx_del(circular_buf->list[i].mutex);
 	}
 
 	gf_free(circular_buf->list);
@@ -66,6 +101,11 @@ void dc_consumer_init(Consumer *consumer, int max_idx, char *name)
 	consumer->idx = 0;
 	consumer->max_idx = max_idx;
 	strcpy(consumer->name, name);
+	consumer->num_consumed = 0;
+	consumer->num_waits = 0;
+	consumer->wait_time = 0;
+	consumer->max_depth = 0;
+	consumer->total_depth = 0;
 }
 
 void * dc_consumer_consume(Consumer *consumer, CircularBuffer *circular_buf)
@@ -73,36 +113,48 @@ void * dc_consumer_consume(Consumer *consumer, CircularBuffer *circular_buf)
 	return circular_buf->list[consumer->idx].data;
 }
 
+static void dc_consumer_log_stats(Consumer *consumer)
+{
+	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DashCast] Consumer %s: %d nodes - waited %d times for "LLU" us - queue depth avg %.2f max %d\n",
+	                                  consumer->name, consumer->num_consumed, consumer->num_waits, consumer->wait_time,
+	                                  consumer->num_consumed ? (Double) (s64) consumer->total_depth / consumer->num_consumed : 0, consumer->max_depth));
+}
+
 int dc_consumer_lock(Consumer *consumer, CircularBuffer *circular_buf)
 {
+	int depth;
 	Node *node = &circular_buf->list[consumer->idx];
 
-	gf_mx_p(node->mutex);
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
+	if (dc_atomic_get(&node->marked) == 2) {
+		dc_consumer_log_stats(consumer);
 		return -1;
 	}
 
-	node->num_consumers_waiting++;
-	while (node->num_producers || !node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->consumers_semaphore);
-		gf_mx_p(node->mutex);
-
-		if (node->marked == 2) {
-			gf_mx_v(node->mutex);
-			return -1;
+	if (!DC_NODE_READY(node)) {
+		u64 wait_start = gf_sys_clock_high_res();
+		while (!DC_NODE_READY(node)) {
+			/*register as waiting before checking again, so that the producer cannot miss us*/
+			dc_atomic_inc(&node->num_consumers_waiting);
+			if (!DC_NODE_READY(node))
+				gf_sema_wait(node->consumers_semaphore);
+			dc_atomic_dec(&node->num_consumers_waiting);
 		}
+		consumer->num_waits++;
+		consumer->wait_time += gf_sys_clock_high_res() - wait_start;
 	}
-	node->num_consumers_waiting--;
 
-	if (node->marked == 2) {
-		gf_mx_v(node->mutex);
+	if (dc_atomic_get(&node->marked) == 2) {
+		dc_consumer_log_stats(consumer);
 		return -1;
 	}
-	node->num_consumers++;
-	node->num_consumers_accessed++;
-	gf_mx_v(node->mutex);
+	dc_atomic_inc(&node->num_consumers);
+	dc_atomic_inc(&node->num_consumers_accessed);
+
+	depth = dc_atomic_get(&circular_buf->num_produced) - consumer->num_consumed;
+	if (depth > 0) {
+		if ((u32) depth > consumer->max_depth) consumer->max_depth = depth;
+		consumer->total_depth += depth;
+	}
 
 	return 0;
 }
@@ -112,18 +164,15 @@ int dc_consumer_unlock(Consumer *consumer, CircularBuffer *circular_buf)
 	int last_consumer = 0;
 	Node *node = &circular_buf->list[consumer->idx];
 
-	gf_mx_p(node->mutex);
-	node->num_consumers--;
+	dc_atomic_dec(&node->num_consumers);
 
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		node->marked = 0;
-		node->num_consumers_accessed = 0;
+	/*only one consumer can reset the access count and release the node*/
+	if (dc_atomic_cas(&node->num_consumers_accessed, (int) circular_buf->max_num_consumers, 0)) {
+		dc_atomic_set(&node->marked, 0);
 		last_consumer = 1;
 	}
 
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
+	dc_node_notify(&node->num_producers_waiting, node->producers_semaphore);
 
 	return last_consumer;
 }
@@ -132,24 +181,19 @@ int dc_consumer_unlock_previous(Consumer *consumer, CircularBuffer *circular_buf
 {
 	int node_idx = (consumer->idx - 1 + consumer->max_idx) % consumer->max_idx;
 	int last_consumer = 0;
+	int num_consumers;
 	Node *node = &circular_buf->list[node_idx];
 
-	gf_mx_p(node->mutex);
-
-	node->num_consumers--;
-	if (node->num_consumers < 0)
-		node->num_consumers = 0;
+	do {
+		num_consumers = dc_atomic_get(&node->num_consumers);
+	} while ((num_consumers > 0) && !dc_atomic_cas(&node->num_consumers, num_consumers, num_consumers - 1));
 
-	if (node->num_consumers_accessed == circular_buf->max_num_consumers) {
-		if (node->marked != 2)
-			node->marked = 0;
-		node->num_consumers_accessed = 0;
+	if (dc_atomic_cas(&node->num_consumers_accessed, (int) circular_buf->max_num_consumers, 0)) {
+		dc_atomic_cas(&node->marked, 1, 0);
 		last_consumer = 1;
 	}
 
-	gf_sema_notify(node->producers_semaphore, 1);
-
-	gf_mx_v(node->mutex);
+	dc_node_notify(&node->num_producers_waiting, node->producers_semaphore);
 
 	return last_consumer;
 }
@@ -157,6 +201,7 @@ int dc_consumer_unlock_previous(Consumer *consumer, CircularBuffer *circular_buf
 void dc_consumer_advance(Consumer *consumer)
 {
 	consumer->idx = (consumer->idx + 1) % consumer->max_idx;
+	consumer->num_consumed++;
 }
 
 void dc_producer_init(Producer *producer, int max_idx, char *name)
@@ -164,6 +209,9 @@ void dc_producer_init(Producer *producer, int max_idx, char *name)
 	producer->idx = 0;
 	producer->max_idx = max_idx;
 	strcpy(producer->name, name);
+	producer->num_waits = 0;
+	producer->num_drops = 0;
+	producer->wait_time = 0;
 }
 
 void * dc_producer_produce(Producer *producer, CircularBuffer *circular_buf)
@@ -175,26 +223,30 @@ int dc_producer_lock(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-
-	if ( (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA) && (node->num_consumers || node->marked)) {
-		gf_mx_v(node->mutex);
-		return -1;
-	}
+	if (!DC_NODE_FREE(node)) {
+		u64 wait_start;
+		if (circular_buf->mode == LIVE_CAMERA || circular_buf->mode == LIVE_MEDIA) {
+			producer->num_drops++;
+			return -1;
+		}
 
-	while (node->num_consumers || node->marked) {
-		gf_mx_v(node->mutex);
-		gf_sema_wait(node->producers_semaphore);
-		gf_mx_p(node->mutex);
+		wait_start = gf_sys_clock_high_res();
+		while (!DC_NODE_FREE(node)) {
+			dc_atomic_inc(&node->num_producers_waiting);
+			if (!DC_NODE_FREE(node))
+				gf_sema_wait(node->producers_semaphore);
+			dc_atomic_dec(&node->num_producers_waiting);
+		}
+		producer->num_waits++;
+		producer->wait_time += gf_sys_clock_high_res() - wait_start;
 	}
 
-	node->num_producers++;
+	/*take the node before marking it, so that consumers keep waiting until it is released*/
+	dc_atomic_inc(&node->num_producers);
 	if (circular_buf->size>1) {
-		node->marked = 1;
+		dc_atomic_set(&node->marked, 1);
 	}
 
-	gf_mx_v(node->mutex);
-
 	return 0;
 }
 
@@ -202,10 +254,8 @@ void dc_producer_unlock(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers--;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	dc_atomic_dec(&node->num_producers);
+	dc_node_notify(&node->num_consumers_waiting, node->consumers_semaphore);
 }
 
 void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -213,33 +263,30 @@ void dc_producer_unlock_previous(Producer *producer, CircularBuffer *circular_bu
 	int node_idx = (producer->idx - 1 + producer->max_idx) % producer->max_idx;
 	Node *node = &circular_buf->list[node_idx];
 
-	gf_mx_p(node->mutex);
-	node->num_producers = 0;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	gf_mx_v(node->mutex);
+	dc_atomic_set(&node->num_producers, 0);
+	dc_node_notify(&node->num_consumers_waiting, node->consumers_semaphore);
 }
 
 void dc_producer_advance(Producer *producer, CircularBuffer *circular_buf)
 {
 	if (circular_buf->size == 1) {
 		Node *node = &circular_buf->list[producer->idx];
-		gf_mx_p(node->mutex);
-		node->marked = 1;
-		gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-		gf_mx_v(node->mutex);
+		dc_atomic_set(&node->marked, 1);
+		dc_node_notify(&node->num_consumers_waiting, node->consumers_semaphore);
 	}
 	producer->idx = (producer->idx + 1) % producer->max_idx;
+	dc_atomic_inc(&circular_buf->num_produced);
 }
 
 void dc_producer_end_signal(Producer *producer, CircularBuffer *circular_buf)
 {
 	Node *node = &circular_buf->list[producer->idx];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
+	dc_atomic_set(&node->marked, 2);
+	dc_node_notify(&node->num_consumers_waiting, node->consumers_semaphore);
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, producer->idx));
-	gf_mx_v(node->mutex);
+	GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DashCast] Producer %s: %d nodes - waited %d times for "LLU" us - found the buffer full %d times\n",
+	                                  producer->name, circular_buf->num_produced, producer->num_waits, producer->wait_time, producer->num_drops));
 }
 
 void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circular_buf)
@@ -247,9 +294,7 @@ void dc_producer_end_signal_previous(Producer *producer, CircularBuffer *circula
 	int i_node = (producer->max_idx + producer->idx - 1) % producer->max_idx;
 	Node *node = &circular_buf->list[i_node];
 
-	gf_mx_p(node->mutex);
-	node->marked = 2;
-	gf_sema_notify(node->consumers_semaphore, node->num_consumers_waiting);
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, node));
-	gf_mx_v(node->mutex);
+	dc_atomic_set(&node->marked, 2);
+	dc_node_notify(&node->num_consumers_waiting, node->consumers_semaphore);
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("producer %s sends end signal %d \n", producer->name, i_node));
 }
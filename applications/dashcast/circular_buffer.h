@@ -48,18 +48,21 @@ typedef enum {
 /*
  * Every node of the circular buffer has a data, plus
  * all the variables needed for multithread management.
+ * The counters are only modified with atomic operations: users never
+ * lock a node, they only sleep on its semaphores when the node is
+ * empty (consumers) or full (producer).
  */
 typedef struct {
 	/* Pointer to the data on the node */
 	void *data;
 	/* The number of the producer currently using this node */
-	int num_producers;
+	volatile int num_producers;
 	/* The number of consumer currently using this node */
-	int num_consumers;
+	volatile int num_consumers;
 	/* The number of consumer currently waiting for this node */
-	int num_consumers_waiting;
-	/* Mutex used for synchronizing the users of this node. */
-	GF_Mutex *mutex;
+	volatile int num_consumers_waiting;
+	/* The number of producer currently waiting for this node */
+	volatile int num_producers_waiting;
 	/* Semaphore for producer */
 	GF_Semaphore *producers_semaphore;
 	/* Semaphore for consumers */
@@ -67,10 +70,10 @@ typedef struct {
 	/* If marked is 0 it means the data on this node is not valid.
 	 * If marked is 1 it means that the data on this node is valid.
 	 * If marked is 2 it means this node is the last node. */
-	int marked;
+	volatile int marked;
 	/* Indicates the number of consumers which already accessed this node.
 	 * It is used for the case where the last consumer has to do something. */
-	int num_consumers_accessed;
+	volatile int num_consumers_accessed;
 } Node;
 
 /*
@@ -87,6 +90,8 @@ typedef struct {
 	LockMode mode;
 	/* The maximum number of the consumers using the circular buffer */
 	u32 max_num_consumers;
+	/* Sequence number of the next node to be produced, used to compute the queue depth of consumers */
+	volatile int num_produced;
 } CircularBuffer;
 
 /*
@@ -99,6 +104,11 @@ typedef struct {
 	int max_idx;
 
 	char name[GF_MAX_PATH];
+
+	/* Statistics: number of times the producer found the buffer full and waited (or gave up in live modes) */
+	u32 num_waits, num_drops;
+	/* Statistics: total time spent waiting for a free node, in microseconds */
+	u64 wait_time;
 } Producer;
 
 /*
@@ -111,6 +121,16 @@ typedef struct {
 	int max_idx;
 
 	char name[GF_MAX_PATH];
+
+	/* Sequence number of the next node to be consumed */
+	int num_consumed;
+	/* Statistics: number of times the consumer found the buffer empty and waited */
+	u32 num_waits;
+	/* Statistics: total time spent waiting for a node, in microseconds */
+	u64 wait_time;
+	/* Statistics: maximum and accumulated queue depth seen when locking a node */
+	u32 max_depth;
+	u64 total_depth;
 } Consumer;
 
 /*
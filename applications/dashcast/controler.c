@@ -267,6 +267,84 @@ static void dc_write_mpd(CmdData *cmddata, const AudioDataConf *audio_data_conf,
 	gf_fclose(f);
 }
 
+static void dc_stage_stats_init(StageStats *stats, GF_List *stage_stats, const char *name)
+{
+	memset(stats, 0, sizeof(StageStats));
+	strncpy(stats->name, name, GF_MAX_PATH-1);
+	stats->mx = gf_mx_new("Stage Stats");
+	gf_list_add(stage_stats, stats);
+}
+
+static void dc_stage_stats_del(GF_List *stage_stats)
+{
+	u32 i;
+	for (i=0; i<gf_list_count(stage_stats); i++) {
+		StageStats *stats = (StageStats*)gf_list_get(stage_stats, i);
+		gf_mx_del(stats->mx);
+	}
+	gf_list_del(stage_stats);
+}
+
+/*accounts processed frames and times of a stage, and copies its queue statistics so that they can be reported after the stage is done*/
+static void dc_stage_stats_update(StageStats *stats, u32 nb_frames, u64 process_time, u64 mux_time, Consumer *consumer, Producer *producer)
+{
+	gf_mx_p(stats->mx);
+	stats->nb_frames += nb_frames;
+	stats->process_time += process_time;
+	stats->mux_time += mux_time;
+	if (consumer) {
+		stats->nb_waits = consumer->num_waits;
+		stats->wait_time = consumer->wait_time;
+		stats->total_depth = consumer->total_depth;
+	}
+	if (producer) {
+		stats->nb_drops = producer->num_drops;
+	}
+	gf_mx_v(stats->mx);
+}
+
+/*logs the per-stage statistics accumulated since the previous report*/
+static void dc_stage_stats_report(GF_List *stage_stats)
+{
+	u32 i, count;
+	if (!stage_stats || !gf_log_tool_level_on(GF_LOG_DASH, GF_LOG_INFO))
+		return;
+
+	count = gf_list_count(stage_stats);
+	for (i=0; i<count; i++) {
+		StageStats *stats = (StageStats*)gf_list_get(stage_stats, i);
+		u32 nb_frames, nb_waits, nb_drops;
+		u64 wait_time, total_depth;
+
+		gf_mx_p(stats->mx);
+		nb_frames = stats->nb_frames - stats->last_nb_frames;
+		nb_waits = stats->nb_waits - stats->last_nb_waits;
+		nb_drops = stats->nb_drops - stats->last_nb_drops;
+		wait_time = stats->wait_time - stats->last_wait_time;
+		total_depth = stats->total_depth - stats->last_total_depth;
+
+		if (nb_frames) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DashCast] Stage %s: %d frames - process %.2f ms/frame - mux %.2f ms/frame - input wait %.2f ms/frame (%d waits) - input queue depth %.2f - output full %d times\n",
+			                                  stats->name, nb_frames,
+			                                  (Double) (s64) (stats->process_time - stats->last_process_time) / 1000 / nb_frames,
+			                                  (Double) (s64) (stats->mux_time - stats->last_mux_time) / 1000 / nb_frames,
+			                                  (Double) (s64) wait_time / 1000 / nb_frames, nb_waits,
+			                                  (Double) (s64) total_depth / nb_frames, nb_drops));
+		} else {
+			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("[DashCast] Stage %s: no frame processed - output full %d times\n", stats->name, nb_drops));
+		}
+
+		stats->last_nb_frames = stats->nb_frames;
+		stats->last_nb_waits = stats->nb_waits;
+		stats->last_nb_drops = stats->nb_drops;
+		stats->last_process_time = stats->process_time;
+		stats->last_mux_time = stats->mux_time;
+		stats->last_wait_time = stats->wait_time;
+		stats->last_total_depth = stats->total_depth;
+		gf_mx_v(stats->mx);
+	}
+}
+
 static u32 mpd_thread(void *params)
 {
 	ThreadParam *th_param = (ThreadParam*)params;
@@ -356,6 +434,8 @@ static u32 mpd_thread(void *params)
 			}
 
 			dc_write_mpd(cmddata, audio_data_conf, video_data_conf, presentation_duration, availability_start_time, time_shift, main_seg_time.segnum+1, cmddata->ast_offset);
+
+			dc_stage_stats_report(th_param->stage_stats);
 		}
 		
 		if (cmddata->no_mpd_rewrite) return 0;
@@ -400,6 +480,8 @@ static u32 mpd_thread(void *params)
 
 	dc_write_mpd(cmddata, audio_data_conf, video_data_conf, presentation_duration, availability_start_time, 0, main_seg_time.segnum+1, 0);
 
+	dc_stage_stats_report(th_param->stage_stats);
+
 	return 0;
 }
 
@@ -626,11 +708,21 @@ u32 video_scaler_thread(void *params)
 		return 0;
 
 	while (1) {
+		u64 wait_time = video_scaled_data->consumer.wait_time;
+		u64 start = gf_sys_clock_high_res();
 		ret = dc_video_scaler_scale(video_input_data, video_scaled_data);
 		if (ret == -2) {
 			GF_LOG(GF_LOG_INFO, GF_LOG_DASH, ("Video scaler has no more frame to read.\n"));
 			break;
 		}
+		//the encoders still hold the output node (live modes): back off instead of spinning, the decoder drops frames meanwhile
+		if (ret == -3) {
+			dc_stage_stats_update(&thread_params->stats, 0, 0, 0, NULL, &video_scaled_data->producer);
+			gf_sleep(1);
+			continue;
+		}
+		if (ret < 0) continue;
+		dc_stage_stats_update(&thread_params->stats, 1, gf_sys_clock_high_res() - start - (video_scaled_data->consumer.wait_time - wait_time), 0, &video_scaled_data->consumer, &video_scaled_data->producer);
 	}
 
 	dc_video_scaler_end_signal(video_scaled_data);
@@ -745,7 +837,12 @@ u32 video_encoder_thread(void *params)
 				ret = 1;
 				loss_state = 0;
 			} else {
+				u64 wait_time = out_file.consumer.wait_time;
+				u64 start = gf_sys_clock_high_res();
 				ret = dc_video_encoder_encode(&out_file, video_scaled_data);
+				if (ret >= 0) {
+					dc_stage_stats_update(&thread_params->stats, 1, gf_sys_clock_high_res() - start - (out_file.consumer.wait_time - wait_time), 0, &out_file.consumer, NULL);
+				}
 			}
 
 			if (ret == -2) {
@@ -761,6 +858,7 @@ u32 video_encoder_thread(void *params)
 
 			if (ret > 0) {
 				int r;
+				u64 start;
 
 				/*resync at first RAP: flush current broken segment and restart next one on rap*/
 				if ((loss_state==1) && out_file.codec_ctx->coded_frame->key_frame) {
@@ -768,7 +866,9 @@ u32 video_encoder_thread(void *params)
 					break;
 				}
 
+				start = gf_sys_clock_high_res();
 				r = dc_video_muxer_write(&out_file, frame_nb, in_data->insert_utc ? GF_TRUE : GF_FALSE);
+				dc_stage_stats_update(&thread_params->stats, 0, 0, gf_sys_clock_high_res() - start, NULL, NULL);
 				if (r < 0) {
 					quit = 1;
 					in_data->exit_signal = 1;
@@ -965,7 +1065,9 @@ u32 audio_encoder_thread(void *params)
 				break;
 			}
 
+			//the input frame is now obtained: only encoding is accounted as processing time
 			while (1) {
+				u64 start = gf_sys_clock_high_res();
 				ret = dc_audio_encoder_encode(&audio_output_file, audio_input_data);
 				if (ret == 1) {
 					break;
@@ -975,8 +1077,11 @@ u32 audio_encoder_thread(void *params)
 					quit = 1;
 					break;
 				}
+				dc_stage_stats_update(&thread_params->stats, 1, gf_sys_clock_high_res() - start, 0, &audio_output_file.consumer, NULL);
 
+				start = gf_sys_clock_high_res();
 				ret = dc_audio_muxer_write(&audio_output_file, frame_nb, in_data->insert_utc);
+				dc_stage_stats_update(&thread_params->stats, 0, 0, gf_sys_clock_high_res() - start, NULL, NULL);
 				if (ret == -1) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("An error occured while writing audio frame.\n"));
 					quit = 1;
@@ -1111,6 +1216,11 @@ int dc_run_controler(CmdData *in_data)
 	MessageQueue delete_seg_mq;
 	MessageQueue send_frag_mq;
 
+	GF_List *stage_stats = gf_list_new();
+	char stage_name[GF_MAX_PATH];
+	u32 nb_pipeline_threads = 0;
+	GF_SystemRTInfo rti;
+
 	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DashCast] Controler init at UTC "LLU"\n", gf_net_get_utc() ));
 	dc_register_libav();
 
@@ -1174,11 +1284,18 @@ int dc_run_controler(CmdData *in_data)
 
 		for (i=0; i<video_scaled_data_list.size; i++) {
 			vscaler_th_params[i].thread = gf_th_new("video_scaler_thread");
+			snprintf(stage_name, sizeof(stage_name), "video scaler %dx%d", video_scaled_data_list.video_scaled_data[i]->out_width, video_scaled_data_list.video_scaled_data[i]->out_height);
+			dc_stage_stats_init(&vscaler_th_params[i].stats, stage_stats, stage_name);
 		}
 
 		/* Initialize video encoder threads */
-		for (i=0; i<gf_list_count(in_data->video_lst); i++)
+		for (i=0; i<gf_list_count(in_data->video_lst); i++) {
+			VideoDataConf *video_data_conf = (VideoDataConf*)gf_list_get(in_data->video_lst, i);
 			vencoder_th_params[i].thread = gf_th_new("video_encoder_thread");
+			snprintf(stage_name, sizeof(stage_name), "video encoder %s", video_data_conf->filename);
+			dc_stage_stats_init(&vencoder_th_params[i].stats, stage_stats, stage_name);
+		}
+		nb_pipeline_threads += 1 + video_scaled_data_list.size + gf_list_count(in_data->video_lst);
 	}
 
 	/* When video and audio share the same source, open it once. This allow to read from unicast streams */
@@ -1207,8 +1324,20 @@ int dc_run_controler(CmdData *in_data)
 		adecoder_th_params.thread = gf_th_new("audio_decoder_thread");
 
 		/* Initialize audio encoder threads */
-		for (i = 0; i < gf_list_count(in_data->audio_lst); i++)
-			aencoder_th_params[i].thread = gf_th_new("video_encoder_thread");
+		for (i = 0; i < gf_list_count(in_data->audio_lst); i++) {
+			AudioDataConf *audio_data_conf = (AudioDataConf*)gf_list_get(in_data->audio_lst, i);
+			aencoder_th_params[i].thread = gf_th_new("audio_encoder_thread");
+			snprintf(stage_name, sizeof(stage_name), "audio encoder %s", audio_data_conf->filename);
+			dc_stage_stats_init(&aencoder_th_params[i].stats, stage_stats, stage_name);
+		}
+		nb_pipeline_threads += 1 + gf_list_count(in_data->audio_lst);
+	}
+
+	/* every rung has its own encoder thread: warn when the ladder oversubscribes the machine */
+	memset(&rti, 0, sizeof(GF_SystemRTInfo));
+	gf_sys_get_rti(0, &rti, GF_RTI_SYSTEM_MEMORY_ONLY);
+	if (rti.nb_cores && (nb_pipeline_threads > rti.nb_cores)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH, ("[DashCast] %d decoder/scaler/encoder threads for %d cores - real-time encoding may not be sustained\n", nb_pipeline_threads, rti.nb_cores));
 	}
 
 	/******** Keyboard controler Thread ********/
@@ -1248,6 +1377,7 @@ int dc_run_controler(CmdData *in_data)
 	/* Create MPD generator thread */
 	mpd_th_params.in_data = in_data;
 	mpd_th_params.mq = &mq;
+	mpd_th_params.stage_stats = stage_stats;
 	if (gf_th_run(mpd_th_params.thread, mpd_thread, (void *)&mpd_th_params) != GF_OK) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("Error while doing pthread_create for mpd_thread.\n"));
 	}
@@ -1438,6 +1568,9 @@ exit:
 		dc_video_scaler_list_destroy(&video_scaled_data_list);
 	}
 
+	/* stage statistics are stored in the thread parameters */
+	dc_stage_stats_del(stage_stats);
+
 	if (vscaler_th_params)
 		gf_free(vscaler_th_params);
 
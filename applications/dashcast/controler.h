@@ -39,6 +39,28 @@
 #include "message_queue.h"
 
 
+/* Statistics of one stage (scaler, encoder+muxer) of the pipeline of a representation */
+typedef struct {
+	/* name of the stage, as printed in the logs */
+	char name[GF_MAX_PATH];
+	/* protects the counters, updated by the stage thread and read by the MPD thread */
+	GF_Mutex *mx;
+	/* number of frames processed by the stage */
+	u32 nb_frames;
+	/* time spent processing frames (without waiting for input), in microseconds */
+	u64 process_time;
+	/* time spent writing frames to the muxer, in microseconds */
+	u64 mux_time;
+	/* number of times and time spent waiting for input, in microseconds, and accumulated input queue depth (from the input Consumer) */
+	u32 nb_waits;
+	u64 wait_time, total_depth;
+	/* number of times the output queue was found full (from the output Producer) */
+	u32 nb_drops;
+	/* values at the last report, used to print per-interval statistics */
+	u32 last_nb_frames, last_nb_waits, last_nb_drops;
+	u64 last_process_time, last_mux_time, last_wait_time, last_total_depth;
+} StageStats;
+
 /* General thread parameters */
 typedef struct {
 	/* command data */
@@ -47,6 +69,8 @@ typedef struct {
 	GF_Thread *thread;
 
 	MessageQueue *mq;
+	/* statistics of all pipeline stages, reported by the MPD thread */
+	GF_List *stage_stats;
 } ThreadParam;
 
 /* Video thread parameters */
@@ -67,6 +91,8 @@ typedef struct {
 	MessageQueue *mq;
 	MessageQueue *delete_seg_mq;
 	MessageQueue *send_seg_mq;
+
+	StageStats stats;
 } VideoThreadParam;
 
 /* Audio thread parameters */
@@ -85,6 +111,8 @@ typedef struct {
 	MessageQueue *mq;
 	MessageQueue *delete_seg_mq;
 	MessageQueue *send_seg_mq;
+
+	StageStats stats;
 } AudioThreadParam;
 
 /*
@@ -178,7 +178,7 @@ int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *vid
 	ret = dc_producer_lock(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 	//not ready
 	if (ret<0) {
-		return -1;
+		return -3;
 	}
 	dc_producer_unlock_previous(&video_scaled_data->producer, &video_scaled_data->circular_buf);
 
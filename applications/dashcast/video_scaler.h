@@ -144,7 +144,8 @@ int dc_video_scaler_data_set_prop(VideoInputData *video_input_data, VideoScaledD
  * @param video_input_data [in] contains input frames
  * @param video_scaled_data [out] contains scaled frames
  *
- * return 0 on success, -2 if the node is the last node to scale
+ * return 0 on success, -2 if the node is the last node to scale, -3 if no output node
+ * is available (live modes, the encoders still hold it), -1 on error
  */
 int dc_video_scaler_scale(VideoInputData *video_input_data, VideoScaledData *video_scaled_data);
 
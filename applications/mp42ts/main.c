@@ -426,6 +426,12 @@ static GF_Err mp4_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
 			}
 		}
 #endif
+		/*hand the sample buffer over to the muxer rather than having it copied*/
+		if (pck.data && (pck.data == priv->sample->data)) {
+			pck.flags |= GF_ESI_DATA_TRANSFER;
+			priv->sample->data = NULL;
+			priv->sample->dataLength = 0;
+		}
 		ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] Track %d: sample %d CTS %d\n", priv->track, priv->sample_number+1, pck.cts));
 
@@ -30,6 +30,7 @@
 #include <gpac/scene_manager.h>
 #include <gpac/network.h>
 #include <gpac/base_coding.h>
+#include <gpac/thread.h>
 
 #if !defined(GPAC_DISABLE_VRML) && !defined(GPAC_DISABLE_X3D) && !defined(GPAC_DISABLE_SVG)
 #include <gpac/scenegraph.h>
@@ -242,7 +243,9 @@ static void set_chapter_track(GF_ISOFile *file, u32 track, u32 chapter_ref_trak)
 	}
 }
 
-GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample)
+/*imports @inName in @dest. When @in_worker is set, the import is done in a private movie by a worker thread and options
+depending on the tracks already present in the final destination are not supported*/
+static GF_Err import_file_internal(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample, Bool in_worker)
 {
 	u32 track_id, i, j, timescale, track, stype, profile, level, new_timescale, rescale, svc_mode, txt_flags, split_tile_mode, temporal_mode;
 	s32 par_d, par_n, prog_id, delay;
@@ -342,7 +345,13 @@ GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double forc
 		else if (!strnicmp(ext+1, "disable", 7)) disable = 1;
 		else if (!strnicmp(ext+1, "group=", 6)) {
 			group = atoi(ext+7);
-			if (!group) group = gf_isom_get_next_alternate_group_id(dest);
+			if (!group) {
+				if (in_worker) {
+					e = GF_NOT_SUPPORTED;
+					goto exit;
+				}
+				group = gf_isom_get_next_alternate_group_id(dest);
+			}
 		}
 		else if (!strnicmp(ext+1, "fps=", 4)) {
 			if (!strcmp(ext+5, "auto")) force_fps = GF_IMPORT_AUTO_FPS;
@@ -538,6 +547,12 @@ GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double forc
 	ext = strrchr(szName, '#');
 	if (ext) ext[0] = 0;
 
+	/*layout and chapters are computed from the tracks of the destination*/
+	if (in_worker && (track_layout || is_chap)) {
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+
 	keep_handler = gf_isom_probe_file(szName);
 
 	import.in_name = szName;
@@ -545,6 +560,21 @@ GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double forc
 	e = gf_media_import(&import);
 	if (e) goto exit;
 
+	/*text tracks are sized after the visual tracks of the destination*/
+	if (in_worker) {
+		if (!import.nb_tracks) e = GF_NOT_SUPPORTED;
+		for (i=0; i<import.nb_tracks; i++) {
+			switch (import.tk_info[i].type) {
+			case GF_ISOM_MEDIA_TEXT:
+			case GF_ISOM_MEDIA_SUBT:
+			case GF_ISOM_MEDIA_MPEG_SUBT:
+				e = GF_NOT_SUPPORTED;
+				break;
+			}
+		}
+		if (e) goto exit;
+	}
+
 	if (ext) {
 		ext++;
 		if (!strnicmp(ext, "audio", 5)) do_audio = 1;
@@ -970,6 +1000,101 @@ exit:
 	return e;
 }
 
+typedef struct
+{
+	char *in_name;
+	u32 import_flags, frames_per_sample;
+	Double force_fps;
+	u32 timescale;
+	char *tmpdir;
+	/*private movie the worker imports in*/
+	GF_ISOFile *movie;
+	GF_Err e;
+	GF_Thread *th;
+} ImportJob;
+
+static GF_List *import_jobs = NULL;
+
+static u32 import_job_run(void *par)
+{
+	ImportJob *job = (ImportJob *)par;
+	job->movie = gf_isom_open("_mp4box_import", GF_ISOM_WRITE_EDIT, job->tmpdir);
+	if (!job->movie) {
+		job->e = GF_IO_ERR;
+		return 1;
+	}
+	if (job->timescale) gf_isom_set_timescale(job->movie, job->timescale);
+	job->e = import_file_internal(job->movie, job->in_name, job->import_flags, job->force_fps, job->frames_per_sample, GF_TRUE);
+	return 0;
+}
+
+static void import_job_del(ImportJob *job)
+{
+	gf_th_stop(job->th);
+	gf_th_del(job->th);
+	if (job->movie) gf_isom_delete(job->movie);
+	gf_free(job);
+}
+
+GF_Err import_file_start(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample, char *tmpdir)
+{
+	GF_Err e;
+	ImportJob *job;
+	GF_SAFEALLOC(job, ImportJob);
+	if (!job) return GF_OUT_OF_MEM;
+	job->in_name = inName;
+	job->import_flags = import_flags;
+	job->force_fps = force_fps;
+	job->frames_per_sample = frames_per_sample;
+	job->timescale = gf_isom_get_timescale(dest);
+	job->tmpdir = tmpdir;
+	job->th = gf_th_new("MP4Box Import");
+	if (!import_jobs) import_jobs = gf_list_new();
+	gf_list_add(import_jobs, job);
+	e = gf_th_run(job->th, import_job_run, job);
+	if (e) {
+		gf_list_del_item(import_jobs, job);
+		import_job_del(job);
+	}
+	return e;
+}
+
+void import_file_stop_all()
+{
+	while (gf_list_count(import_jobs)) {
+		ImportJob *job = (ImportJob *)gf_list_pop_back(import_jobs);
+		import_job_del(job);
+	}
+	gf_list_del(import_jobs);
+	import_jobs = NULL;
+}
+
+GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample)
+{
+	u32 i;
+	GF_Err e;
+	ImportJob *job = NULL;
+
+	for (i=0; i<gf_list_count(import_jobs); i++) {
+		job = (ImportJob *)gf_list_get(import_jobs, i);
+		if ((job->in_name == inName) && (job->import_flags == import_flags)) break;
+		job = NULL;
+	}
+	if (job) {
+		gf_list_rem(import_jobs, i);
+		/*wait for the worker and move its tracks in the destination - if the worker failed or its tracks cannot be moved, import again*/
+		gf_th_stop(job->th);
+		e = job->e;
+		if (!e) e = gf_isom_move_tracks(dest, job->movie);
+		import_job_del(job);
+		if (!e) return GF_OK;
+		if (e != GF_NOT_SUPPORTED) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[MP4Box] Parallel import of %s failed (%s), importing sequentially\n", inName, gf_error_to_string(e)));
+		}
+	}
+	return import_file_internal(dest, inName, import_flags, force_fps, frames_per_sample, GF_FALSE);
+}
+
 typedef struct
 {
 	u32 tk;
@@ -994,7 +1119,7 @@ GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb,
 	Double max_dur, cur_file_time;
 	Bool do_add, all_duplicatable, size_exceeded, chunk_extraction, rap_split, split_until_end;
 	GF_ISOFile *dest;
-	GF_ISOSample *samp;
+	GF_ISOSample *samp, *copy_samp;
 	GF_Err e;
 	TKInfo *tks, *tki;
 	char *ext, szName[1000], szFile[1000];
@@ -1209,6 +1334,8 @@ GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb,
 	nb_done = 0;
 	nb_tk_done = 0;
 	cur_file = 0;
+	/*samples are fetched in the same buffer, grown as needed*/
+	copy_samp = gf_isom_sample_new();
 	while (nb_tk_done<nb_tk) {
 		Double last_rap_sample_time, max_dts, file_split_dur;
 		Bool is_last_rap;
@@ -1301,7 +1428,12 @@ GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb,
 					if (!tki->can_duplicate && (t>max_dts)) max_dts = t;
 					tki->first_sample_done = 1;
 				}
-				samp = gf_isom_get_sample(mp4, tki->tk, tki->last_sample+1, &di);
+				e = gf_isom_get_sample_into(mp4, tki->tk, tki->last_sample+1, copy_samp, &di);
+				if (e) {
+					fprintf(stderr, "Error cloning track %d sample %d\n", tki->tk, tki->last_sample+1);
+					goto err_exit;
+				}
+				samp = copy_samp;
 				samp->DTS -= tki->firstDTS;
 
 				nb_add += 1;
@@ -1331,7 +1463,6 @@ GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb,
 				}
 				tki->lastDTS = samp->DTS;
 				e = gf_isom_add_sample(dest, tki->dst_tk, di, samp);
-				gf_isom_sample_del(&samp);
 
 				if (!e) {
 					e = gf_isom_copy_sample_info(dest, tki->dst_tk, mp4, tki->tk, tki->last_sample+1);
@@ -1613,6 +1744,7 @@ GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb,
 	gf_set_progress("Splitting", nb_samp, nb_samp);
 err_exit:
 	if (dest) gf_isom_delete(dest);
+	gf_isom_sample_del(&copy_samp);
 	gf_free(tks);
 	return e;
 }
@@ -2047,7 +2179,19 @@ GF_Err cat_isomedia_file(GF_ISOFile *dest, char *fileName, u32 import_flags, Dou
 		last_DTS = 0;
 		count = gf_isom_get_sample_count(orig, i+1);
 		for (j=0; j<count; j++) {
-			u32 di;
+			u32 di, nb_run;
+
+			/*move runs of contiguous samples at once when possible*/
+			e = gf_isom_copy_sample_run(dest, dst_tk, orig, i+1, j+1, count-j, ts_scale, new_track ? 0 : insert_dts, &nb_run);
+			if (!e) {
+				last_DTS = gf_isom_get_sample_dts(orig, i+1, j+nb_run);
+				j += nb_run-1;
+				nb_done += nb_run;
+				gf_set_progress("Appending", nb_done, nb_samp);
+				continue;
+			}
+			if (e != GF_NOT_SUPPORTED) goto err_exit;
+
 			samp = gf_isom_get_sample(orig, i+1, j+1, &di);
 			last_DTS = samp->DTS;
 			samp->DTS =  (u64) (ts_scale * samp->DTS + (new_track ? 0 : insert_dts));
@@ -72,6 +72,10 @@ void convert_file_info(char *inName, u32 trackID);
 #ifndef GPAC_DISABLE_ISOM_WRITE
 
 GF_Err import_file(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample);
+#ifndef GPAC_DISABLE_MEDIA_IMPORT
+GF_Err import_file_start(GF_ISOFile *dest, char *inName, u32 import_flags, Double force_fps, u32 frames_per_sample, char *tmpdir);
+void import_file_stop_all();
+#endif
 GF_Err split_isomedia_file(GF_ISOFile *mp4, Double split_dur, u64 split_size_kb, char *inName, Double interleaving_time, Double chunk_start, Bool adjust_split_end, char *outName, const char *tmpdir);
 GF_Err cat_isomedia_file(GF_ISOFile *mp4, char *fileName, u32 import_flags, Double force_fps, u32 frames_per_sample, char *tmp_dir, Bool force_cat, Bool align_timelines, Bool allow_add_in_command);
 
@@ -557,6 +561,7 @@ void PrintImportUsage()
 	        " \":txtflags-=flags\"   removes display flags (hexa number) from text track\n"
 	        "\n"
 	        " -add file              add file tracks to (new) output file\n"
+	        " -parallel              imports all '-add' files in parallel threads before merging them in the output file\n"
 	        " -cat file              concatenates file samples to (new) output file\n"
 	        "                         * Note: creates tracks if needed\n"
 	        "                         * Note: aligns initial timestamp of the file to be concatenated.\n"
@@ -689,6 +694,7 @@ void PrintHintUsage()
 	        " -add-sdp string      adds sdp string to (hint) track (\"-add-sdp tkID:string\")\n"
 	        "                       or movie. This will take care of SDP lines ordering\n"
 	        " -unhint              removes all hinting information.\n"
+	        " -parallel            hints all tracks in parallel threads\n"
 	        "\n");
 }
 void PrintExtractUsage()
@@ -908,7 +914,7 @@ void SetupClockReferences(GF_ISOFile *file)
 /*base RTP payload type used (you can specify your own types if needed)*/
 #define BASE_PAYT		96
 
-GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group)
+GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32 base_flags, Bool copy_data, Bool interleave, Bool regular_iod, Bool single_group, Bool parallel, char *tmp_dir)
 {
 	GF_ESD *esd;
 	GF_InitialObjectDescriptor *iod;
@@ -917,6 +923,7 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 	GF_Err e;
 	char szPayload[30];
 	GF_RTPHinter *hinter;
+	GF_List *hinters;
 	Bool copy, has_iod, single_av;
 	u8 init_payt = BASE_PAYT;
 	u32 mtype;
@@ -950,6 +957,9 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		}
 	}
 
+	/*when hinting in parallel, hinters are processed once all tracks are setup*/
+	hinters = parallel ? gf_list_new() : NULL;
+
 	nb_done = 0;
 	for (i=0; i<gf_isom_get_track_count(file); i++) {
 		sl_mode = base_flags;
@@ -1026,7 +1036,10 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		if (!hinter) {
 			if (e) {
 				fprintf(stderr, "Cannot create hinter (%s)\n", gf_error_to_string(e));
-				if (!nb_done) return e;
+				if (!nb_done) {
+					if (hinters) gf_list_del(hinters);
+					return e;
+				}
 			}
 			continue;
 		}
@@ -1044,6 +1057,12 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 				if (flags & GP_RTP_PCK_FORCE_MPEG4) fprintf(stderr, "\tMPEG4 transport forced\n");
 				if (flags & GP_RTP_PCK_USE_MULTI) fprintf(stderr, "\tRTP aggregation enabled\n");
 		*/
+		if (hinters) {
+			gf_list_add(hinters, hinter);
+			init_payt++;
+			nb_done ++;
+			continue;
+		}
 		e = gf_hinter_track_process(hinter);
 
 		if (!e) e = gf_hinter_track_finalize(hinter, has_iod);
@@ -1057,6 +1076,21 @@ GF_Err HintFile(GF_ISOFile *file, u32 MTUSize, u32 max_ptime, u32 rtp_rate, u32
 		nb_done ++;
 	}
 
+	if (hinters) {
+		e = gf_hinter_track_process_parallel(hinters, tmp_dir);
+		while (gf_list_count(hinters)) {
+			hinter = (GF_RTPHinter *)gf_list_get(hinters, 0);
+			gf_list_rem(hinters, 0);
+			if (!e) e = gf_hinter_track_finalize(hinter, has_iod);
+			gf_hinter_track_del(hinter);
+		}
+		gf_list_del(hinters);
+		if (e) {
+			fprintf(stderr, "Error while hinting (%s)\n", gf_error_to_string(e));
+			return e;
+		}
+	}
+
 	if (has_iod) {
 		iod_mode = GF_SDP_IOD_ISMA;
 		if (regular_iod) iod_mode = GF_SDP_IOD_REGULAR;
@@ -1837,7 +1871,7 @@ GF_DashDynamicMode dash_mode=GF_DASH_STATIC;
 GF_SceneDumpFormat dump_mode;
 #endif
 Double mpd_live_duration = 0;
-Bool HintIt, needSave, FullInter, Frag, HintInter, dump_rtp, regular_iod, remove_sys_tracks, remove_hint, force_new, remove_root_od;
+Bool HintIt, needSave, FullInter, Frag, HintInter, dump_rtp, regular_iod, remove_sys_tracks, remove_hint, force_new, remove_root_od, parallel_import;
 Bool print_sdp, print_info, open_edit, dump_cr, force_ocr, encode, do_log, do_flat, dump_srt, dump_ttxt, dump_timestamps, do_saf, dump_m2ts, dump_cart, do_hash, verbose, force_cat, align_cat, pack_wgt, single_group, clean_groups, dash_live, no_fragments_defaults, single_traf_per_moof;
 char *inName, *outName, *arg, *mediaSource, *tmpdir, *input_ctx, *output_ctx, *drm_file, *avi2raw, *cprt, *chap_file, *pes_dump, *itunes_tags, *pack_file, *raw_cat, *seg_name, *dash_ctx_file;
 u32 track_dump_type, dump_isom;
@@ -2134,6 +2168,7 @@ u32 mp4box_parse_args_continue(int argc, char **argv, u32 *current_index)
 			open_edit = GF_TRUE;
 			do_flat = GF_TRUE;
 		}
+		else if (!stricmp(arg, "-parallel")) parallel_import = GF_TRUE;
 		else if (!stricmp(arg, "-keep-utc")) keep_utc = GF_TRUE;
 		else if (!stricmp(arg, "-new")) force_new = GF_TRUE;
 		else if (!stricmp(arg, "-timescale")) {
@@ -3416,7 +3451,7 @@ int mp4boxMain(int argc, char **argv)
 	dump_mode = GF_SM_DUMP_NONE;
 #endif
 	Frag = force_ocr = remove_sys_tracks = agg_samples = remove_hint = keep_sys_tracks = remove_root_od = single_group = clean_groups = GF_FALSE;
-	conv_type = HintIt = needSave = print_sdp = print_info = regular_iod = dump_std = open_edit = dump_rtp = dump_cr = dump_srt = dump_ttxt = force_new = dump_timestamps = dump_m2ts = dump_cart = import_subtitle = force_cat = pack_wgt = dash_live = GF_FALSE;
+	conv_type = HintIt = needSave = print_sdp = print_info = regular_iod = dump_std = open_edit = dump_rtp = dump_cr = dump_srt = dump_ttxt = force_new = parallel_import = dump_timestamps = dump_m2ts = dump_cart = import_subtitle = force_cat = pack_wgt = dash_live = GF_FALSE;
 	no_fragments_defaults = GF_FALSE;
 	single_traf_per_moof = GF_FALSE,
 	dump_isom = 0;
@@ -3749,6 +3784,16 @@ int mp4boxMain(int argc, char **argv)
 			return mp4box_cleanup(1);
 		}
 
+		/*start importing all sources in private movies, tracks are moved to the destination in order by import_file*/
+		if (parallel_import && (nb_add>1) && (open_mode != GF_ISOM_OPEN_WRITE)) {
+			for (i=0; i<(u32) argc; i++) {
+				if (!strcmp(argv[i], "-add")) {
+					import_file_start(file, argv[i+1], import_flags, import_fps, agg_samples, tmpdir);
+					i++;
+				}
+			}
+		}
+
 		for (i=0; i<(u32) argc; i++) {
 			if (!strcmp(argv[i], "-add")) {
 				char *src = argv[i+1];
@@ -3776,6 +3821,7 @@ int mp4boxMain(int argc, char **argv)
 					}
 					if (e) {
 						fprintf(stderr, "Error importing %s: %s\n", argv[i+1], gf_error_to_string(e));
+						import_file_stop_all();
 						gf_isom_delete(file);
 						return mp4box_cleanup(1);
 					}
@@ -3784,6 +3830,8 @@ int mp4boxMain(int argc, char **argv)
 			}
 		}
 
+		import_file_stop_all();
+
 		/*unless explicitly asked, remove all systems tracks*/
 		if (!keep_sys_tracks) remove_systems_tracks(file);
 		needSave = GF_TRUE;
@@ -5040,7 +5088,7 @@ int mp4boxMain(int argc, char **argv)
 		if (force_ocr) SetupClockReferences(file);
 		fprintf(stderr, "Hinting file with Path-MTU %d Bytes\n", MTUSize);
 		MTUSize -= 12;
-		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group);
+		e = HintFile(file, MTUSize, max_ptime, rtp_rate, hint_flags, HintCopy, HintInter, regular_iod, single_group, parallel_import, tmpdir);
 		if (e) goto err_exit;
 		needSave = GF_TRUE;
 		if (print_sdp) dump_isom_sdp(file, dump_std ? NULL : (outName ? outName : outfile), outName ? GF_TRUE : GF_FALSE);
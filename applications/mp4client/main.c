@@ -35,6 +35,7 @@
 #include <gpac/avparse.h>
 #include <gpac/network.h>
 #include <gpac/utf.h>
+#include <gpac/trace.h>
 #include <time.h>
 
 /*ISO 639 languages*/
@@ -193,6 +194,7 @@ void PrintUsage()
 	        "\t                  \"section:*=null\" removes the section\n"
 	        "\t-conf option:   Same as -opt but does not start player.\n"
 	        "\t-log-file file: sets output log file. Also works with -lf\n"
+	        "\t-trace file:    records trace events (demuxers, decoders, compositor, DASH) and dumps them on exit to file in Chrome trace JSON format\n"
 	        "\t-logs log_args: sets log tools and levels, formatted as a ':'-separated list of toolX[:toolZ]@levelX\n"
 	        "\t                 levelX can be one of:\n"
 	        "\t        \"quiet\"      : skip logs\n"
@@ -1202,7 +1204,7 @@ int mp4client_main(int argc, char **argv)
 #endif
 	Double fps = GF_IMPORT_DEFAULT_FPS;
 	Bool fill_ar, visible, do_uncache;
-	char *url_arg, *out_arg, *the_cfg, *rti_file, *views, *default_com;
+	char *url_arg, *out_arg, *the_cfg, *rti_file, *views, *default_com, *trace_file;
 	FILE *logfile = NULL;
 	Float scale = 1;
 #ifndef WIN32
@@ -1216,7 +1218,7 @@ int mp4client_main(int argc, char **argv)
 
 	dump_mode = DUMP_NONE;
 	fill_ar = visible = do_uncache = GF_FALSE;
-	url_arg = out_arg = the_cfg = rti_file = views = default_com = NULL;
+	url_arg = out_arg = the_cfg = rti_file = views = default_com = trace_file = NULL;
 	nb_times = 0;
 	times[0] = 0;
 
@@ -1299,6 +1301,10 @@ int mp4client_main(int argc, char **argv)
 			}
 			logs_set = GF_TRUE;
 			i++;
+		} else if (!strcmp(arg, "-trace")) {
+			trace_file = argv[i+1];
+			gf_trace_start(0);
+			i++;
 		} else if (!strcmp(arg, "-log-clock") || !strcmp(arg, "-lc")) {
 			log_time_start = 1;
 		} else if (!strcmp(arg, "-log-utc") || !strcmp(arg, "-lu")) {
@@ -2315,6 +2321,11 @@ force_input:
 	gf_term_del(term);
 	fprintf(stderr, "done (in %d ms) - ran for %d ms\n", gf_sys_clock() - i, gf_sys_clock());
 
+	if (trace_file) {
+		gf_trace_stop();
+		if (gf_trace_dump(trace_file) != GF_OK) fprintf(stderr, "Cannot write trace file %s\n", trace_file);
+	}
+
 	fprintf(stderr, "GPAC cleanup ...\n");
 	gf_modules_del(user.modules);
 
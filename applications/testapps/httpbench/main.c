@@ -0,0 +1,238 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - download manager benchmark
+ *
+ *  Runs a local HTTP/1.1 keep-alive server and fetches many small resources
+ *  from it, with and without connection reuse in the download manager.
+ *
+ */
+
+#include <gpac/download.h>
+#include <gpac/network.h>
+#include <gpac/thread.h>
+#include <gpac/list.h>
+
+#define HTTPBENCH_MAX_REQ	4096
+
+typedef struct
+{
+	GF_Socket *listen_sk;
+	GF_List *connections;
+	u32 body_size;
+	char *reply;
+	u32 reply_size;
+	volatile Bool run;
+	volatile u32 nb_accepted;
+	volatile u32 nb_requests;
+} HTTPServer;
+
+typedef struct
+{
+	HTTPServer *server;
+	GF_Socket *sk;
+	GF_Thread *th;
+} HTTPConnection;
+
+static u32 http_connection_run(void *par)
+{
+	char req[HTTPBENCH_MAX_REQ];
+	u32 req_size = 0;
+	HTTPConnection *conn = (HTTPConnection *)par;
+	HTTPServer *server = conn->server;
+
+	while (server->run) {
+		u32 read;
+		char *end;
+		GF_Err e = gf_sk_receive(conn->sk, req + req_size, HTTPBENCH_MAX_REQ - 1 - req_size, 0, &read);
+		if (e == GF_IP_NETWORK_EMPTY) continue;
+		if (e) break;
+		req_size += read;
+		req[req_size] = 0;
+		/*requests carry no body, answer each complete header block*/
+		while ((end = strstr(req, "\r\n\r\n")) != NULL) {
+			u32 consumed = (u32) (end + 4 - req);
+			/*reply is sent in a single call to avoid Nagle/delayed ACK stalls*/
+			if (gf_sk_send(conn->sk, server->reply, server->reply_size)) break;
+			server->nb_requests++;
+			memmove(req, req + consumed, req_size - consumed + 1);
+			req_size -= consumed;
+		}
+		if (end) break;
+		if (req_size == HTTPBENCH_MAX_REQ - 1) break;
+	}
+	gf_sk_del(conn->sk);
+	conn->sk = NULL;
+	return 0;
+}
+
+static u32 http_server_run(void *par)
+{
+	HTTPServer *server = (HTTPServer *)par;
+	while (server->run) {
+		HTTPConnection *conn;
+		GF_Socket *sk;
+		GF_Err e = gf_sk_accept(server->listen_sk, &sk);
+		if (e) continue;
+
+		GF_SAFEALLOC(conn, HTTPConnection);
+		conn->server = server;
+		conn->sk = sk;
+		conn->th = gf_th_new("HTTPBenchConnection");
+		server->nb_accepted++;
+		gf_list_add(server->connections, conn);
+		gf_th_run(conn->th, http_connection_run, conn);
+	}
+	return 0;
+}
+
+static void http_server_reset(HTTPServer *server)
+{
+	while (gf_list_count(server->connections)) {
+		HTTPConnection *conn = (HTTPConnection *)gf_list_pop_back(server->connections);
+		gf_th_stop(conn->th);
+		gf_th_del(conn->th);
+		gf_free(conn);
+	}
+	server->nb_accepted = 0;
+	server->nb_requests = 0;
+}
+
+static void on_http_event(void *cbk, GF_NETIO_Parameter *param)
+{
+}
+
+static GF_Err run_bench(GF_DownloadManager *dm, const char *url, u32 nb_requests, u32 *nb_ok)
+{
+	u32 i;
+	*nb_ok = 0;
+	for (i=0; i<nb_requests; i++) {
+		GF_Err e;
+		GF_DownloadSession *sess = gf_dm_sess_new(dm, url, GF_NETIO_SESSION_NOT_THREADED | GF_NETIO_SESSION_NOT_CACHED, on_http_event, NULL, &e);
+		if (!sess) return e;
+		e = gf_dm_sess_process(sess);
+		if ((e==GF_OK) || (e==GF_EOS)) (*nb_ok)++;
+		gf_dm_sess_del(sess);
+	}
+	return GF_OK;
+}
+
+static void print_usage()
+{
+	fprintf(stderr, "Usage: httpbench [options]\n"
+	        "\t-n N:       number of requests per run (default 500)\n"
+	        "\t-size S:    size in bytes of the served resource (default 10000)\n"
+	        "\t-port P:    local server port (default 8432)\n"
+	        "\t-url URL:   benchmark an external server instead of the local one\n"
+	        "\t-logs LOGS: set log tools and levels\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	HTTPServer server;
+	GF_Thread *server_th = NULL;
+	GF_Config *cfg;
+	GF_DownloadManager *dm;
+	char szURL[GF_MAX_PATH];
+	const char *ext_url = NULL;
+	u32 i, nb_requests = 500;
+	u16 port = 8432;
+	u32 run;
+	u64 durations[2];
+	u32 connections[2];
+
+	memset(&server, 0, sizeof(HTTPServer));
+	server.body_size = 10000;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-n") && (i+1<(u32) argc)) nb_requests = atoi(argv[++i]);
+		else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) server.body_size = atoi(argv[++i]);
+		else if (!strcmp(arg, "-port") && (i+1<(u32) argc)) port = atoi(argv[++i]);
+		else if (!strcmp(arg, "-url") && (i+1<(u32) argc)) ext_url = argv[++i];
+		else if (!strcmp(arg, "-logs") && (i+1<(u32) argc)) {
+			if (gf_log_set_tools_levels(argv[++i]) != GF_OK) return 1;
+		} else {
+			print_usage();
+			return 1;
+		}
+	}
+
+	gf_sys_init(GF_FALSE);
+
+	if (!ext_url) {
+		GF_Err e;
+		char szHdr[200];
+		sprintf(szHdr, "HTTP/1.1 200 OK\r\nContent-Type: application/octet-stream\r\nContent-Length: %d\r\nConnection: keep-alive\r\n\r\n", server.body_size);
+		server.reply_size = (u32) strlen(szHdr) + server.body_size;
+		server.reply = (char *)gf_malloc(sizeof(char) * server.reply_size);
+		memcpy(server.reply, szHdr, strlen(szHdr));
+		memset(server.reply + strlen(szHdr), 'G', server.body_size);
+		server.connections = gf_list_new();
+		server.listen_sk = gf_sk_new(GF_SOCK_TYPE_TCP);
+		e = gf_sk_bind(server.listen_sk, NULL, port, NULL, 0, GF_SOCK_REUSE_PORT);
+		if (!e) e = gf_sk_listen(server.listen_sk, 16);
+		if (e) {
+			fprintf(stderr, "Cannot start local HTTP server on port %d: %s\n", port, gf_error_to_string(e));
+			gf_sk_del(server.listen_sk);
+			gf_free(server.reply);
+			gf_list_del(server.connections);
+			gf_sys_close();
+			return 1;
+		}
+		sprintf(szURL, "http://127.0.0.1:%d/bench.bin", port);
+		ext_url = szURL;
+	}
+
+	/*run 0: no connection reuse, run 1: default pooling*/
+	for (run=0; run<2; run++) {
+		u32 nb_ok;
+		u64 start;
+
+		if (server.listen_sk) {
+			server.run = GF_TRUE;
+			server_th = gf_th_new("HTTPBenchServer");
+			gf_th_run(server_th, http_server_run, &server);
+		}
+
+		cfg = gf_cfg_new(NULL, NULL);
+		gf_cfg_set_key(cfg, "Downloader", "MaxIdleConnectionsPerHost", run ? "4" : "0");
+		dm = gf_dm_new(cfg);
+
+		start = gf_sys_clock_high_res();
+		run_bench(dm, ext_url, nb_requests, &nb_ok);
+		durations[run] = gf_sys_clock_high_res() - start;
+		connections[run] = server.nb_accepted;
+
+		gf_dm_del(dm);
+		gf_cfg_del(cfg);
+
+		fprintf(stderr, "%s: %d/%d requests OK in "LLU" ms - %.2f req/s", run ? "Connection reuse   " : "No connection reuse",
+		        nb_ok, nb_requests, durations[run]/1000, durations[run] ? (Double) nb_requests * 1000000 / durations[run] : 0);
+		if (server.listen_sk) fprintf(stderr, " - %d TCP connections", connections[run]);
+		fprintf(stderr, "\n");
+
+		if (server_th) {
+			server.run = GF_FALSE;
+			gf_th_stop(server_th);
+			gf_th_del(server_th);
+			server_th = NULL;
+			http_server_reset(&server);
+		}
+	}
+	if (durations[1])
+		fprintf(stderr, "Speedup: %.2fx\n", (Double) durations[0] / durations[1]);
+
+	if (server.listen_sk) {
+		gf_sk_del(server.listen_sk);
+		gf_list_del(server.connections);
+		gf_free(server.reply);
+	}
+	gf_sys_close();
+	return 0;
+}
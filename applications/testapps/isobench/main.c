@@ -0,0 +1,194 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - ISO file writing benchmark
+ *
+ *  Imports a large number of audio frames in an ISO file, one sample at a time
+ *  with gf_isom_add_sample and by batches with gf_isom_add_samples_batch.
+ *
+ */
+
+#include <gpac/isomedia.h>
+
+#define ISOBENCH_FRAME_DUR	1536
+#define ISOBENCH_SAMPLERATE	48000
+
+typedef struct
+{
+	u32 nb_frames, batch_size, avg_size;
+	char *payload;
+	u32 payload_size;
+	u32 rand_state;
+} ISOBench;
+
+/*deterministic frame sizes between avg_size/2 and 3*avg_size/2*/
+static u32 isobench_frame_size(ISOBench *bench)
+{
+	bench->rand_state = bench->rand_state * 1103515245 + 12345;
+	return bench->avg_size/2 + (bench->rand_state>>8) % (bench->avg_size+1);
+}
+
+static GF_ISOFile *isobench_open(const char *out, u32 *track)
+{
+	GF_Err e;
+	u32 di;
+	GF_AC3Config cfg;
+	GF_ISOFile *file = gf_isom_open(out, GF_ISOM_OPEN_WRITE, NULL);
+	if (!file) return NULL;
+	/*no dates, so that the outputs of both runs can be compared*/
+	gf_isom_no_version_date_info(file, GF_TRUE);
+
+	*track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_AUDIO, ISOBENCH_SAMPLERATE);
+	gf_isom_set_track_enabled(file, *track, 1);
+	/*frames are dummy AC-3 frames, 2 channels at 48 kHz*/
+	memset(&cfg, 0, sizeof(GF_AC3Config));
+	cfg.nb_streams = 1;
+	cfg.streams[0].acmod = 2;
+	e = gf_isom_ac3_config_new(file, *track, &cfg, NULL, NULL, &di);
+	if (!e) e = gf_isom_set_audio_info(file, *track, di, ISOBENCH_SAMPLERATE, 2, 16);
+	if (e) {
+		gf_isom_delete(file);
+		return NULL;
+	}
+	return file;
+}
+
+/*imports the frames, writes the file and gets its SHA-1 - the output is deleted*/
+static GF_Err isobench_run(ISOBench *bench, const char *out, Bool use_batch, u64 *duration, u8 digest[GF_SHA1_DIGEST_SIZE])
+{
+	GF_Err e = GF_OK;
+	u32 i, track, pos, nb_batch;
+	u64 start;
+	GF_ISOSample samp;
+	GF_ISOBatchSample *batch;
+	GF_ISOFile *file = isobench_open(out, &track);
+	if (!file) return GF_IO_ERR;
+
+	batch = (GF_ISOBatchSample *)gf_malloc(sizeof(GF_ISOBatchSample) * bench->batch_size);
+	memset(&samp, 0, sizeof(GF_ISOSample));
+	bench->rand_state = 1;
+	pos = 0;
+	nb_batch = 0;
+
+	start = gf_sys_clock_high_res();
+	for (i=0; i<bench->nb_frames; i++) {
+		u32 size = isobench_frame_size(bench);
+		/*frames are taken back to back from the payload buffer, as a parser would do*/
+		if (pos + size > bench->payload_size) pos = 0;
+
+		if (!use_batch) {
+			samp.data = bench->payload + pos;
+			samp.dataLength = size;
+			samp.DTS = (u64) i * ISOBENCH_FRAME_DUR;
+			samp.IsRAP = RAP;
+			e = gf_isom_add_sample(file, track, 1, &samp);
+			if (e) break;
+		} else {
+			/*flush the batch when the payload wraps, so that frames of a batch are contiguous*/
+			if (nb_batch && ((nb_batch == bench->batch_size) || !pos)) {
+				e = gf_isom_add_samples_batch(file, track, 1, batch, nb_batch);
+				if (e) break;
+				nb_batch = 0;
+			}
+			memset(&batch[nb_batch], 0, sizeof(GF_ISOBatchSample));
+			batch[nb_batch].data = bench->payload + pos;
+			batch[nb_batch].dataLength = size;
+			batch[nb_batch].DTS = (u64) i * ISOBENCH_FRAME_DUR;
+			batch[nb_batch].IsRAP = RAP;
+			nb_batch++;
+		}
+		pos += size;
+	}
+	if (!e && nb_batch)
+		e = gf_isom_add_samples_batch(file, track, 1, batch, nb_batch);
+	*duration = gf_sys_clock_high_res() - start;
+
+	if (!e && (gf_isom_get_sample_count(file, track) != bench->nb_frames)) e = GF_CORRUPTED_DATA;
+	gf_free(batch);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	e = gf_isom_close(file);
+	if (!e && gf_sha1_file(out, digest)) e = GF_IO_ERR;
+	gf_delete_file(out);
+	return e;
+}
+
+static void isobench_progress_quiet(const void *cbck, const char *title, u64 done, u64 total) { }
+
+static void print_usage()
+{
+	fprintf(stderr, "Usage: isobench [options]\n"
+	        "\t-n N:    number of audio frames to import (default 10000000)\n"
+	        "\t-b B:    number of frames per batch (default 1024)\n"
+	        "\t-size S: average frame size in bytes (default 32)\n"
+	        "\t-out F:  temporary output file (default isobench.mp4)\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	ISOBench bench;
+	const char *out = "isobench.mp4";
+	u32 i, run;
+	u64 durations[2];
+	u8 digests[2][GF_SHA1_DIGEST_SIZE];
+	int ret = 0;
+
+	memset(&bench, 0, sizeof(ISOBench));
+	bench.nb_frames = 10000000;
+	bench.batch_size = 1024;
+	bench.avg_size = 32;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-n") && (i+1<(u32) argc)) bench.nb_frames = atoi(argv[++i]);
+		else if (!strcmp(arg, "-b") && (i+1<(u32) argc)) bench.batch_size = atoi(argv[++i]);
+		else if (!strcmp(arg, "-size") && (i+1<(u32) argc)) bench.avg_size = atoi(argv[++i]);
+		else if (!strcmp(arg, "-out") && (i+1<(u32) argc)) out = argv[++i];
+		else {
+			print_usage();
+			return 1;
+		}
+	}
+	if (!bench.batch_size || !bench.avg_size) {
+		print_usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_set_progress_callback(NULL, isobench_progress_quiet);
+
+	bench.payload_size = 1000 * bench.avg_size;
+	bench.payload = (char *)gf_malloc(sizeof(char) * bench.payload_size);
+	for (i=0; i<bench.payload_size; i++) bench.payload[i] = (char) i;
+
+	/*run 0: one sample at a time, run 1: batches*/
+	for (run=0; run<2; run++) {
+		GF_Err e = isobench_run(&bench, out, run ? GF_TRUE : GF_FALSE, &durations[run], digests[run]);
+		if (e) {
+			fprintf(stderr, "Error importing frames: %s\n", gf_error_to_string(e));
+			ret = 1;
+			break;
+		}
+		fprintf(stderr, "%s: %d frames in "LLU" ms - %.2f frames/s\n", run ? "gf_isom_add_samples_batch" : "gf_isom_add_sample       ",
+		        bench.nb_frames, durations[run]/1000, durations[run] ? (Double) bench.nb_frames * 1000000 / durations[run] : 0);
+	}
+	if (run==2) {
+		if (durations[1])
+			fprintf(stderr, "Speedup: %.2fx\n", (Double) (s64) durations[0] / (s64) durations[1]);
+		if (memcmp(digests[0], digests[1], GF_SHA1_DIGEST_SIZE)) {
+			fprintf(stderr, "Error: files written with gf_isom_add_sample and gf_isom_add_samples_batch differ\n");
+			ret = 2;
+		}
+	}
+
+	gf_free(bench.payload);
+	gf_sys_close();
+	return ret;
+}
@@ -0,0 +1,1066 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - core media operations benchmark
+ *
+ *  Runs fixed workloads on tests/media and on generated content, and reports
+ *  per-phase time, throughput and peak RSS as JSON:
+ *      mediabench -media tests/media -o bench.json
+ *  Results can be checked against a previous run, e.g. before merging:
+ *      mediabench -media tests/media -compare bench.json -tol 10
+ *  which exits with code 2 if any phase is slower than the baseline by more
+ *  than the given tolerance.
+ *
+ */
+
+#include <gpac/isomedia.h>
+#include <gpac/media_tools.h>
+#include <gpac/constants.h>
+#include <gpac/mpegts.h>
+#include <gpac/ismacryp.h>
+#include <gpac/scene_manager.h>
+#include <gpac/terminal.h>
+#include <gpac/user.h>
+#include <gpac/options.h>
+#include <gpac/version.h>
+
+#ifndef WIN32
+#include <sys/resource.h>
+#endif
+
+#define MBENCH_MAX_PHASES	16
+#define MBENCH_TS_DEMUX_LOOPS	20
+
+typedef struct
+{
+	const char *name;
+	/*unit of work: samples, files, packets, frames*/
+	const char *unit;
+	Bool skipped;
+	u32 nb_runs;
+	/*best and total run time in microseconds*/
+	u64 min_time, tot_time;
+	u64 nb_units, nb_bytes;
+	u64 peak_rss;
+} MBenchPhase;
+
+typedef struct
+{
+	const char *media_dir;
+	char tmp_dir[GF_MAX_PATH];
+	const char *phases;
+	u32 nb_runs, nb_synth_samples, nb_frames, nb_shapes;
+
+	char src_mp4[GF_MAX_PATH];
+	char synth_mp4[GF_MAX_PATH];
+	char src_ts[GF_MAX_PATH];
+	GF_List *bt_files;
+	GF_List *xmt_files;
+
+	MBenchPhase phase[MBENCH_MAX_PHASES];
+	u32 nb_phases;
+	MBenchPhase *cur;
+	u64 cur_start;
+} MBench;
+
+/*peak resident set size of the process in KB*/
+static u64 mbench_peak_rss()
+{
+#ifndef WIN32
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage)) return 0;
+#if defined(__APPLE__)
+	return (u64) usage.ru_maxrss / 1024;
+#else
+	return (u64) usage.ru_maxrss;
+#endif
+#else
+	/*no peak info, use current process memory*/
+	GF_SystemRTInfo rti;
+	if (!gf_sys_get_rti(0, &rti, GF_RTI_PROCESS_MEMORY)) return 0;
+	return rti.process_memory / 1024;
+#endif
+}
+
+static Bool mbench_phase_enabled(MBench *mb, const char *name)
+{
+	const char *pos;
+	u32 len = (u32) strlen(name);
+	if (!mb->phases) return GF_TRUE;
+	pos = mb->phases;
+	while ((pos = strstr(pos, name)) != NULL) {
+		if (((pos == mb->phases) || (pos[-1] == ',')) && (!pos[len] || (pos[len] == ','))) return GF_TRUE;
+		pos += len;
+	}
+	return GF_FALSE;
+}
+
+static MBenchPhase *mbench_phase_new(MBench *mb, const char *name, const char *unit)
+{
+	MBenchPhase *ph;
+	if (mb->nb_phases == MBENCH_MAX_PHASES) return NULL;
+	ph = &mb->phase[mb->nb_phases];
+	mb->nb_phases++;
+	memset(ph, 0, sizeof(MBenchPhase));
+	ph->name = name;
+	ph->unit = unit;
+	return ph;
+}
+
+static void mbench_run_start(MBench *mb, MBenchPhase *ph)
+{
+	mb->cur = ph;
+	mb->cur_start = gf_sys_clock_high_res();
+}
+
+static void mbench_run_end(MBench *mb)
+{
+	MBenchPhase *ph = mb->cur;
+	u64 dur = gf_sys_clock_high_res() - mb->cur_start;
+	if (!ph->nb_runs || (dur < ph->min_time)) ph->min_time = dur;
+	ph->tot_time += dur;
+	ph->nb_runs++;
+	ph->peak_rss = mbench_peak_rss();
+	mb->cur = NULL;
+}
+
+static void mbench_skip(MBenchPhase *ph, const char *reason)
+{
+	ph->skipped = GF_TRUE;
+	fprintf(stderr, "Phase %s skipped: %s\n", ph->name, reason);
+}
+
+static u64 mbench_file_size(const char *name)
+{
+	u64 size;
+	FILE *f = gf_fopen(name, "rb");
+	if (!f) return 0;
+	gf_fseek(f, 0, SEEK_END);
+	size = gf_ftell(f);
+	gf_fclose(f);
+	return size;
+}
+
+static void mbench_media_path(MBench *mb, char *path, const char *sub_path)
+{
+	sprintf(path, "%s%c%s", mb->media_dir, GF_PATH_SEPARATOR, sub_path);
+}
+
+static void mbench_tmp_path(MBench *mb, char *path, const char *name)
+{
+	sprintf(path, "%s%c%s", mb->tmp_dir, GF_PATH_SEPARATOR, name);
+}
+
+/*
+		ISO import, open and sample iteration
+*/
+
+static GF_Err mbench_import(const char *src, GF_ISOFile *dest, u32 *nb_samples)
+{
+	GF_Err e;
+	GF_MediaImporter import;
+	memset(&import, 0, sizeof(GF_MediaImporter));
+	import.in_name = (char *) src;
+	import.dest = dest;
+	e = gf_media_import(&import);
+	if (!e && nb_samples)
+		*nb_samples = gf_isom_get_sample_count(dest, gf_isom_get_track_by_id(dest, import.final_trackID));
+	return e;
+}
+
+static void mbench_import_phase(MBench *mb, const char *name, const char *sub_path, const char *dst)
+{
+	u32 run, nb_samples=0;
+	char src[GF_MAX_PATH];
+	MBenchPhase *ph = mbench_phase_new(mb, name, "samples");
+	if (!ph) return;
+
+	mbench_media_path(mb, src, sub_path);
+	if (!gf_file_exists(src)) {
+		mbench_skip(ph, "source media not found");
+		return;
+	}
+	for (run=0; run<mb->nb_runs; run++) {
+		GF_Err e;
+		GF_ISOFile *file = gf_isom_open(dst, GF_ISOM_WRITE_EDIT, mb->tmp_dir);
+		if (!file) {
+			mbench_skip(ph, "cannot create output file");
+			return;
+		}
+		mbench_run_start(mb, ph);
+		e = mbench_import(src, file, &nb_samples);
+		if (!e) e = gf_isom_close(file);
+		else gf_isom_delete(file);
+		mbench_run_end(mb);
+		if (e) {
+			mbench_skip(ph, gf_error_to_string(e));
+			return;
+		}
+	}
+	ph->nb_units = nb_samples;
+	ph->nb_bytes = mbench_file_size(src);
+}
+
+/*source file for all ISO based phases is AVC+AAC, as used by the tests*/
+static GF_Err mbench_make_source_file(MBench *mb)
+{
+	GF_Err e;
+	char path[GF_MAX_PATH];
+	GF_ISOFile *file = gf_isom_open(mb->src_mp4, GF_ISOM_WRITE_EDIT, mb->tmp_dir);
+	if (!file) return GF_IO_ERR;
+
+	mbench_media_path(mb, path, "auxiliary_files/enst_video.h264");
+	e = mbench_import(path, file, NULL);
+	if (!e) {
+		mbench_media_path(mb, path, "auxiliary_files/enst_audio.aac");
+		e = mbench_import(path, file, NULL);
+	}
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+/*generated file with a large number of small samples, some of them RAPs and with composition offsets,
+so that parsing is dominated by the sample tables rather than by the media*/
+static GF_Err mbench_make_synth_file(MBench *mb)
+{
+	GF_Err e;
+	u32 i, track, di, rand_state = 1;
+	char payload[1024];
+	GF_ISOSample samp;
+	GF_GenericSampleDescription udesc;
+	GF_ISOFile *file = gf_isom_open(mb->synth_mp4, GF_ISOM_OPEN_WRITE, mb->tmp_dir);
+	if (!file) return GF_IO_ERR;
+
+	track = gf_isom_new_track(file, 0, GF_ISOM_MEDIA_VISUAL, 90000);
+	gf_isom_set_track_enabled(file, track, 1);
+	memset(&udesc, 0, sizeof(GF_GenericSampleDescription));
+	udesc.codec_tag = GF_4CC('S', 'Y', 'N', 'T');
+	udesc.width = 320;
+	udesc.height = 240;
+	e = gf_isom_new_generic_sample_description(file, track, NULL, NULL, &udesc, &di);
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	for (i=0; i<sizeof(payload); i++) payload[i] = (char) i;
+
+	memset(&samp, 0, sizeof(GF_ISOSample));
+	for (i=0; i<mb->nb_synth_samples; i++) {
+		rand_state = rand_state * 1103515245 + 12345;
+		samp.data = payload;
+		samp.dataLength = 16 + (rand_state>>8) % (sizeof(payload) - 16);
+		samp.DTS = (u64) i * 3000;
+		samp.CTS_Offset = (i%3) ? 0 : 6000;
+		samp.IsRAP = (i%30) ? RAP_NO : RAP;
+		e = gf_isom_add_sample(file, track, di, &samp);
+		if (e) break;
+	}
+	if (e) {
+		gf_isom_delete(file);
+		return e;
+	}
+	return gf_isom_close(file);
+}
+
+static void mbench_isom_open_phase(MBench *mb)
+{
+	u32 run;
+	const char *files[2];
+	MBenchPhase *ph = mbench_phase_new(mb, "isom_open", "files");
+	if (!ph) return;
+	files[0] = mb->src_mp4;
+	files[1] = mb->synth_mp4;
+
+	for (run=0; run<mb->nb_runs; run++) {
+		u32 i;
+		mbench_run_start(mb, ph);
+		for (i=0; i<2; i++) {
+			GF_ISOFile *file;
+			if (!files[i][0]) continue;
+			file = gf_isom_open(files[i], GF_ISOM_OPEN_READ, NULL);
+			if (!file) continue;
+			gf_isom_close(file);
+			if (!run) {
+				ph->nb_units++;
+				ph->nb_bytes += mbench_file_size(files[i]);
+			}
+		}
+		mbench_run_end(mb);
+	}
+	if (!ph->nb_units) mbench_skip(ph, "no input file");
+}
+
+static void mbench_sample_iterate_phase(MBench *mb)
+{
+	u32 run;
+	const char *files[2];
+	MBenchPhase *ph = mbench_phase_new(mb, "sample_iterate", "samples");
+	if (!ph) return;
+	files[0] = mb->src_mp4;
+	files[1] = mb->synth_mp4;
+
+	for (run=0; run<mb->nb_runs; run++) {
+		u32 i;
+		GF_ISOFile *file[2];
+		/*parsing is accounted in isom_open, only time sample fetching*/
+		for (i=0; i<2; i++) {
+			file[i] = files[i][0] ? gf_isom_open(files[i], GF_ISOM_OPEN_READ, NULL) : NULL;
+		}
+		mbench_run_start(mb, ph);
+		for (i=0; i<2; i++) {
+			u32 j, nb_tracks;
+			if (!file[i]) continue;
+			nb_tracks = gf_isom_get_track_count(file[i]);
+			for (j=0; j<nb_tracks; j++) {
+				u32 k, di, nb_samples = gf_isom_get_sample_count(file[i], j+1);
+				for (k=0; k<nb_samples; k++) {
+					GF_ISOSample *samp = gf_isom_get_sample(file[i], j+1, k+1, &di);
+					if (!samp) break;
+					if (!run) {
+						ph->nb_units++;
+						ph->nb_bytes += samp->dataLength;
+					}
+					gf_isom_sample_del(&samp);
+				}
+			}
+		}
+		mbench_run_end(mb);
+		for (i=0; i<2; i++) {
+			if (file[i]) gf_isom_close(file[i]);
+		}
+	}
+	if (!ph->nb_units) mbench_skip(ph, "no input file");
+}
+
+/*
+		MPEG-2 TS mux and demux
+*/
+
+typedef struct
+{
+	GF_ISOFile *mp4;
+	u32 track, sample_number, sample_count;
+} MBenchTSInput;
+
+static GF_Err mbench_ts_input_ctrl(GF_ESInterface *ifce, u32 act_type, void *param)
+{
+	GF_ESIPacket pck;
+	GF_ISOSample *samp;
+	MBenchTSInput *in = (MBenchTSInput *)ifce->input_udta;
+	if (act_type != GF_ESI_INPUT_DATA_FLUSH) return GF_OK;
+	if (in->sample_number == in->sample_count) return GF_OK;
+
+	samp = gf_isom_get_sample(in->mp4, in->track, in->sample_number+1, NULL);
+	if (!samp) return GF_IO_ERR;
+
+	memset(&pck, 0, sizeof(GF_ESIPacket));
+	pck.flags = GF_ESI_DATA_AU_START | GF_ESI_DATA_AU_END | GF_ESI_DATA_HAS_CTS;
+	if (samp->IsRAP) pck.flags |= GF_ESI_DATA_AU_RAP;
+	pck.dts = samp->DTS;
+	pck.cts = samp->DTS + samp->CTS_Offset;
+	if (samp->CTS_Offset) pck.flags |= GF_ESI_DATA_HAS_DTS;
+	pck.data = samp->data;
+	pck.data_len = samp->dataLength;
+	pck.duration = gf_isom_get_sample_duration(in->mp4, in->track, in->sample_number+1);
+	ifce->output_ctrl(ifce, GF_ESI_OUTPUT_DATA_DISPATCH, &pck);
+	gf_isom_sample_del(&samp);
+
+	in->sample_number++;
+	if (in->sample_number == in->sample_count) ifce->caps |= GF_ESI_STREAM_IS_OVER;
+	return GF_OK;
+}
+
+static void mbench_ts_setup_input(GF_ESInterface *ifce, MBenchTSInput *in, GF_ISOFile *mp4, u32 track)
+{
+	GF_ESD *esd;
+	memset(ifce, 0, sizeof(GF_ESInterface));
+	memset(in, 0, sizeof(MBenchTSInput));
+	in->mp4 = mp4;
+	in->track = track;
+	in->sample_count = gf_isom_get_sample_count(mp4, track);
+
+	ifce->stream_id = gf_isom_get_track_id(mp4, track);
+	ifce->timescale = gf_isom_get_media_timescale(mp4, track);
+	ifce->duration = (Double) (s64) gf_isom_get_media_duration(mp4, track);
+	if (ifce->duration) {
+		ifce->bit_rate = (u32) (gf_isom_get_media_data_size(mp4, track) * 8 * ifce->timescale / gf_isom_get_media_duration(mp4, track));
+		ifce->duration /= ifce->timescale;
+	}
+	if (gf_isom_has_time_offset(mp4, track)) ifce->caps |= GF_ESI_SIGNAL_DTS;
+	esd = gf_media_map_esd(mp4, track);
+	if (esd) {
+		ifce->stream_type = esd->decoderConfig->streamType;
+		ifce->object_type_indication = esd->decoderConfig->objectTypeIndication;
+		switch (ifce->object_type_indication) {
+		case GPAC_OTI_VIDEO_AVC:
+		case GPAC_OTI_VIDEO_HEVC:
+			gf_isom_set_nalu_extract_mode(mp4, track, GF_ISOM_NALU_EXTRACT_INBAND_PS_FLAG | GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG);
+			break;
+		default:
+			if (esd->decoderConfig->decoderSpecificInfo && esd->decoderConfig->decoderSpecificInfo->dataLength) {
+				ifce->decoder_config_size = esd->decoderConfig->decoderSpecificInfo->dataLength;
+				ifce->decoder_config = (char *)gf_malloc(sizeof(char)*ifce->decoder_config_size);
+				memcpy(ifce->decoder_config, esd->decoderConfig->decoderSpecificInfo->data, ifce->decoder_config_size);
+			}
+			break;
+		}
+		gf_odf_desc_del((GF_Descriptor *)esd);
+	}
+	ifce->input_ctrl = mbench_ts_input_ctrl;
+	ifce->input_udta = in;
+}
+
+static GF_Err mbench_ts_mux(MBench *mb, u64 *nb_packets)
+{
+	u32 i, nb_tracks, status;
+	GF_ESInterface ifces[2];
+	MBenchTSInput inputs[2];
+	GF_M2TS_Mux *muxer;
+	GF_M2TS_Mux_Program *program;
+	FILE *out;
+	GF_ISOFile *mp4 = gf_isom_open(mb->src_mp4, GF_ISOM_OPEN_READ, NULL);
+	if (!mp4) return GF_IO_ERR;
+
+	out = gf_fopen(mb->src_ts, "wb");
+	if (!out) {
+		gf_isom_close(mp4);
+		return GF_IO_ERR;
+	}
+	/*VBR, not real-time, fixed initial PCR so that the output does not change between runs*/
+	muxer = gf_m2ts_mux_new(0, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, GF_FALSE);
+	gf_m2ts_mux_set_initial_pcr(muxer, 0);
+	program = gf_m2ts_mux_program_add(muxer, 1, 100, GF_M2TS_PSI_DEFAULT_REFRESH_RATE, 0, GF_FALSE);
+	nb_tracks = MIN(gf_isom_get_track_count(mp4), 2);
+	for (i=0; i<nb_tracks; i++) {
+		mbench_ts_setup_input(&ifces[i], &inputs[i], mp4, i+1);
+		gf_m2ts_program_stream_add(program, &ifces[i], 101+i, (i==0) ? GF_TRUE : GF_FALSE, GF_FALSE);
+	}
+	gf_m2ts_mux_update_config(muxer, GF_TRUE);
+
+	*nb_packets = 0;
+	while (1) {
+		const char *ts_pck;
+		u32 usec_till_next;
+		while ((ts_pck = gf_m2ts_mux_process(muxer, &status, &usec_till_next)) != NULL) {
+			gf_fwrite(ts_pck, 1, 188, out);
+			(*nb_packets)++;
+		}
+		if (status != GF_M2TS_STATE_DATA) break;
+	}
+	gf_m2ts_mux_del(muxer);
+	for (i=0; i<nb_tracks; i++) {
+		if (ifces[i].decoder_config) gf_free(ifces[i].decoder_config);
+		if (ifces[i].sl_config) gf_odf_desc_del((GF_Descriptor *) ifces[i].sl_config);
+	}
+	gf_fclose(out);
+	gf_isom_close(mp4);
+	return GF_OK;
+}
+
+static void mbench_ts_mux_phase(MBench *mb)
+{
+	u32 run;
+	u64 nb_packets = 0;
+	MBenchPhase *ph = mbench_phase_new(mb, "ts_mux", "packets");
+	if (!ph) return;
+	if (!mb->src_mp4[0]) {
+		mbench_skip(ph, "no input file");
+		return;
+	}
+	for (run=0; run<mb->nb_runs; run++) {
+		GF_Err e;
+		mbench_run_start(mb, ph);
+		e = mbench_ts_mux(mb, &nb_packets);
+		mbench_run_end(mb);
+		if (e) {
+			mbench_skip(ph, gf_error_to_string(e));
+			return;
+		}
+	}
+	ph->nb_units = nb_packets;
+	ph->nb_bytes = nb_packets * 188;
+}
+
+static void mbench_on_m2ts_event(GF_M2TS_Demuxer *ts, u32 evt_type, void *par)
+{
+	u32 i, count;
+	GF_M2TS_Program *prog;
+	switch (evt_type) {
+	case GF_M2TS_EVT_PMT_FOUND:
+		prog = (GF_M2TS_Program *)par;
+		count = gf_list_count(prog->streams);
+		for (i=0; i<count; i++) {
+			GF_M2TS_ES *es = (GF_M2TS_ES *)gf_list_get(prog->streams, i);
+			if (es->flags & GF_M2TS_ES_IS_PES)
+				gf_m2ts_set_pes_framing((GF_M2TS_PES *)es, GF_M2TS_PES_FRAMING_DEFAULT);
+		}
+		break;
+	case GF_M2TS_EVT_PES_PCK:
+		(*(u64 *)ts->user)++;
+		break;
+	}
+}
+
+static void mbench_ts_demux_phase(MBench *mb)
+{
+	u32 run;
+	u64 nb_pck = 0;
+	char *data;
+	u32 size;
+	MBenchPhase *ph = mbench_phase_new(mb, "ts_demux", "frames");
+	if (!ph) return;
+
+	size = (u32) mbench_file_size(mb->src_ts);
+	if (!size) {
+		mbench_skip(ph, "no input file");
+		return;
+	}
+	/*load the file in memory to time the demuxer only*/
+	data = (char *)gf_malloc(sizeof(char) * size);
+	{
+		FILE *f = gf_fopen(mb->src_ts, "rb");
+		size = (u32) fread(data, 1, size, f);
+		gf_fclose(f);
+	}
+	for (run=0; run<mb->nb_runs; run++) {
+		u32 loop;
+		nb_pck = 0;
+		mbench_run_start(mb, ph);
+		/*the test file is small, demux it several times to get stable timings*/
+		for (loop=0; loop<MBENCH_TS_DEMUX_LOOPS; loop++) {
+			u32 pos;
+			GF_M2TS_Demuxer *ts = gf_m2ts_demux_new();
+			ts->on_event = mbench_on_m2ts_event;
+			ts->user = &nb_pck;
+			/*feed in chunks of 100 packets, as a file or network reader would do*/
+			for (pos=0; pos<size; pos+=18800) {
+				gf_m2ts_process_data(ts, data+pos, MIN(18800, size-pos));
+			}
+			gf_m2ts_demux_del(ts);
+		}
+		mbench_run_end(mb);
+	}
+	gf_free(data);
+	ph->nb_units = nb_pck;
+	ph->nb_bytes = (u64) size * MBENCH_TS_DEMUX_LOOPS;
+}
+
+/*
+		DASH segmentation and CENC encryption
+*/
+
+static void mbench_dash_phase(MBench *mb)
+{
+	u32 run;
+	char mpd[GF_MAX_PATH];
+	MBenchPhase *ph = mbench_phase_new(mb, "dash_segment", "samples");
+	if (!ph) return;
+	if (!mb->src_mp4[0]) {
+		mbench_skip(ph, "no input file");
+		return;
+	}
+	mbench_tmp_path(mb, mpd, "dash.mpd");
+
+	for (run=0; run<mb->nb_runs; run++) {
+		GF_Err e;
+		GF_DashSegmenterInput input;
+		GF_DASHSegmenter *dasher = gf_dasher_new(mpd, GF_DASH_PROFILE_LIVE, mb->tmp_dir, 1000, NULL);
+		if (!dasher) {
+			mbench_skip(ph, "cannot create DASH segmenter");
+			return;
+		}
+		memset(&input, 0, sizeof(GF_DashSegmenterInput));
+		input.file_name = mb->src_mp4;
+		input.representationID = "1";
+
+		mbench_run_start(mb, ph);
+		e = gf_dasher_set_durations(dasher, 1.0, GF_FALSE, 0);
+		if (!e) e = gf_dasher_add_input(dasher, &input);
+		if (!e) e = gf_dasher_process(dasher, 0);
+		mbench_run_end(mb);
+		gf_dasher_del(dasher);
+		if (e) {
+			mbench_skip(ph, gf_error_to_string(e));
+			return;
+		}
+	}
+	{
+		u32 i;
+		GF_ISOFile *mp4 = gf_isom_open(mb->src_mp4, GF_ISOM_OPEN_READ, NULL);
+		for (i=0; mp4 && (i<gf_isom_get_track_count(mp4)); i++) {
+			ph->nb_units += gf_isom_get_sample_count(mp4, i+1);
+			ph->nb_bytes += gf_isom_get_media_data_size(mp4, i+1);
+		}
+		if (mp4) gf_isom_close(mp4);
+	}
+}
+
+static void mbench_cenc_phase(MBench *mb)
+{
+#if !defined(GPAC_DISABLE_MCRYPT) && !defined(GPAC_DISABLE_ISOM_WRITE)
+	u32 run, i, nb_tracks;
+	char drm[GF_MAX_PATH], out[GF_MAX_PATH];
+	FILE *f;
+	GF_ISOFile *mp4;
+	MBenchPhase *ph = mbench_phase_new(mb, "cenc_encrypt", "samples");
+	if (!ph) return;
+	if (!mb->src_mp4[0]) {
+		mbench_skip(ph, "no input file");
+		return;
+	}
+	mbench_tmp_path(mb, drm, "drm_ctr.xml");
+	mbench_tmp_path(mb, out, "cenc.mp4");
+
+	mp4 = gf_isom_open(mb->src_mp4, GF_ISOM_OPEN_READ, NULL);
+	if (!mp4) {
+		mbench_skip(ph, "cannot open input file");
+		return;
+	}
+	/*AES-CTR on all tracks, same key*/
+	f = gf_fopen(drm, "wt");
+	fprintf(f, "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>\n<GPACDRM type=\"CENC AES-CTR\">\n");
+	nb_tracks = gf_isom_get_track_count(mp4);
+	for (i=0; i<nb_tracks; i++) {
+		fprintf(f, "<CrypTrack trackID=\"%d\" IsEncrypted=\"1\" IV_size=\"8\" first_IV=\"0x0a610676cb88f302\" saiSavedBox=\"senc\">\n"
+		        "<key KID=\"0x279926496a7f5d25da69f2b3b2799a7f\" value=\"0x5544694d47473326622665665a396b36\"/>\n</CrypTrack>\n", gf_isom_get_track_id(mp4, i+1));
+		ph->nb_units += gf_isom_get_sample_count(mp4, i+1);
+		ph->nb_bytes += gf_isom_get_media_data_size(mp4, i+1);
+	}
+	fprintf(f, "</GPACDRM>\n");
+	gf_fclose(f);
+	gf_isom_close(mp4);
+
+	for (run=0; run<mb->nb_runs; run++) {
+		GF_Err e;
+		mp4 = gf_isom_open(mb->src_mp4, GF_ISOM_OPEN_EDIT, mb->tmp_dir);
+		if (!mp4) {
+			mbench_skip(ph, "cannot open input file");
+			return;
+		}
+		mbench_run_start(mb, ph);
+		e = gf_isom_set_final_name(mp4, out);
+		if (!e) e = gf_crypt_file(mp4, drm);
+		if (!e) e = gf_isom_close(mp4);
+		else gf_isom_delete(mp4);
+		mbench_run_end(mb);
+		if (e) {
+			mbench_skip(ph, gf_error_to_string(e));
+			return;
+		}
+	}
+#endif
+}
+
+/*
+		Scene loading and rendering
+*/
+
+static Bool mbench_enum_scene(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info)
+{
+	gf_list_add((GF_List *)cbck, gf_strdup(item_path));
+	return GF_FALSE;
+}
+
+static GF_Err mbench_load_scene(const char *file, GF_SceneManager **out_ctx)
+{
+	GF_Err e;
+	GF_SceneLoader load;
+	GF_SceneGraph *sg = gf_sg_new();
+	GF_SceneManager *ctx = gf_sm_new(sg);
+
+	memset(&load, 0, sizeof(GF_SceneLoader));
+	load.fileName = file;
+	load.ctx = ctx;
+	e = gf_sm_load_init(&load);
+	if (!e) e = gf_sm_load_run(&load);
+	gf_sm_load_done(&load);
+	if (!e && out_ctx) {
+		*out_ctx = ctx;
+		return GF_OK;
+	}
+	gf_sm_del(ctx);
+	gf_sg_del(sg);
+	return e;
+}
+
+static void mbench_scene_load_phase(MBench *mb, const char *name, GF_List *files)
+{
+	u32 run, i, count = gf_list_count(files);
+	MBenchPhase *ph = mbench_phase_new(mb, name, "files");
+	if (!ph) return;
+	if (!count) {
+		mbench_skip(ph, "no scene found");
+		return;
+	}
+	for (run=0; run<mb->nb_runs; run++) {
+		mbench_run_start(mb, ph);
+		for (i=0; i<count; i++) {
+			const char *file = (const char *)gf_list_get(files, i);
+			GF_Err e = mbench_load_scene(file, NULL);
+			if (!run && !e) {
+				ph->nb_units++;
+				ph->nb_bytes += mbench_file_size(file);
+			}
+		}
+		mbench_run_end(mb);
+	}
+}
+
+/*converts the BT scenes to XMT-A, so that the XMT loader works on the same content*/
+static void mbench_make_xmt_files(MBench *mb)
+{
+	u32 i, count = gf_list_count(mb->bt_files);
+	for (i=0; i<count; i++) {
+		char rad[GF_MAX_PATH], name[20];
+		GF_SceneManager *ctx = NULL;
+		GF_SceneGraph *sg;
+		if (mbench_load_scene((const char *)gf_list_get(mb->bt_files, i), &ctx) != GF_OK) continue;
+		sprintf(name, "scene_%d", i);
+		mbench_tmp_path(mb, rad, name);
+		sg = ctx->scene_graph;
+		if (gf_sm_dump(ctx, rad, GF_FALSE, GF_SM_DUMP_XMTA) == GF_OK) {
+			strcat(rad, ".xmt");
+			gf_list_add(mb->xmt_files, gf_strdup(rad));
+		}
+		gf_sm_del(ctx);
+		gf_sg_del(sg);
+	}
+}
+
+/*animated 2D scene, shapes are rotated at each frame so that the whole scene is redrawn*/
+static GF_Err mbench_make_render_scene(MBench *mb, const char *file)
+{
+	u32 i;
+	FILE *f = gf_fopen(file, "wt");
+	if (!f) return GF_IO_ERR;
+	fprintf(f, "OrderedGroup {\n children [\n  Background2D { backColor 0.2 0.2 0.2 }\n"
+	        "  DEF TS TimeSensor { cycleInterval 4 loop TRUE }\n"
+	        "  DEF RI ScalarInterpolator { key [0 1] keyValue [0 6.283] }\n"
+	        "  DEF ROT Transform2D {\n   children [\n");
+	for (i=0; i<mb->nb_shapes; i++) {
+		Float x = (Float) (i%20) * 30 - 285;
+		Float y = (Float) ((i/20)%15) * 30 - 210;
+		fprintf(f, "    Transform2D { translation %g %g rotationAngle %g children [ Shape {\n", x, y, (Float) i / 10);
+		switch (i%4) {
+		case 0:
+			fprintf(f, "     geometry Rectangle { size 24 16 }\n");
+			break;
+		case 1:
+			fprintf(f, "     geometry Circle { radius 12 }\n");
+			break;
+		case 2:
+			fprintf(f, "     geometry Ellipse { radius 14 8 }\n");
+			break;
+		default:
+			fprintf(f, "     geometry Curve2D { point Coordinate2D { point [-12 -12 -12 12 12 12 12 -12] } type [0 7 1] }\n");
+			break;
+		}
+		if (i%3) {
+			fprintf(f, "     appearance Appearance { material Material2D { emissiveColor %g %g %g filled TRUE transparency %g lineProps LineProperties { lineColor 1 1 1 width 2 } } }\n",
+			        (Float) (i%5) / 4, (Float) (i%7) / 6, (Float) (i%11) / 10, (i%5) ? 0.0 : 0.5);
+		} else {
+			fprintf(f, "     appearance Appearance { material Material2D { filled TRUE } texture LinearGradient { key [0 1] keyValue [1 0 0 0 0 1] } }\n");
+		}
+		fprintf(f, "    } ] }\n");
+	}
+	fprintf(f, "   ]\n  }\n ]\n}\n"
+	        "ROUTE TS.fraction_changed TO RI.set_fraction\n"
+	        "ROUTE RI.value_changed TO ROT.rotationAngle\n");
+	gf_fclose(f);
+	return GF_OK;
+}
+
+static Bool mbench_event_proc(void *ptr, GF_Event *evt)
+{
+	return GF_FALSE;
+}
+
+static void mbench_render_phase(MBench *mb)
+{
+	u32 run;
+	char scene[GF_MAX_PATH];
+	GF_User user;
+	GF_Config *cfg;
+	MBenchPhase *ph = mbench_phase_new(mb, "render", "frames");
+	if (!ph) return;
+
+	mbench_tmp_path(mb, scene, "render.bt");
+	if (mbench_make_render_scene(mb, scene) != GF_OK) {
+		mbench_skip(ph, "cannot create scene");
+		return;
+	}
+	cfg = gf_cfg_init(NULL, NULL);
+	if (!cfg) {
+		mbench_skip(ph, "no GPAC configuration file");
+		return;
+	}
+	/*software rasterizer, no display, whole scene drawn at each frame*/
+	gf_cfg_discard_changes(cfg);
+	gf_cfg_set_key(cfg, "Video", "DriverName", "Raw Video Output");
+	gf_cfg_set_key(cfg, "RAWVideo", "RawOutput", "null");
+	gf_cfg_set_key(cfg, "Compositor", "OpenGLMode", "disable");
+	gf_cfg_set_key(cfg, "Compositor", "StressMode", "yes");
+	gf_cfg_set_key(cfg, "Compositor", "DefaultWidth", "640");
+	gf_cfg_set_key(cfg, "Compositor", "DefaultHeight", "480");
+
+	memset(&user, 0, sizeof(GF_User));
+	user.config = cfg;
+	user.modules = gf_modules_new(NULL, cfg);
+	user.EventProc = mbench_event_proc;
+	user.opaque = &user;
+	user.init_flags = GF_TERM_NO_AUDIO | GF_TERM_INIT_HIDE | GF_TERM_NO_DECODER_THREAD | GF_TERM_NO_COMPOSITOR_THREAD | GF_TERM_NO_REGULATION;
+	if (!user.modules || !gf_modules_get_count(user.modules)) {
+		mbench_skip(ph, "no modules found");
+	} else {
+		for (run=0; run<mb->nb_runs; run++) {
+			u32 nb_frames = 0, start_frames;
+			u64 start;
+			GF_Terminal *term = gf_term_new(&user);
+			if (!term) {
+				mbench_skip(ph, "cannot create terminal");
+				break;
+			}
+			gf_term_connect(term, scene);
+			/*wait for the first frame, so that scene loading is not accounted*/
+			start = gf_sys_clock_high_res();
+			while (!nb_frames && (gf_sys_clock_high_res() - start < 10000000)) {
+				gf_term_process_step(term);
+				gf_term_get_simulation_frame_rate(term, &nb_frames);
+			}
+			if (!nb_frames) {
+				gf_term_disconnect(term);
+				gf_term_del(term);
+				mbench_skip(ph, "scene not rendered");
+				break;
+			}
+			start_frames = nb_frames;
+			mbench_run_start(mb, ph);
+			while (nb_frames - start_frames < mb->nb_frames) {
+				gf_term_process_step(term);
+				gf_term_get_simulation_frame_rate(term, &nb_frames);
+			}
+			mbench_run_end(mb);
+			gf_term_disconnect(term);
+			gf_term_del(term);
+		}
+		ph->nb_units = mb->nb_frames;
+		ph->nb_bytes = (u64) mb->nb_frames * 640 * 480 * 4;
+	}
+	if (user.modules) gf_modules_del(user.modules);
+	gf_cfg_del(cfg);
+}
+
+/*
+		Report and baseline comparison
+*/
+
+static Double mbench_ms(u64 us)
+{
+	return (Double) (s64) us / 1000;
+}
+
+static void mbench_report(MBench *mb, FILE *out)
+{
+	u32 i;
+	fprintf(out, "{\n\"version\": \"%s\",\n\"runs\": %d,\n\"peak_rss_kb\": "LLU",\n\"phases\": [\n", GPAC_FULL_VERSION, mb->nb_runs, mbench_peak_rss());
+	for (i=0; i<mb->nb_phases; i++) {
+		MBenchPhase *ph = &mb->phase[i];
+		Double sec = (Double) (s64) ph->min_time / 1000000;
+		/*one phase per line, see mbench_compare*/
+		fprintf(out, "{\"name\": \"%s\", \"status\": \"%s\"", ph->name, ph->skipped ? "skipped" : "ok");
+		if (!ph->skipped && ph->nb_runs) {
+			fprintf(out, ", \"time_ms\": %.3f, \"mean_ms\": %.3f, \"unit\": \"%s\", \"units\": "LLU", \"bytes\": "LLU", \"units_per_sec\": %.2f, \"mbytes_per_sec\": %.3f, \"peak_rss_kb\": "LLU,
+			        mbench_ms(ph->min_time), mbench_ms(ph->tot_time) / ph->nb_runs, ph->unit, ph->nb_units, ph->nb_bytes,
+			        sec ? (Double) (s64) ph->nb_units / sec : 0, sec ? (Double) (s64) ph->nb_bytes / sec / 1000000 : 0, ph->peak_rss);
+		}
+		fprintf(out, "}%s\n", (i+1<mb->nb_phases) ? "," : "");
+	}
+	fprintf(out, "]\n}\n");
+}
+
+/*returns the number of phases slower than the baseline by more than tolerance percent, or -1 if the baseline cannot be read*/
+static s32 mbench_compare(MBench *mb, const char *baseline, Double tolerance)
+{
+	char line[2048];
+	s32 nb_regressions = 0;
+	FILE *f = gf_fopen(baseline, "rt");
+	if (!f) {
+		fprintf(stderr, "Cannot open baseline file %s\n", baseline);
+		return -1;
+	}
+	fprintf(stderr, "%-16s %12s %12s %9s\n", "phase", "baseline ms", "current ms", "delta");
+	while (fgets(line, sizeof(line), f)) {
+		u32 i;
+		char *name, *sep, *time;
+		Double base_ms, cur_ms, delta;
+		name = strstr(line, "\"name\": \"");
+		time = strstr(line, "\"time_ms\": ");
+		if (!name || !time) continue;
+		name += 9;
+		sep = strchr(name, '"');
+		if (!sep) continue;
+		sep[0] = 0;
+		if (sscanf(time + 11, "%lf", &base_ms) != 1) continue;
+
+		for (i=0; i<mb->nb_phases; i++) {
+			if (!strcmp(mb->phase[i].name, name)) break;
+		}
+		if ((i==mb->nb_phases) || mb->phase[i].skipped || !mb->phase[i].nb_runs) {
+			fprintf(stderr, "%-16s %12.3f %12s\n", name, base_ms, "n/a");
+			continue;
+		}
+		cur_ms = mbench_ms(mb->phase[i].min_time);
+		delta = base_ms ? 100 * (cur_ms - base_ms) / base_ms : 0;
+		fprintf(stderr, "%-16s %12.3f %12.3f %+8.1f%%%s\n", name, base_ms, cur_ms, delta, (delta > tolerance) ? " REGRESSION" : "");
+		if (delta > tolerance) nb_regressions++;
+	}
+	gf_fclose(f);
+	return nb_regressions;
+}
+
+static void mbench_on_progress(const void *cbck, const char *title, u64 done, u64 total)
+{
+}
+
+static void print_usage()
+{
+	fprintf(stderr, "Usage: mediabench [options]\n"
+	        "\t-media DIR:    GPAC test media directory (default tests/media)\n"
+	        "\t-tmp DIR:      directory for generated files (default mediabench_tmp), removed on exit\n"
+	        "\t-n N:          number of runs per phase, best run is reported (default 5)\n"
+	        "\t-phases LIST:  comma-separated list of phases to run (default all):\n"
+	        "\t               avc_import,hevc_import,isom_open,sample_iterate,ts_mux,ts_demux,\n"
+	        "\t               dash_segment,cenc_encrypt,bt_load,xmt_load,render\n"
+	        "\t-samples N:    number of samples of the generated ISO file (default 100000)\n"
+	        "\t-frames N:     number of rendered frames (default 100)\n"
+	        "\t-shapes N:     number of shapes in the rendered scene (default 300)\n"
+	        "\t-o FILE:       writes JSON report to FILE (default stdout)\n"
+	        "\t-compare FILE: compares results with the JSON report in FILE\n"
+	        "\t-tol PERCENT:  slow down tolerance for -compare (default 10)\n"
+	        "\t-logs LOGS:    sets log tools and levels (default all@quiet)\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	MBench mb;
+	u32 i;
+	s32 ret = 0;
+	Double tolerance = 10;
+	const char *out_file = NULL, *baseline = NULL, *tmp_dir = "mediabench_tmp", *logs = NULL;
+	char path[GF_MAX_PATH];
+	FILE *out;
+
+	memset(&mb, 0, sizeof(MBench));
+	mb.media_dir = "tests/media";
+	mb.nb_runs = 5;
+	mb.nb_synth_samples = 100000;
+	mb.nb_frames = 100;
+	mb.nb_shapes = 300;
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		if (!strcmp(arg, "-media") && (i+1<(u32) argc)) mb.media_dir = argv[++i];
+		else if (!strcmp(arg, "-tmp") && (i+1<(u32) argc)) tmp_dir = argv[++i];
+		else if (!strcmp(arg, "-n") && (i+1<(u32) argc)) mb.nb_runs = atoi(argv[++i]);
+		else if (!strcmp(arg, "-phases") && (i+1<(u32) argc)) mb.phases = argv[++i];
+		else if (!strcmp(arg, "-samples") && (i+1<(u32) argc)) mb.nb_synth_samples = atoi(argv[++i]);
+		else if (!strcmp(arg, "-frames") && (i+1<(u32) argc)) mb.nb_frames = atoi(argv[++i]);
+		else if (!strcmp(arg, "-shapes") && (i+1<(u32) argc)) mb.nb_shapes = atoi(argv[++i]);
+		else if (!strcmp(arg, "-o") && (i+1<(u32) argc)) out_file = argv[++i];
+		else if (!strcmp(arg, "-compare") && (i+1<(u32) argc)) baseline = argv[++i];
+		else if (!strcmp(arg, "-tol") && (i+1<(u32) argc)) tolerance = atof(argv[++i]);
+		else if (!strcmp(arg, "-logs") && (i+1<(u32) argc)) logs = argv[++i];
+		else {
+			print_usage();
+			return 1;
+		}
+	}
+	if (!mb.nb_runs) {
+		print_usage();
+		return 1;
+	}
+
+	gf_sys_init(GF_MemTrackerNone);
+	gf_set_progress_callback(NULL, mbench_on_progress);
+	if (logs) gf_log_set_tools_levels(logs);
+	else gf_log_set_tool_level(GF_LOG_ALL, GF_LOG_QUIET);
+
+	strcpy(mb.tmp_dir, tmp_dir);
+	if (!gf_dir_exists(mb.tmp_dir)) gf_mkdir(mb.tmp_dir);
+	mb.bt_files = gf_list_new();
+	mb.xmt_files = gf_list_new();
+
+	mbench_tmp_path(&mb, mb.src_mp4, "source.mp4");
+	mbench_tmp_path(&mb, mb.synth_mp4, "synth.mp4");
+	mbench_tmp_path(&mb, mb.src_ts, "source.ts");
+
+	if (mbench_phase_enabled(&mb, "avc_import")) {
+		mbench_tmp_path(&mb, path, "avc.mp4");
+		mbench_import_phase(&mb, "avc_import", "auxiliary_files/enst_video.h264", path);
+	}
+	if (mbench_make_source_file(&mb) != GF_OK) mb.src_mp4[0] = 0;
+
+	if (mbench_phase_enabled(&mb, "hevc_import")) {
+		mbench_tmp_path(&mb, path, "hevc.mp4");
+		mbench_import_phase(&mb, "hevc_import", "auxiliary_files/counter.hvc", path);
+	}
+
+	if (mbench_make_synth_file(&mb) != GF_OK) mb.synth_mp4[0] = 0;
+	if (mbench_phase_enabled(&mb, "isom_open")) mbench_isom_open_phase(&mb);
+	if (mbench_phase_enabled(&mb, "sample_iterate")) mbench_sample_iterate_phase(&mb);
+
+	if (mbench_phase_enabled(&mb, "ts_mux")) mbench_ts_mux_phase(&mb);
+	if (mbench_phase_enabled(&mb, "ts_demux")) {
+		u64 nb_packets;
+		if (!gf_file_exists(mb.src_ts) && mb.src_mp4[0]) mbench_ts_mux(&mb, &nb_packets);
+		mbench_ts_demux_phase(&mb);
+	}
+	if (mbench_phase_enabled(&mb, "dash_segment")) mbench_dash_phase(&mb);
+	if (mbench_phase_enabled(&mb, "cenc_encrypt")) mbench_cenc_phase(&mb);
+
+	if (mbench_phase_enabled(&mb, "bt_load") || mbench_phase_enabled(&mb, "xmt_load")) {
+		mbench_media_path(&mb, path, "bifs");
+		gf_enum_directory(path, GF_FALSE, mbench_enum_scene, mb.bt_files, "bt");
+	}
+	if (mbench_phase_enabled(&mb, "bt_load")) mbench_scene_load_phase(&mb, "bt_load", mb.bt_files);
+	if (mbench_phase_enabled(&mb, "xmt_load")) {
+		mbench_make_xmt_files(&mb);
+		mbench_scene_load_phase(&mb, "xmt_load", mb.xmt_files);
+	}
+	if (mbench_phase_enabled(&mb, "render")) mbench_render_phase(&mb);
+
+	out = out_file ? gf_fopen(out_file, "wt") : stdout;
+	if (out) {
+		mbench_report(&mb, out);
+		if (out_file) gf_fclose(out);
+	} else {
+		fprintf(stderr, "Cannot write report file %s\n", out_file);
+		ret = 1;
+	}
+	if (baseline) {
+		s32 nb_regressions = mbench_compare(&mb, baseline, tolerance);
+		if (nb_regressions<0) ret = 1;
+		else if (nb_regressions) {
+			fprintf(stderr, "%d phase(s) slower than baseline by more than %g%%\n", nb_regressions, tolerance);
+			ret = 2;
+		}
+	}
+
+	while (gf_list_count(mb.bt_files)) gf_free(gf_list_pop_back(mb.bt_files));
+	gf_list_del(mb.bt_files);
+	while (gf_list_count(mb.xmt_files)) gf_free(gf_list_pop_back(mb.xmt_files));
+	gf_list_del(mb.xmt_files);
+
+	gf_cleanup_dir(mb.tmp_dir);
+	gf_rmdir(mb.tmp_dir);
+	gf_sys_close();
+	return ret;
+}
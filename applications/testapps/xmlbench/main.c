@@ -0,0 +1,169 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC - XML parser benchmark
+ *
+ *  Parses XML documents (XMT, SVG, MPD, ...) several times with the SAX and DOM
+ *  parsers and reports the parsing throughput. Test media are small, use -x to
+ *  build large documents from them, e.g.
+ *      xmlbench -x 500 tests/media/svg/all_syntaxes_1.1F2.svg scene.xmt
+ *  where scene.xmt is obtained with MP4Box -xmt from a BT file of tests/media/bifs
+ *
+ */
+
+#include <gpac/xml.h>
+
+static u32 nb_nodes;
+
+static void on_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	nb_nodes++;
+}
+
+static void on_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+}
+
+static void on_text_content(void *sax_cbck, const char *content, Bool is_cdata)
+{
+}
+
+static void print_usage()
+{
+	fprintf(stderr, "Usage: xmlbench [options] file1 [file2 ...]\n"
+	        "\t-n N:   number of parsing runs per file (default 20)\n"
+	        "\t-x K:   parse each document K times from a single file, making a large document (default 1)\n"
+	        "\t-nodom: only benchmark the SAX parser\n"
+	       );
+}
+
+int main(int argc, char **argv)
+{
+	u32 i, nb_runs = 20, nb_replicate = 1;
+	Bool no_dom = GF_FALSE;
+	u64 tot_size = 0, tot_sax = 0, tot_dom = 0;
+	char szTmp[GF_MAX_PATH];
+
+	if (argc<2) {
+		print_usage();
+		return 1;
+	}
+	gf_sys_init(GF_MemTrackerNone);
+
+	for (i=1; i<(u32) argc; i++) {
+		char *arg = argv[i];
+		u32 j, size;
+		u64 start, sax_time, dom_time;
+		const char *file;
+		FILE *in;
+
+		if (!strcmp(arg, "-n") && (i+1<(u32) argc)) {
+			nb_runs = atoi(argv[++i]);
+			continue;
+		} else if (!strcmp(arg, "-x") && (i+1<(u32) argc)) {
+			nb_replicate = atoi(argv[++i]);
+			continue;
+		} else if (!strcmp(arg, "-nodom")) {
+			no_dom = GF_TRUE;
+			continue;
+		} else if (arg[0]=='-') {
+			print_usage();
+			gf_sys_close();
+			return 1;
+		}
+
+		in = gf_fopen(arg, "rb");
+		if (!in) {
+			fprintf(stderr, "Cannot open %s\n", arg);
+			continue;
+		}
+		gf_fseek(in, 0, SEEK_END);
+		size = (u32) gf_ftell(in);
+		gf_fclose(in);
+		file = arg;
+
+		/*wrap K copies of the document body in a single root to get a large input*/
+		if (nb_replicate>1) {
+			char *data, *body, *end;
+			FILE *out;
+			in = gf_fopen(arg, "rb");
+			data = (char *)gf_malloc(size+1);
+			size = (u32) fread(data, 1, size, in);
+			data[size] = 0;
+			gf_fclose(in);
+
+			/*skip prolog*/
+			body = data;
+			while ((body = strchr(body, '<')) != NULL) {
+				if ((body[1]!='?') && (body[1]!='!')) break;
+				body++;
+			}
+			end = body ? strrchr(body, '>') : NULL;
+			if (!body || !end) {
+				fprintf(stderr, "Cannot locate root element in %s\n", arg);
+				gf_free(data);
+				continue;
+			}
+			sprintf(szTmp, "xmlbench_%d.xml", gf_sys_clock());
+			out = gf_fopen(szTmp, "wb");
+			if (!out) {
+				fprintf(stderr, "Cannot create temporary file %s\n", szTmp);
+				gf_free(data);
+				continue;
+			}
+			fprintf(out, "<xmlbench>\n");
+			for (j=0; j<nb_replicate; j++) {
+				gf_fwrite(body, 1, (u32) (end + 1 - body), out);
+				fprintf(out, "\n");
+			}
+			fprintf(out, "</xmlbench>\n");
+			size = (u32) gf_ftell(out);
+			gf_fclose(out);
+			gf_free(data);
+			file = szTmp;
+		}
+
+		nb_nodes = 0;
+		start = gf_sys_clock_high_res();
+		for (j=0; j<nb_runs; j++) {
+			GF_Err e;
+			GF_SAXParser *sax = gf_xml_sax_new(on_node_start, on_node_end, on_text_content, NULL);
+			e = gf_xml_sax_parse_file(sax, file, NULL);
+			if (e<0) fprintf(stderr, "SAX error in %s: %s\n", arg, gf_xml_sax_get_error(sax));
+			gf_xml_sax_del(sax);
+		}
+		sax_time = gf_sys_clock_high_res() - start;
+
+		dom_time = 0;
+		if (!no_dom) {
+			start = gf_sys_clock_high_res();
+			for (j=0; j<nb_runs; j++) {
+				GF_DOMParser *dom = gf_xml_dom_new();
+				GF_Err e = gf_xml_dom_parse(dom, file, NULL, NULL);
+				if (e) fprintf(stderr, "DOM error in %s: %s\n", arg, gf_xml_dom_get_error(dom));
+				gf_xml_dom_del(dom);
+			}
+			dom_time = gf_sys_clock_high_res() - start;
+		}
+		if (file==szTmp) gf_delete_file(szTmp);
+
+		fprintf(stderr, "%s: %d bytes %d nodes - SAX %.2f MB/s", arg, size, nb_runs ? nb_nodes/nb_runs : 0, sax_time ? (Double) size * nb_runs / sax_time : 0);
+		if (!no_dom) fprintf(stderr, " - DOM %.2f MB/s", dom_time ? (Double) size * nb_runs / dom_time : 0);
+		fprintf(stderr, "\n");
+
+		tot_size += (u64) size * nb_runs;
+		tot_sax += sax_time;
+		tot_dom += dom_time;
+	}
+	if (tot_sax) {
+		fprintf(stderr, "Total: SAX %.2f MB/s", (Double) (s64) tot_size / (s64) tot_sax);
+		if (tot_dom) fprintf(stderr, " - DOM %.2f MB/s", (Double) (s64) tot_size / (s64) tot_dom);
+		fprintf(stderr, "\n");
+	}
+	gf_sys_close();
+	return 0;
+}
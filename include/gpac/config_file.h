@@ -51,6 +51,13 @@ extern "C" {
 
 typedef struct __tag_config GF_Config;
 
+/*!
+ *	\brief configuration key handle
+ *
+ *Handle to a key of a configuration file, resolved once with \ref gf_cfg_get_key_handle
+ */
+typedef struct __tag_config_key GF_ConfigKey;
+
 /*!
  *	\brief configuration file initialization
  *
@@ -122,6 +129,24 @@ const char *gf_cfg_get_key(GF_Config *cfgFile, const char *secName, const char *
  *\return the desired key value if found, NULL otherwise.
  */
 const char *gf_cfg_get_ikey(GF_Config *cfgFile, const char *secName, const char *keyName);
+/*!
+ *	\brief key handle query
+ *
+ *Gets a handle to a key from its section and name, so that the key value can later be queried without any lookup. The handle is valid until the configuration file is destroyed, even if the key or its section are removed or not yet created.
+ *\param cfgFile the target configuration file
+ *\param secName the desired key parent section name
+ *\param keyName the desired key name
+ *\return the key handle, NULL if error
+ */
+GF_ConfigKey *gf_cfg_get_key_handle(GF_Config *cfgFile, const char *secName, const char *keyName);
+/*!
+ *	\brief key value query from handle
+ *
+ *Gets the current value of a key from its handle.
+ *\param key the key handle
+ *\return the key value if the key is set, NULL otherwise.
+ */
+const char *gf_cfg_get_key_by_handle(GF_ConfigKey *key);
 /*!
  *	\brief key value update
  *
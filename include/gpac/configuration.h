@@ -298,6 +298,9 @@
 /*disables VOBSUB */
 //#define GPAC_DISABLE_VOBSUB
 
+/*disables structured tracing*/
+//#define GPAC_DISABLE_TRACE
+
 
 #endif		/*_GF_CONFIG_H_*/
 
@@ -373,7 +373,7 @@ const char * gf_cache_get_cache_filename_range( const GF_DownloadSession * sess,
  *\param server the remote server address
  *\param path the path on the remote server
  *\param total_size the total size in bytes the file fetched, 0 if unknown.
- *\param bytes_done the amount of bytes received from the server
+ *\param bytes_done the amount of bytes received from the server. When the session uses a disk cache with a write-behind buffer, only bytes already written to the cache file are counted
  *\param bytes_per_sec the average data rate in bytes per seconds
  *\param net_status the session status
  */
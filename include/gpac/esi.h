@@ -88,6 +88,9 @@ enum
 	GF_ESI_DATA_REPEAT		=	1<<5,
 	GF_ESI_DATA_CRITICAL	=	1<<6,
 	GF_ESI_DATA_ENCRYPTED	=	1<<7,
+	/*the data buffer has been allocated with gf_malloc and its ownership is handed over to the consumer,
+	which will gf_free it once consumed. The producer shall not access the buffer after dispatch*/
+	GF_ESI_DATA_TRANSFER	=	1<<8,
 };
 
 typedef struct __data_packet_ifce
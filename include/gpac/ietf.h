@@ -1275,6 +1275,12 @@ void gp_rtp_builder_set_cryp_info(GP_RTPPacketizer *builder, u64 IV, char *key_i
 @descIndex: sample description index (only needed for 3GPP text streams)
 */
 GF_Err gf_rtp_builder_process(GP_RTPPacketizer *builder, char *data, u32 data_size, u8 IsAUEnd, u32 FullAUSize, u32 duration, u8 descIndex);
+/*packetize an input buffer which is only referenced: the payload is never read and is signaled through OnDataReference.
+Only MPEG-4 generic, LATM and AC3 payloads are supported, GF_NOT_SUPPORTED is returned otherwise
+@data_size: input buffer size, must not be 0 (use gf_rtp_builder_process with no data to flush)
+other parameters are as in gf_rtp_builder_process
+*/
+GF_Err gf_rtp_builder_process_ref(GP_RTPPacketizer *builder, u32 data_size, u8 IsAUEnd, u32 FullAUSize, u32 duration);
 
 /*format the "fmtp: " attribute for the MPEG-4 generic packetizer. sdpline shall be at least 2000 char*/
 GF_Err gf_rtp_builder_format_sdp(GP_RTPPacketizer *builder, char *payload_name, char *sdpLine, char *dsi, u32 dsi_size);
@@ -1332,8 +1338,12 @@ struct __tag_rtp_depacketizer
 	GP_RTPSLMap sl_map;
 	u32 clock_rate;
 
-	/*inter-packet reconstruction bitstream (for 3GP text and H264)*/
+	/*inter-packet reconstruction bitstream (for 3GP text and MPEG-1/2 video)*/
 	GF_BitStream *inter_bs;
+	/*NAL reassembly buffer for H264/HEVC fragmentation units - the buffer is kept across NALs,
+	nal_buf_size is 0 when no NAL is being reassembled*/
+	char *nal_buf;
+	u32 nal_buf_size, nal_buf_alloc;
 
 	/*H264/AVC config*/
 	u32 h264_pck_mode;
@@ -179,6 +179,8 @@ struct __tag_compositor
 	GF_User *user;
 	/*terminal - only used for InputSensor*/
 	GF_Terminal *term;
+	/*config keys checked at runtime*/
+	GF_ConfigKey *cfg_color_key, *cfg_screen_width, *cfg_screen_height;
 
 	/*audio renderer*/
 	struct _audio_render *audio_renderer;
@@ -1419,6 +1421,9 @@ void gf_font_manager_delete_span(GF_FontManager *fm, GF_TextSpan *tspan);
 GF_Err gf_font_manager_register_font(GF_FontManager *fm, GF_Font *font);
 GF_Err gf_font_manager_unregister_font(GF_FontManager *fm, GF_Font *font);
 
+/*gets shaped span and rasterized span cache statistics*/
+void gf_font_manager_get_cache_stats(GF_FontManager *fm, u32 *shape_hits, u32 *shape_miss, u32 *raster_hits, u32 *raster_miss, u32 *bytes_used);
+
 void gf_font_manager_refresh_span_bounds(GF_TextSpan *span);
 GF_Path *gf_font_span_create_path(GF_TextSpan *span);
 
@@ -53,17 +53,21 @@ typedef struct
 } GF_RTCPHeader;
 
 
+/*slot of the RTP reorderer ring - slot buffers are kept across packets and only grow*/
 typedef struct __PRO_item
 {
-	struct __PRO_item *next;
 	u32 pck_seq_num;
-	void *pck;
-	u32 size;
+	char *pck;
+	u32 size, alloc_size;
+	Bool used;
 } GF_POItem;
 
 typedef struct __PO
 {
-	struct __PRO_item *in;
+	/*packet ring, indexed by sequence number modulo nb_slots (power of 2)*/
+	GF_POItem *slots;
+	u32 nb_slots;
+	/*next sequence number to output*/
 	u32 head_seqnum;
 	u32 Count;
 	u32 MaxCount;
@@ -84,6 +88,8 @@ void gf_rtp_reorderer_reset(GF_RTPReorder *po);
 GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u32 pck_seqnum);
 /*gets the output of the queue. Packet Data IS YOURS to delete*/
 void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size);
+/*gets the output of the queue without copy. Packet Data belongs to the queue and is valid until the next call to gf_rtp_reorderer_add*/
+const char *gf_rtp_reorderer_get_ex(GF_RTPReorder *po, u32 *pck_size);
 
 
 /*the RTP channel with both RTP and RTCP sockets and buffers
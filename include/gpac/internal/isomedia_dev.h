@@ -654,6 +654,8 @@ typedef struct
 
 	GF_ISOFile *mov;
 
+	/*set when parsed in GF_ISOM_OPEN_READ_LAZY mode, propagated to trak/mdia/minf/stbl children*/
+	Bool lazy_stbl;
 } GF_MovieBox;
 
 typedef struct
@@ -726,6 +728,10 @@ typedef struct
 	Bool first_traf_merged;
 	Bool present_in_scalable_segment;
 #endif
+	/*parsed in GF_ISOM_OPEN_READ_LAZY mode*/
+	Bool lazy_stbl;
+	/*track ID was allocated by gf_isom_new_track rather than requested by the caller*/
+	Bool auto_track_id;
 } GF_TrackBox;
 
 typedef struct
@@ -758,6 +764,8 @@ typedef struct __tag_media_box
 	GF_HandlerBox *handler;
 	struct __tag_media_info_box *information;
 	u64 BytesMissing;
+	/*parsed in GF_ISOM_OPEN_READ_LAZY mode*/
+	Bool lazy_stbl;
 } GF_MediaBox;
 
 typedef struct
@@ -1125,6 +1133,8 @@ static const u8 GF_ISOM_IPOD_EXT[][16] = { { 0x6B, 0x68, 0x40, 0xF2, 0x5F, 0x24,
 
 Bool gf_isom_is_nalu_based_entry(GF_MediaBox *mdia, GF_SampleEntryBox *_entry);
 GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32 sampleNumber, GF_MPEGVisualSampleEntryBox *entry);
+/*returns GF_TRUE if gf_isom_nalu_sample_rewrite may modify the sample payload (only the RAP flag is updated otherwise)*/
+Bool gf_isom_nalu_sample_rewrite_changes_data(GF_MediaBox *mdia, GF_MPEGVisualSampleEntryBox *entry);
 
 /*this is the default visual sdst (to handle unknown media)*/
 typedef struct
@@ -1445,6 +1455,12 @@ typedef struct
 	u32 currentEntryIndex;
 
 	Bool no_sync_found;
+
+	/*file offsets of child boxes not yet parsed (GF_ISOM_OPEN_READ_LAZY mode), NULL once loaded*/
+	u64 *lazy_offsets;
+	u32 nb_lazy_offsets;
+	/*parsed in GF_ISOM_OPEN_READ_LAZY mode, sample table child boxes are only located*/
+	Bool lazy_stbl;
 } GF_SampleTableBox;
 
 typedef struct __tag_media_info_box
@@ -1456,6 +1472,8 @@ typedef struct __tag_media_info_box
 	struct __tag_data_map *scalableDataHandler;
 	struct __tag_data_map *dataHandler;
 	u32 dataEntryIndex;
+	/*parsed in GF_ISOM_OPEN_READ_LAZY mode*/
+	Bool lazy_stbl;
 } GF_MediaInformationBox;
 
 GF_Err stbl_AppendDependencyType(GF_SampleTableBox *stbl, u32 isLeading, u32 dependsOn, u32 dependedOn, u32 redundant);
@@ -1943,6 +1961,9 @@ typedef struct
 	//temp storage of prft box
 	u32 reference_track_ID;
 	u64 ntp, timestamp;
+
+	/*when parsed, per-sample info of the fragment (trun entries, senc aux info) is allocated from this arena*/
+	GF_MemArena *arena;
 } GF_MovieFragmentBox;
 
 
@@ -2006,6 +2027,8 @@ typedef struct
 	GF_TFBaseMediaDecodeTimeBox *tfdt;
 
 	u64 moof_start_in_bs;
+	/*arena of the parent moof when parsed*/
+	GF_MemArena *arena;
 } GF_TrackFragmentBox;
 
 /*FLAGS for TRUN : specify what is written in the SampleTable of TRUN*/
@@ -2031,6 +2054,8 @@ typedef struct
 
 	/*in write mode with data caching*/
 	GF_BitStream *cache;
+	/*arena of the parent moof when parsed, entries are then allocated from it*/
+	GF_MemArena *arena;
 } GF_TrackFragmentRunBox;
 
 typedef struct
@@ -2752,6 +2777,8 @@ typedef struct __sample_encryption_box
 
 	GF_List *samp_aux_info; /*GF_CENCSampleAuxInfo*/
 	u64 bs_offset;
+	/*set when samp_aux_info entries were allocated from the arena of the parent moof*/
+	Bool sai_in_arena;
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	/*pointer to container traf*/
@@ -3177,6 +3204,8 @@ struct __tag_isom {
 	GF_MetaBox *meta;
 
 	Bool dump_mode_alloc;
+	/*sample tables are only located at open time and parsed on first access (GF_ISOM_OPEN_READ_LAZY)*/
+	Bool lazy_stbl;
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	u32 FragmentsFlags, NextMoofNumber;
@@ -3221,6 +3250,8 @@ GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progre
 GF_ISOFile *gf_isom_new_movie();
 /*Movie and Track access functions*/
 GF_TrackBox *gf_isom_get_track_from_file(GF_ISOFile *the_file, u32 trackNumber);
+/*same as above, but does not parse sample tables not yet loaded (GF_ISOM_OPEN_READ_LAZY mode) if load_tables is not set*/
+GF_TrackBox *gf_isom_get_track_from_file_ex(GF_ISOFile *the_file, u32 trackNumber, Bool load_tables);
 GF_TrackBox *gf_isom_get_track(GF_MovieBox *moov, u32 trackNumber);
 GF_TrackBox *gf_isom_get_track_from_id(GF_MovieBox *moov, u32 trackID);
 GF_TrackBox *gf_isom_get_track_from_original_id(GF_MovieBox *moov, u32 originalID, u32 originalFile);
@@ -3243,6 +3274,8 @@ Bool Track_IsMPEG4Stream(u32 HandlerType);
 Bool IsMP4Description(u32 entryType);
 /*Find a reference of a given type*/
 GF_Err Track_FindRef(GF_TrackBox *trak, u32 ReferenceType, GF_TrackReferenceTypeBox **dpnd);
+/*parses sample tables not yet loaded (GF_ISOM_OPEN_READ_LAZY mode)*/
+GF_Err Track_LoadSampleTables(GF_TrackBox *trak);
 /*Time and sample*/
 GF_Err GetMediaTime(GF_TrackBox *trak, Bool force_non_empty, u64 movieTime, u64 *MediaTime, s64 *SegmentStartTime, s64 *MediaOffset, u8 *useEdit, u64 *next_edit_start_plus_one);
 GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp, u32 *sampleDescriptionIndex, Bool no_data, u64 *out_offset);
@@ -3317,6 +3350,8 @@ GF_Err stbl_AddSize(GF_SampleSizeBox *stsz, u32 sampleNumber, u32 size);
 GF_Err stbl_AddRAP(GF_SyncSampleBox *stss, u32 sampleNumber);
 GF_Err stbl_AddShadow(GF_ShadowSyncBox *stsh, u32 sampleNumber, u32 shadowNumber);
 GF_Err stbl_AddChunkOffset(GF_MediaBox *mdia, u32 sampleNumber, u32 StreamDescIndex, u64 offset);
+/*preallocates the size and chunk tables for nb_samples new samples*/
+GF_Err stbl_ReserveSamples(GF_SampleTableBox *stbl, u32 nb_samples);
 /*NB - no add for padding, this is done only through SetPaddingBits*/
 
 GF_Err stbl_AddSampleFragment(GF_SampleTableBox *stbl, u32 sampleNumber, u16 size);
@@ -3386,6 +3421,8 @@ GF_Err udta_AddBox(GF_Box *ptr, GF_Box *a);
 GF_Err edts_AddBox(GF_Box *s, GF_Box *a);
 GF_Err stdp_Read(GF_Box *s, GF_BitStream *bs);
 GF_Err stbl_AddBox(GF_Box *ptr, GF_Box *a);
+u64 stbl_SkipLazyBox(GF_SampleTableBox *ptr, GF_BitStream *bs);
+GF_Err stbl_LoadLazyBoxes(GF_SampleTableBox *ptr, GF_BitStream *bs);
 GF_Err sdtp_Read(GF_Box *s, GF_BitStream *bs);
 GF_Err dinf_AddBox(GF_Box *s, GF_Box *a);
 GF_Err minf_AddBox(GF_Box *s, GF_Box *a);
@@ -133,6 +133,18 @@ GF_Err gf_m3u8_parse_master_playlist(const char *file, MasterPlaylist **playlist
  */
 GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, const char *baseURL, Stream *in_program, PlaylistElement *sub_playlist);
 
+/**
+ * Parse the given media playlist file when reloading a live playlist. Media segments with a sequence number in [known_media_seq_min, known_media_seq_max] are only accounted for in the playlist duration and timing, no element is created for them.
+ * If the playlist media sequence is lower than known_media_seq_min (sequence reset), all segments are declared.
+ * \param file The file from cache to parse
+ * \param playlist The playlist to fill. If argument is null, and file is valid, playlist will be allocated
+ * \param baseURL The base URL of the playlist
+ * \param known_media_seq_min first media sequence number of the previously loaded playlist
+ * \param known_media_seq_max last media sequence number of the previously loaded playlist, 0 to parse all segments
+ * \return GF_OK if playlist valid
+ */
+GF_Err gf_m3u8_parse_media_playlist_update(const char *file, MasterPlaylist **playlist, const char *baseURL, int known_media_seq_min, int known_media_seq_max);
+
 /**
  * Deletes the given MasterPlaylist and all of its sub elements
  */
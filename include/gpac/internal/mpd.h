@@ -376,10 +376,14 @@ typedef struct {
 
 	/*set during parsing*/
 	const char *xml_namespace; /*won't be freed by GPAC*/
+	/*segment timelines already built while loading the XML, only valid during parsing*/
+	GF_List *parsed_timelines;
 } GF_MPD;
 
 GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
 GF_Err gf_mpd_complete_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *base_url);
+/*loads the MPD from file in a single SAX pass; SegmentTimeline entries are directly built while parsing and never stored as XML nodes*/
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *base_url);
 
 GF_MPD *gf_mpd_new();
 void gf_mpd_del(GF_MPD *mpd);
@@ -408,7 +412,9 @@ struct _gf_file_get
 GF_Err gf_m3u8_to_mpd(const char *m3u8_file, const char *base_url, const char *mpd_file, u32 reload_count, char *mimeTypeForM3U8Segments, Bool do_import, Bool use_mpd_templates,
                       GF_FileDownload *getter, GF_MPD *mpd, Bool parse_sub_playlist);
 
-GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDownload *getter, Bool *is_static, u64 *duration);
+/*solves the m3u8 media playlist of the representation - if known_media_seq_max is not 0, the playlist is a reload of a live playlist
+and only segments outside [known_media_seq_min, known_media_seq_max] are added to the segment list*/
+GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDownload *getter, Bool *is_static, u64 *duration, u32 known_media_seq_min, u32 known_media_seq_max);
 
 GF_MPD_SegmentList *gf_mpd_solve_segment_list_xlink(GF_MPD *mpd, GF_XMLNode *root);
 
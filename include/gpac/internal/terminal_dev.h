@@ -391,6 +391,8 @@ struct _tag_terminal
 
 	/*callback to user application*/
 	GF_User *user;
+	/*config keys checked at runtime*/
+	GF_ConfigKey *cfg_time_slice, *cfg_frame_rate, *cfg_language;
 	/*scene compositor*/
 	struct __tag_compositor *compositor;
 	/*file downloader*/
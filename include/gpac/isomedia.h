@@ -81,6 +81,10 @@ enum
 	GF_ISOM_WRITE_EDIT,
 	/*Opens an existing file for fragment concatenation*/
 	GF_ISOM_OPEN_CAT_FRAGMENTS,
+	/*Opens a file in READ ONLY mode, sample tables (stts, ctts, stss, stsc, stsz, stco/co64, sdtp, sbgp)
+	are only located and parsed on the first access to the samples of the track. Track count, IDs,
+	sample descriptions, sample count, timescales and header durations are available without loading them*/
+	GF_ISOM_OPEN_READ_LAZY,
 };
 
 /*Movie Options for file writing*/
@@ -431,6 +435,9 @@ typedef struct
 	/*relative offset for composition if needed*/
 	s32 CTS_Offset;
 	SAPType IsRAP;
+	/*size of the data buffer when the sample is reused with gf_isom_get_sample_into, 0 otherwise. Reset to 0 by
+	sample rewrites (NALU, OD, text) replacing or resizing the buffer, in which case the buffer is not reused*/
+	u32 alloc_size;
 } GF_ISOSample;
 
 
@@ -438,7 +445,7 @@ typedef struct
 GF_ISOSample *gf_isom_sample_new();
 
 /*delete a sample. NOTE:the buffer content will be destroyed by default.
-if you wish to keep the buffer, set dataLength to 0 in the sample
+if you wish to keep the buffer, set dataLength and alloc_size to 0 in the sample
 before deleting it
 the pointer is set to NULL after deletion*/
 void gf_isom_sample_del(GF_ISOSample **samp);
@@ -464,6 +471,11 @@ tmp_dir: for the 2 edit modes only, specifies a location for temp file. If NULL,
 OS temporary file management schemes.*/
 GF_ISOFile *gf_isom_open(const char *fileName, u32 OpenMode, const char *tmp_dir);
 
+/*sets the number of threads used to parse movie fragments when opening fragmented files in read mode. Fragments
+are parsed in parallel and merged in file order. 0 (default) uses one thread per core, up to 8, 1 disables parallel parsing.
+This setting applies to all files opened afterwards*/
+void gf_isom_set_fragment_parser_threads(u32 nb_threads);
+
 /*close the file, write it if new/edited*/
 GF_Err gf_isom_close(GF_ISOFile *the_file);
 
@@ -648,6 +660,18 @@ this index allows to retrieve the stream description if needed (2 media in 1 tra
 return NULL if error*/
 GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 *StreamDescriptionIndex);
 
+/*same as gf_isom_get_sample but fetches the sample in @samp, reusing its data buffer (grown if needed) across calls.
+@samp must be created with gf_isom_sample_new and only be filled by this function; it is destroyed with gf_isom_sample_del.
+This avoids allocating a sample and its data for each call when processing a track sample by sample*/
+GF_Err gf_isom_get_sample_into(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, GF_ISOSample *samp, u32 *StreamDescriptionIndex);
+
+/*reads in @buffer the media data of up to @nb_samples samples starting at @sampleNumber, as long as they are stored
+contiguously in the file, share the same stream description and fit in @buffer_size bytes, using a single read.
+@nb_read is set to the number of samples read (at least 1 on success) and @data_size to the number of bytes read.
+Returns GF_BUFFER_TOO_SMALL if the first sample does not fit in @buffer, and GF_NOT_SUPPORTED if the samples must be
+fetched through gf_isom_get_sample (OD, NALU-based or streaming text tracks)*/
+GF_Err gf_isom_get_sample_run(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 nb_samples, char *buffer, u32 buffer_size, u32 *nb_read, u32 *data_size);
+
 /*same as gf_isom_get_sample but doesn't fetch media data
 @StreamDescriptionIndex (optional): set to stream description index
 @data_offset (optional): set to sample start offset in file.
@@ -999,9 +1023,40 @@ GF_Err gf_isom_rewrite_track_dependencies(GF_ISOFile *movie, u32 trackNumber);
 /*Add samples to a track. Use streamDescriptionIndex to specify the desired stream (if several)*/
 GF_Err gf_isom_add_sample(GF_ISOFile *the_file, u32 trackNumber, u32 StreamDescriptionIndex, const GF_ISOSample *sample);
 
+/*sample descriptor for gf_isom_add_samples_batch*/
+typedef struct
+{
+	/*data size*/
+	u32 dataLength;
+	/*decoding time*/
+	u64 DTS;
+	/*relative offset for composition if needed*/
+	s32 CTS_Offset;
+	SAPType IsRAP;
+	/*sample payload, written to the file for self-contained sample descriptions - payloads stored contiguously
+	in memory are written at once*/
+	const char *data;
+	/*offset of the sample payload in the referenced data for sample descriptions using an external data reference
+	(data is then ignored)*/
+	u64 dataOffset;
+} GF_ISOBatchSample;
+
+/*adds nb_samples samples to a track, in decoding order. This is equivalent to calling gf_isom_add_sample (or
+gf_isom_add_sample_reference for external data references) for each sample, but the track setup, duration update
+and sample table growth are done once per batch*/
+GF_Err gf_isom_add_samples_batch(GF_ISOFile *the_file, u32 trackNumber, u32 StreamDescriptionIndex, const GF_ISOBatchSample *samples, u32 nb_samples);
+
 //copies all sample dependency, subSample and sample group information from the given sampleNumber in source file to the last added sample in dest file
 GF_Err gf_isom_copy_sample_info(GF_ISOFile *dst, u32 dst_track, GF_ISOFile *src, u32 src_track, u32 sampleNumber);
 
+/*appends to dst_track up to nb_samples samples of src_track starting at sampleNumber, moving the media data of samples
+stored contiguously in the source file with a single read and write. Sample DTS are set to ts_scale*DTS + dts_shift and
+CTS offsets to ts_scale*CTS_Offset, and the source sample description index is used in the destination track.
+nb_copied is set to the number of samples appended, which is at least 1 on success.
+Sample dependency, subSample and sample group information are copied as with gf_isom_copy_sample_info.
+Returns GF_NOT_SUPPORTED if the samples must be fetched through gf_isom_get_sample (OD, NALU rewrite, external data, ...)*/
+GF_Err gf_isom_copy_sample_run(GF_ISOFile *dst, u32 dst_track, GF_ISOFile *src, u32 src_track, u32 sampleNumber, u32 nb_samples, Double ts_scale, u64 dts_shift, u32 *nb_copied);
+
 /*Add sync shadow sample to a track.
 - There must be a regular sample with the same DTS.
 - Sync Shadow samples MUST be RAP
@@ -1315,6 +1370,14 @@ also clones sampleDescriptions
 @keep_data_ref: if set, all data references are kept (local ones become external pointing to orig_file name), otherwise all external data refs are removed (track media data will be self-contained)
 @dest_track: track number of cloned track*/
 GF_Err gf_isom_clone_track(GF_ISOFile *orig_file, u32 orig_track, GF_ISOFile *dest_file, Bool keep_data_ref, u32 *dest_track);
+/*moves all tracks of @src into @dest, appending their media data to the destination edit data. @src must be a movie opened in edit mode
+in which tracks were only created and filled (typically by an importer running on a private movie); brands and PL indications changed in
+@src are applied to @dest. Track IDs explicitly requested when creating the tracks in @src are kept when available in @dest, other IDs
+are allocated in @dest as for new tracks, so that the result is the same as importing directly in @dest.
+Returns GF_NOT_SUPPORTED if @src holds movie-level data (root OD, user data, ...) or non self-contained tracks.
+On error, no track is moved and @src is left unchanged; media data appended to @dest before an IO error is not referenced by any track.
+On success, @src is left without tracks*/
+GF_Err gf_isom_move_tracks(GF_ISOFile *dest, GF_ISOFile *src);
 /*special shortcut: clones IOD PLs from orig to dest if any*/
 GF_Err gf_isom_clone_pl_indications(GF_ISOFile *orig, GF_ISOFile *dest);
 /*clones root OD from input to output file, without copying root OD track references*/
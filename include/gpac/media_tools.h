@@ -1030,6 +1030,14 @@ void gf_hinter_track_del(GF_RTPHinter *tkHinter);
  */
 GF_Err gf_hinter_track_process(GF_RTPHinter *tkHinter);
 
+/*!
+ hints all samples of several media tracks of the same file concurrently, one thread per track. Each hint track is built in a temporary movie and moved to the media file once all tracks are done, in list order.
+ \param hinters list of track hinter objects, all created on the same file
+ \param tmp_dir directory for the temporary movies, or NULL for the system temporary directory
+ \return error if any
+ */
+GF_Err gf_hinter_track_process_parallel(GF_List *hinters, const char *tmp_dir);
+
 /*! 
  Gets media bandwidth in kbps
  \param tkHinter track hinter object
@@ -306,6 +306,14 @@ GF_Err gf_sk_send(GF_Socket *sock, const char *buffer, u32 length);
  *\param read the actual number of bytes received
  */
 GF_Err gf_sk_receive(GF_Socket *sock, char *buffer, u32 length, u32 start_from, u32 *read);
+/*!
+ *\brief socket probing
+ *
+ *Checks the state of a connected socket without waiting nor consuming any data
+ *\param sock the socket object
+ *\return GF_IP_NETWORK_EMPTY if no data is pending, GF_OK if data is pending, GF_IP_CONNECTION_CLOSED if the remote peer closed the connection
+ */
+GF_Err gf_sk_probe(GF_Socket *sock);
 /*!
  *\brief socket listening
  *
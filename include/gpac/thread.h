@@ -160,6 +160,15 @@ void gf_th_set_priority(GF_Thread *th, s32 priority);
 */
 u32 gf_th_id();
 
+/*!
+ *\brief thread name
+ *
+ *Gets the name of a thread, as given at creation time.
+ *\param th_id ID of the thread, or 0 for the current thread
+ *\return the thread name, "Main Process" for threads not created by GPAC, or NULL if logs are disabled
+*/
+const char *gf_th_name(u32 th_id);
+
 #ifdef GPAC_ANDROID
 /*!
  * Register a function that will be called before pthread_exist is called
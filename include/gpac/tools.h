@@ -788,6 +788,45 @@ u64 gf_sys_clock_high_res();
  */
 void gf_sleep(u32 ms);
 
+/*!
+ *\brief memory arena object
+ *
+ *A memory arena serves many small allocations from a few large blocks. Allocations cannot be freed individually, they are all released when the arena is reset or destroyed.
+ */
+typedef struct __gf_mem_arena GF_MemArena;
+
+/*!
+ *	\brief arena constructor
+ *
+ *	Constructs a new memory arena.
+ *	\param block_size size in bytes of the blocks allocated by the arena. Requests larger than this size get their own block.
+ *	\return new arena object
+ */
+GF_MemArena *gf_arena_new(u32 block_size);
+/*!
+ *	\brief arena destructor
+ *
+ *	Destroys a memory arena and releases all allocations made from it.
+ *	\param arena the target arena
+ */
+void gf_arena_del(GF_MemArena *arena);
+/*!
+ *	\brief arena reset
+ *
+ *	Releases all allocations made from the arena, which can then be used again.
+ *	\param arena the target arena
+ */
+void gf_arena_reset(GF_MemArena *arena);
+/*!
+ *	\brief arena allocation
+ *
+ *	Allocates memory from the arena. The memory is set to 0 and aligned on 8 bytes. It shall NOT be passed to gf_free.
+ *	\param arena the target arena
+ *	\param size number of bytes to allocate
+ *	\return allocated memory or NULL if error
+ */
+void *gf_arena_alloc(GF_MemArena *arena, u32 size);
+
 #ifdef WIN32
 /*!
  *	\brief WINCE time constant
@@ -0,0 +1,169 @@
+/*
+ *			GPAC - Multimedia Framework C SDK
+ *
+ *			Authors: GPAC contributors
+ *			Copyright (c) GPAC contributors 2026
+ *					All rights reserved
+ *
+ *  This file is part of GPAC / common tools sub-project
+ *
+ *  GPAC is free software; you can redistribute it and/or modify
+ *  it under the terms of the GNU Lesser General Public License as published by
+ *  the Free Software Foundation; either version 2, or (at your option)
+ *  any later version.
+ *
+ *  GPAC is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; see the file COPYING.  If not, write to
+ *  the Free Software Foundation, 675 Mass Ave, Cambridge, MA 02139, USA.
+ *
+ */
+
+#ifndef _GF_TRACE_H_
+#define _GF_TRACE_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*!
+ *	\file <gpac/trace.h>
+ *	\brief Structured tracing
+ */
+
+/*!
+*	\addtogroup trace_grp Tracing
+*	\ingroup utils_grp
+*	\brief Structured tracing
+*
+*This section documents the tracing tools of the GPAC framework. Unlike logs, trace events are not formatted when emitted:
+*each thread records binary events (span begin/end, counters, flows) in its own ring buffer, without locking. The recorded
+*events can be dumped in the Chrome trace event JSON format, which can be loaded in chrome://tracing or the Perfetto UI.
+*
+*Tracing is disabled by default; when disabled, the trace macros only cost a function call. The macros are removed
+*at compile time when GPAC_DISABLE_TRACE is defined.
+*	@{
+*/
+
+#include <gpac/tools.h>
+
+/*!
+ *\brief Trace event types
+ */
+typedef enum
+{
+	/*! start of a span in the calling thread*/
+	GF_TRACE_EVT_BEGIN = 0,
+	/*! end of the last span started in the calling thread*/
+	GF_TRACE_EVT_END,
+	/*! instant event*/
+	GF_TRACE_EVT_INSTANT,
+	/*! counter value*/
+	GF_TRACE_EVT_COUNTER,
+	/*! start of a flow, the value is the flow ID*/
+	GF_TRACE_EVT_FLOW_START,
+	/*! end of a flow, the value is the flow ID*/
+	GF_TRACE_EVT_FLOW_END,
+} GF_TraceEventType;
+
+/*!
+ *\brief starts tracing
+ *
+ *Starts recording trace events. Events previously recorded are discarded.
+ *\param nb_events_per_thread size of the ring buffer of each thread, in events. If 0, a default size of 64k events is used. When a ring buffer is full, oldest events are overwritten. Buffers of threads which already recorded events keep their size.
+ *\return error if any
+ */
+GF_Err gf_trace_start(u32 nb_events_per_thread);
+
+/*!
+ *\brief stops tracing
+ *
+ *Stops recording trace events. Recorded events are kept until the next call to \ref gf_trace_start or until \ref gf_sys_close.
+ */
+void gf_trace_stop();
+
+/*!
+ *\brief tracing state
+ *
+ *\return GF_TRUE if trace events are being recorded
+ */
+Bool gf_trace_is_on();
+
+/*!
+ *\brief records a trace event
+ *
+ *Records a trace event in the ring buffer of the calling thread. This should not be called directly, use the trace macros instead.
+ *\param type type of the event
+ *\param tool log tool used as category of the event
+ *\param name name of the event. The string is not copied and must be a static string (usually a literal)
+ *\param value counter value or flow ID, ignored for other events
+ */
+void gf_trace_event(GF_TraceEventType type, GF_LOG_Tool tool, const char *name, s64 value);
+
+/*!
+ *\brief dumps trace events
+ *
+ *Dumps the recorded events of all threads in the Chrome trace event JSON format. This should be called once tracing is stopped.
+ *\param file_name name of the output file
+ *\return error if any
+ */
+GF_Err gf_trace_dump(const char *file_name);
+
+#ifdef GPAC_DISABLE_TRACE
+#define GF_TRACE_BEGIN(_tool, _name)
+#define GF_TRACE_END(_tool, _name)
+#define GF_TRACE_INSTANT(_tool, _name)
+#define GF_TRACE_COUNTER(_tool, _name, _value)
+#define GF_TRACE_FLOW_START(_tool, _name, _id)
+#define GF_TRACE_FLOW_END(_tool, _name, _id)
+#else
+/*!
+ *	\brief Span begin
+ *	\hideinitializer
+ *
+ *	Macro for starting a span named _name in the calling thread. Spans of a thread must be properly nested.
+*/
+#define GF_TRACE_BEGIN(_tool, _name) gf_trace_event(GF_TRACE_EVT_BEGIN, _tool, _name, 0)
+/*!
+ *	\brief Span end
+ *	\hideinitializer
+ *
+ *	Macro for ending the last span started in the calling thread
+*/
+#define GF_TRACE_END(_tool, _name) gf_trace_event(GF_TRACE_EVT_END, _tool, _name, 0)
+/*!
+ *	\brief Instant event
+ *	\hideinitializer
+*/
+#define GF_TRACE_INSTANT(_tool, _name) gf_trace_event(GF_TRACE_EVT_INSTANT, _tool, _name, 0)
+/*!
+ *	\brief Counter value
+ *	\hideinitializer
+*/
+#define GF_TRACE_COUNTER(_tool, _name, _value) gf_trace_event(GF_TRACE_EVT_COUNTER, _tool, _name, (s64) (_value))
+/*!
+ *	\brief Flow start
+ *	\hideinitializer
+ *
+ *	Macro for starting a flow identified by _id, eg a media segment being downloaded in one thread and parsed in another one
+*/
+#define GF_TRACE_FLOW_START(_tool, _name, _id) gf_trace_event(GF_TRACE_EVT_FLOW_START, _tool, _name, (s64) (_id))
+/*!
+ *	\brief Flow end
+ *	\hideinitializer
+*/
+#define GF_TRACE_FLOW_END(_tool, _name, _id) gf_trace_event(GF_TRACE_EVT_FLOW_END, _tool, _name, (s64) (_id))
+#endif
+
+/*! @} */
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif		/*_GF_TRACE_H_*/
+
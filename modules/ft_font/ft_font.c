@@ -218,6 +218,7 @@ static void ft_rescan_fonts(GF_FontReader *dr)
 		if (!strcmp(key, "FontReader")) continue;
 		if (!strcmp(key, "FontDirectory")) continue;
 		if (!strcmp(key, "RescanFonts")) continue;
+		if (!strcmp(key, "TextCacheSize")) continue;
 		/*any other persistent options should go here*/
 
 		gf_cfg_set_key(cfg, "FontEngine", key, NULL);
@@ -82,10 +82,25 @@ typedef struct
 	u64 last_sender_ntp, cts_for_last_sender_ntp;
 	Double remain_at_buffering_start;
 	Bool buffering;
+
+	/*sample read-ahead for local non-fragmented files: samples are read on a private handle by a dedicated thread*/
+	GF_Thread *prefetch_th;
+	GF_Mutex *prefetch_mx;
+	GF_ISOFile *prefetch_mov;
+	/*max duration in ms read ahead per channel*/
+	u32 prefetch_ms;
+	Bool prefetch_run;
+	/*channels being read ahead*/
+	GF_List *prefetch_channels;
+	/*channel whose sample is being read by the prefetch thread, reset to NULL to discard the sample*/
+	struct __isom_channel *prefetch_ch;
+	/*signaled when a channel may need read-ahead again, while the prefetch thread is waiting*/
+	GF_Semaphore *prefetch_sema;
+	Bool prefetch_waiting;
 } ISOMReader;
 
 
-typedef struct
+typedef struct __isom_channel
 {
 	u32 track, track_id;
 	/*base track if scalable media, 0 otherwise*/
@@ -131,8 +146,20 @@ typedef struct
 	u32 nalu_extract_mode;
 
 	u32 last_sample_desc_index;
+
+	/*samples read ahead, ISOMPrefetchSample in decoding order*/
+	GF_List *prefetch;
+	/*next sample number to read ahead, 0 if channel is not read ahead*/
+	u32 prefetch_next;
+	Bool prefetch_eos;
 } ISOMChannel;
 
+typedef struct
+{
+	GF_ISOSample *sample;
+	u32 sample_num, sample_desc_index;
+} ISOMPrefetchSample;
+
 void isor_reset_reader(ISOMChannel *ch);
 void isor_reader_get_sample(ISOMChannel *ch);
 void isor_reader_release_sample(ISOMChannel *ch);
@@ -155,6 +182,10 @@ void isor_send_cenc_config(ISOMChannel *ch);
 
 void isor_flush_data(ISOMReader *read, Bool check_buffer_level, Bool is_chunk_flush);
 
+void isor_prefetch_start(ISOMReader *read, const char *url);
+void isor_prefetch_stop(ISOMReader *read);
+void isor_prefetch_reset(ISOMChannel *ch);
+
 #ifndef GPAC_DISABLE_ISOM_WRITE
 GF_BaseInterface *isow_load_cache();
 void isow_delete_cache(GF_BaseInterface *bi);
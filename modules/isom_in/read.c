@@ -46,6 +46,7 @@ static void isor_delete_channel(ISOMReader *reader, ISOMChannel *ch)
 	while ((ch2 = (ISOMChannel *)gf_list_enum(reader->channels, &i))) {
 		if (ch2 == ch) {
 			isor_reset_reader(ch);
+			gf_list_del(ch->prefetch);
 			gf_free(ch);
 			gf_list_rem(reader->channels, i-1);
 			return;
@@ -428,6 +429,7 @@ GF_Err ISOR_ConnectService(GF_InputService *plug, GF_ClientService *serv, const
 
 		if (read->no_service_desc) isor_declare_objects(read);
 
+		isor_prefetch_start(read, szURL);
 	} else {
 		/*setup downloader*/
 		isor_setup_download(plug, szURL);
@@ -445,6 +447,8 @@ GF_Err ISOR_CloseService(GF_InputService *plug)
 
 	read->disconnected = GF_TRUE;
 
+	isor_prefetch_stop(read);
+
 	while (gf_list_count(read->channels)) {
 		ISOMChannel *ch = (ISOMChannel *)gf_list_get(read->channels, 0);
 		gf_list_rem(read->channels, 0);
@@ -1087,6 +1091,13 @@ GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
 	case GF_NET_CHAN_SET_PADDING:
 		if (!ch->track) return GF_OK;
 		gf_isom_set_sample_padding(read->mov, ch->track, com->pad.padding_bytes);
+		/*samples read ahead must use the same padding*/
+		if (read->prefetch_mov) {
+			gf_mx_p(read->prefetch_mx);
+			gf_isom_set_sample_padding(read->prefetch_mov, ch->track, com->pad.padding_bytes);
+			gf_mx_v(read->prefetch_mx);
+			isor_prefetch_reset(ch);
+		}
 		return GF_OK;
 	case GF_NET_CHAN_SET_PULL:
 		//we don't pull in DASH base services, we flush as soon as we have a complete segment
@@ -1209,6 +1220,8 @@ GF_Err ISOR_ServiceCommand(GF_InputService *plug, GF_NetworkCommand *com)
 			ch->nalu_extract_mode |= GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG | GF_ISOM_NALU_EXTRACT_VDRD_FLAG | GF_ISOM_NALU_EXTRACT_LAYER_ONLY;
 		}
 		gf_isom_set_nalu_extract_mode(ch->owner->mov, ch->track, ch->nalu_extract_mode);
+		/*samples read ahead use the previous extraction mode*/
+		isor_prefetch_reset(ch);
 		break;
 	default:
 		break;
@@ -1250,6 +1263,7 @@ GF_InputService *isor_client_load()
 	}
 	reader->channels = gf_list_new();
 	reader->segment_mutex = gf_mx_new("ISO Segment");
+	reader->prefetch_mx = gf_mx_new("ISO Prefetch");
 
 	plug->priv = reader;
 	
@@ -1274,6 +1288,7 @@ void isor_client_del(GF_BaseInterface *bi)
 	ISOMReader *read = (ISOMReader *)plug->priv;
 
 	if (read->segment_mutex) gf_mx_del(read->segment_mutex);
+	if (read->prefetch_mx) gf_mx_del(read->prefetch_mx);
 	gf_list_del(read->channels);
 	gf_free(read);
 	gf_free(bi);
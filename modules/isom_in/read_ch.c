@@ -26,6 +26,7 @@
 
 #include "isom_in.h"
 #include <gpac/network.h>
+#include <gpac/trace.h>
 #include <time.h>
 
 #ifndef GPAC_DISABLE_ISOM
@@ -35,6 +36,7 @@ void isor_reset_reader(ISOMChannel *ch)
 {
 	ch->last_state = GF_OK;
 	isor_reader_release_sample(ch);
+	isor_prefetch_reset(ch);
 
 	ch->sample = NULL;
 	ch->sample_num = 0;
@@ -456,11 +458,222 @@ static void init_reader(ISOMChannel *ch)
 
 
 
-void isor_reader_get_sample(ISOMChannel *ch)
+/*safety limit on the number of samples read ahead per channel, in case timestamps do not progress*/
+#define ISOR_PREFETCH_MAX_SAMPLES	1000
+
+static void isor_prefetch_flush(ISOMChannel *ch)
+{
+	while (gf_list_count(ch->prefetch)) {
+		ISOMPrefetchSample *ps = (ISOMPrefetchSample *)gf_list_pop_front(ch->prefetch);
+		gf_isom_sample_del(&ps->sample);
+		gf_free(ps);
+	}
+}
+
+static u32 isor_prefetch_duration(ISOMChannel *ch)
+{
+	ISOMPrefetchSample *first, *last;
+	u32 count = gf_list_count(ch->prefetch);
+	if ((count<2) || !ch->time_scale) return 0;
+	first = (ISOMPrefetchSample *)gf_list_get(ch->prefetch, 0);
+	last = (ISOMPrefetchSample *)gf_list_last(ch->prefetch);
+	if (last->sample->DTS <= first->sample->DTS) return 0;
+	return (u32) ((last->sample->DTS - first->sample->DTS) * 1000 / ch->time_scale);
+}
+
+/*wakes up the prefetch thread if it is waiting for a channel to read ahead - must be called with prefetch_mx held*/
+static void isor_prefetch_wakeup(ISOMReader *read)
+{
+	if (!read->prefetch_waiting) return;
+	read->prefetch_waiting = GF_FALSE;
+	gf_sema_notify(read->prefetch_sema, 1);
+}
+
+/*the prefetch thread always reads the sample with the smallest file offset among channels below their read-ahead
+duration, so that interleaved tracks are read sequentially through the data map and the OS read-ahead*/
+static u32 isor_prefetch_run(void *par)
+{
+	ISOMReader *read = (ISOMReader *)par;
+
+	while (read->prefetch_run) {
+		u32 i, track, sample_num, di;
+		u64 min_offset = 0;
+		ISOMChannel *ch, *sel = NULL;
+		GF_ISOSample *samp;
+
+		gf_mx_p(read->prefetch_mx);
+		i=0;
+		while ((ch = (ISOMChannel *)gf_list_enum(read->prefetch_channels, &i))) {
+			u64 offset;
+			if (ch->prefetch_eos) continue;
+			if (gf_list_count(ch->prefetch) >= ISOR_PREFETCH_MAX_SAMPLES) continue;
+			if (isor_prefetch_duration(ch) >= read->prefetch_ms) continue;
+
+			samp = gf_isom_get_sample_info(read->prefetch_mov, ch->track, ch->prefetch_next, NULL, &offset);
+			if (!samp) {
+				ch->prefetch_eos = GF_TRUE;
+				continue;
+			}
+			gf_isom_sample_del(&samp);
+			if (!sel || (offset < min_offset)) {
+				sel = ch;
+				min_offset = offset;
+			}
+		}
+		/*all channels are full or at end of stream, wait until a sample is consumed or a channel is reset*/
+		if (!sel) {
+			read->prefetch_waiting = GF_TRUE;
+			gf_mx_v(read->prefetch_mx);
+			gf_sema_wait(read->prefetch_sema);
+			continue;
+		}
+		read->prefetch_ch = sel;
+		track = sel->track;
+		sample_num = sel->prefetch_next;
+		gf_isom_set_nalu_extract_mode(read->prefetch_mov, track, sel->nalu_extract_mode);
+		gf_mx_v(read->prefetch_mx);
+
+		di = 0;
+		samp = gf_isom_get_sample(read->prefetch_mov, track, sample_num, &di);
+
+		gf_mx_p(read->prefetch_mx);
+		/*channel has been reset or has resynchronized while we were reading*/
+		if ((read->prefetch_ch != sel) || (sel->prefetch_next != sample_num)) {
+			if (samp) gf_isom_sample_del(&samp);
+		} else if (!samp) {
+			sel->prefetch_eos = GF_TRUE;
+		} else {
+			ISOMPrefetchSample *ps;
+			GF_SAFEALLOC(ps, ISOMPrefetchSample);
+			if (ps) {
+				ps->sample = samp;
+				ps->sample_num = sample_num;
+				ps->sample_desc_index = di;
+				gf_list_add(sel->prefetch, ps);
+				sel->prefetch_next++;
+			} else {
+				gf_isom_sample_del(&samp);
+				sel->prefetch_eos = GF_TRUE;
+			}
+		}
+		read->prefetch_ch = NULL;
+		gf_mx_v(read->prefetch_mx);
+	}
+	return 0;
+}
+
+void isor_prefetch_start(ISOMReader *read, const char *url)
+{
+	const char *opt;
+
+	if (read->prefetch_th) return;
+	/*only for files on a file system, the reader handles progressive download and fragments on its own*/
+	if (read->frag_type || read->missing_bytes || read->input->query_proxy) return;
+	if (!strnicmp(url, "file://", 7)) url += 7;
+	else if (strstr(url, "://")) return;
+
+	opt = gf_modules_get_option((GF_BaseInterface *)read->input, "ISOReader", "PrefetchDuration");
+	if (!opt) {
+		gf_modules_set_option((GF_BaseInterface *)read->input, "ISOReader", "PrefetchDuration", "1000");
+		opt = "1000";
+	}
+	read->prefetch_ms = atoi(opt);
+	if (!read->prefetch_ms) return;
+
+	read->prefetch_mov = gf_isom_open(url, GF_ISOM_OPEN_READ_LAZY, NULL);
+	if (!read->prefetch_mov) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_CONTAINER, ("[IsoMedia] Cannot open %s for sample prefetch: %s\n", url, gf_error_to_string(gf_isom_last_error(NULL)) ));
+		return;
+	}
+	read->prefetch_channels = gf_list_new();
+	read->prefetch_sema = gf_sema_new(1, 0);
+	read->prefetch_th = gf_th_new("ISOPrefetch");
+	read->prefetch_run = GF_TRUE;
+	if (gf_th_run(read->prefetch_th, isor_prefetch_run, read) != GF_OK) {
+		read->prefetch_run = GF_FALSE;
+		isor_prefetch_stop(read);
+		return;
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[IsoMedia] Sample prefetch enabled for %s - %d ms per channel\n", url, read->prefetch_ms));
+}
+
+void isor_prefetch_stop(ISOMReader *read)
+{
+	ISOMChannel *ch;
+	if (!read->prefetch_th) return;
+
+	read->prefetch_run = GF_FALSE;
+	gf_sema_notify(read->prefetch_sema, 1);
+	gf_th_stop(read->prefetch_th);
+	gf_th_del(read->prefetch_th);
+	read->prefetch_th = NULL;
+	gf_sema_del(read->prefetch_sema);
+	read->prefetch_sema = NULL;
+
+	while ((ch = (ISOMChannel *)gf_list_pop_back(read->prefetch_channels))) {
+		isor_prefetch_flush(ch);
+		ch->prefetch_next = 0;
+	}
+	gf_list_del(read->prefetch_channels);
+	read->prefetch_channels = NULL;
+	read->prefetch_ch = NULL;
+
+	gf_isom_close(read->prefetch_mov);
+	read->prefetch_mov = NULL;
+}
+
+void isor_prefetch_reset(ISOMChannel *ch)
+{
+	ISOMReader *read = ch->owner;
+	if (!read || !read->prefetch_th) return;
+
+	gf_mx_p(read->prefetch_mx);
+	isor_prefetch_flush(ch);
+	ch->prefetch_next = 0;
+	ch->prefetch_eos = GF_FALSE;
+	gf_list_del_item(read->prefetch_channels, ch);
+	if (read->prefetch_ch == ch) read->prefetch_ch = NULL;
+	isor_prefetch_wakeup(read);
+	gf_mx_v(read->prefetch_mx);
+}
+
+/*gets the given sample from the read-ahead queue, or NULL if not available. If the sample is not the next one
+in the queue, the queue is flushed and read-ahead restarts after this sample*/
+static GF_ISOSample *isor_prefetch_get(ISOMChannel *ch, u32 sample_num, u32 *sample_desc_index)
+{
+	GF_ISOSample *samp = NULL;
+	ISOMPrefetchSample *ps;
+	ISOMReader *read = ch->owner;
+
+	if (!read->prefetch_th || ch->base_track) return NULL;
+
+	gf_mx_p(read->prefetch_mx);
+	ps = (ISOMPrefetchSample *)gf_list_get(ch->prefetch, 0);
+	if (ps && (ps->sample_num==sample_num)) {
+		gf_list_rem(ch->prefetch, 0);
+		samp = ps->sample;
+		*sample_desc_index = ps->sample_desc_index;
+		gf_free(ps);
+	} else if (!ps && ch->prefetch_eos && (ch->prefetch_next==sample_num)) {
+		/*end of track reached by the prefetcher, let the caller check it*/
+	} else {
+		if (!ch->prefetch) ch->prefetch = gf_list_new();
+		isor_prefetch_flush(ch);
+		ch->prefetch_next = sample_num + 1;
+		ch->prefetch_eos = GF_FALSE;
+		if (read->prefetch_ch==ch) read->prefetch_ch = NULL;
+		if (gf_list_find(read->prefetch_channels, ch)<0)
+			gf_list_add(read->prefetch_channels, ch);
+	}
+	isor_prefetch_wakeup(read);
+	gf_mx_v(read->prefetch_mx);
+	return samp;
+}
+
+static void isor_reader_fetch_sample(ISOMChannel *ch)
 {
 	GF_Err e;
 	u32 sample_desc_index;
-	if (ch->sample) return;
 
 	if (ch->next_track) {
 		ch->track = ch->next_track;
@@ -575,7 +788,9 @@ void isor_reader_get_sample(ISOMChannel *ch)
 	} else {
 		ch->sample_num++;
 
-		ch->sample = gf_isom_get_sample(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index);
+		ch->sample = isor_prefetch_get(ch, ch->sample_num, &sample_desc_index);
+		if (!ch->sample)
+			ch->sample = gf_isom_get_sample(ch->owner->mov, ch->track, ch->sample_num, &sample_desc_index);
 		/*if sync shadow / carousel RAP skip*/
 		if (ch->sample && (ch->sample->IsRAP==RAP_REDUNDANT)) {
 			gf_isom_sample_del(&ch->sample);
@@ -792,6 +1007,15 @@ void isor_reader_get_sample(ISOMChannel *ch)
 	}
 }
 
+void isor_reader_get_sample(ISOMChannel *ch)
+{
+	if (ch->sample) return;
+
+	GF_TRACE_BEGIN(GF_LOG_CONTAINER, "isom read sample");
+	isor_reader_fetch_sample(ch);
+	GF_TRACE_END(GF_LOG_CONTAINER, "isom read sample");
+}
+
 void isor_reader_release_sample(ISOMChannel *ch)
 {
 	if (ch->current_slh.sai) {
@@ -34,6 +34,7 @@
 
 #include "visual_manager.h"
 #include "texturing.h"
+#include <gpac/trace.h>
 
 #define SC_DEF_WIDTH	320
 #define SC_DEF_HEIGHT	240
@@ -576,6 +577,12 @@ GF_Compositor *gf_sc_new(GF_User *user, Bool self_threaded, GF_Terminal *term)
 	tmp->term = term;
 	tmp->mx = gf_mx_new("Compositor");
 
+	if (user) {
+		tmp->cfg_color_key = gf_cfg_get_key_handle(user->config, "Compositor", "ColorKey");
+		tmp->cfg_screen_width = gf_cfg_get_key_handle(user->config, "Compositor", "ScreenWidth");
+		tmp->cfg_screen_height = gf_cfg_get_key_handle(user->config, "Compositor", "ScreenHeight");
+	}
+
 	/*load proto modules*/
 	if (user) {
 		u32 i;
@@ -1070,7 +1077,7 @@ GF_Err gf_sc_set_scene(GF_Compositor *compositor, GF_SceneGraph *scene_graph)
 
 		/*default back color is key color*/
 		if (compositor->user->init_flags & GF_TERM_WINDOWLESS) {
-			opt = gf_cfg_get_key(compositor->user->config, "Compositor", "ColorKey");
+			opt = gf_cfg_get_key_by_handle(compositor->cfg_color_key);
 			if (opt) {
 				u32 r, g, b, a;
 				sscanf(opt, "%02X%02X%02X%02X", &a, &r, &g, &b);
@@ -1087,9 +1094,9 @@ GF_Err gf_sc_set_scene(GF_Compositor *compositor, GF_SceneGraph *scene_graph)
 			width = compositor->scene_width;
 			height = compositor->scene_height;
 
-			opt = gf_cfg_get_key(compositor->user->config, "Compositor", "ScreenWidth");
+			opt = gf_cfg_get_key_by_handle(compositor->cfg_screen_width);
 			if (opt) width = atoi(opt);
-			opt = gf_cfg_get_key(compositor->user->config, "Compositor", "ScreenHeight");
+			opt = gf_cfg_get_key_by_handle(compositor->cfg_screen_height);
 			if (opt) height = atoi(opt);
 
 			if (!compositor->user->os_window_handler) {
@@ -2443,6 +2450,7 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 	texture_time = gf_sys_clock();
 #endif
 	/*update all video textures*/
+	GF_TRACE_BEGIN(GF_LOG_COMPOSE, "update textures");
 	count = gf_list_count(compositor->textures);
 	for (i=0; i<count; i++) {
 		GF_TextureHandler *txh = (GF_TextureHandler *)gf_list_get(compositor->textures, i);
@@ -2461,6 +2469,7 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 			all_tx_done=0;
 		}
 	}
+	GF_TRACE_END(GF_LOG_COMPOSE, "update textures");
 
 	//it may happen that we have a reconfigure request at this stage, especially if updating one of the textures
 	//forced a relayout - do it right away
@@ -2646,7 +2655,9 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 			compositor->frame_draw_type = 0;
 
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Redrawing scene - STB %d\n", compositor->scene_sampled_clock));
+			GF_TRACE_BEGIN(GF_LOG_COMPOSE, "draw scene");
 			gf_sc_draw_scene(compositor);
+			GF_TRACE_END(GF_LOG_COMPOSE, "draw scene");
 #ifndef GPAC_DISABLE_LOG
 			traverse_time = gf_sys_clock() - traverse_time;
 #endif
@@ -2675,7 +2686,9 @@ void gf_sc_render_frame(GF_Compositor *compositor)
 		}
 
 		if (compositor->skip_flush!=1) {
+			GF_TRACE_BEGIN(GF_LOG_COMPOSE, "flush video");
 			gf_sc_flush_video(compositor);
+			GF_TRACE_END(GF_LOG_COMPOSE, "flush video");
 		} else {
 			compositor->skip_flush = 0;
 		}
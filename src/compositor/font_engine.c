@@ -30,6 +30,26 @@
 #include "nodes_stacks.h"
 #include "texturing.h"
 
+/*common header of text cache entries*/
+typedef struct __font_cache_entry
+{
+	/*recency list, least recently used first*/
+	struct __font_cache_entry *prev, *next;
+	/*next entry in the same hash bucket*/
+	struct __font_cache_entry *hash_next;
+	GF_Font *font;
+	u32 crc;
+	u32 size;
+} GF_FontCacheEntry;
+
+/*text cache: entries hashed on their crc, with a recency list for eviction*/
+typedef struct
+{
+	GF_FontCacheEntry *head, *tail;
+	GF_FontCacheEntry **buckets;
+	u32 nb_buckets, count;
+} GF_FontCache;
+
 struct _gf_ft_mgr
 {
 	GF_FontReader *reader;
@@ -41,8 +61,195 @@ struct _gf_ft_mgr
 	u32 id_buffer_size;
 
 	Bool wait_font_load;
+
+	/*shaped spans (glyph IDs) and rasterized span textures*/
+	GF_FontCache shape_cache;
+	GF_FontCache raster_cache;
+	u32 cache_bytes, cache_max_bytes;
+	u32 shape_hits, shape_miss, raster_hits, raster_miss;
 };
 
+/*result of the font reader glyph lookup for a given text*/
+typedef struct
+{
+	GF_FontCacheEntry entry;
+	u32 styles;
+	char *text, *lang;
+	u32 *glyph_ids;
+	u32 nb_glyphs;
+	Bool is_rtl;
+} GF_ShapedSpan;
+
+/*pre-rasterized RGBA coverage of a span, as used by texture text*/
+typedef struct
+{
+	GF_FontCacheEntry entry;
+	u32 flags;
+	u32 *glyph_ids;
+	u32 nb_glyphs;
+	Fixed font_scale, x_scale, y_scale;
+	Fixed width, height, off_x, off_y;
+	u32 tx_width, tx_height;
+	char *data;
+} GF_RasterSpan;
+
+#define FONT_CACHE_MIN_BUCKETS	256
+
+static void font_cache_init(GF_FontCache *cache)
+{
+	memset(cache, 0, sizeof(GF_FontCache));
+	cache->buckets = (GF_FontCacheEntry **)gf_malloc(sizeof(GF_FontCacheEntry *) * FONT_CACHE_MIN_BUCKETS);
+	if (!cache->buckets) return;
+	memset(cache->buckets, 0, sizeof(GF_FontCacheEntry *) * FONT_CACHE_MIN_BUCKETS);
+	cache->nb_buckets = FONT_CACHE_MIN_BUCKETS;
+}
+
+/*returns the first entry of the hash bucket for the given crc*/
+static GF_FontCacheEntry *font_cache_bucket(GF_FontCache *cache, u32 crc)
+{
+	if (!cache->nb_buckets) return NULL;
+	return cache->buckets[crc & (cache->nb_buckets-1)];
+}
+
+/*doubles the number of buckets, keeping less than two entries per bucket on average*/
+static void font_cache_grow(GF_FontCache *cache)
+{
+	u32 i, nb_buckets = 2 * cache->nb_buckets;
+	GF_FontCacheEntry **buckets = (GF_FontCacheEntry **)gf_malloc(sizeof(GF_FontCacheEntry *) * nb_buckets);
+	if (!buckets) return;
+	memset(buckets, 0, sizeof(GF_FontCacheEntry *) * nb_buckets);
+	for (i=0; i<cache->nb_buckets; i++) {
+		GF_FontCacheEntry *e = cache->buckets[i];
+		while (e) {
+			GF_FontCacheEntry *next = e->hash_next;
+			u32 idx = e->crc & (nb_buckets-1);
+			e->hash_next = buckets[idx];
+			buckets[idx] = e;
+			e = next;
+		}
+	}
+	gf_free(cache->buckets);
+	cache->buckets = buckets;
+	cache->nb_buckets = nb_buckets;
+}
+
+/*inserts a new entry as most recently used*/
+static void font_cache_insert(GF_FontCache *cache, GF_FontCacheEntry *e)
+{
+	u32 idx;
+	if (cache->count >= 2 * cache->nb_buckets) font_cache_grow(cache);
+	idx = e->crc & (cache->nb_buckets-1);
+	e->hash_next = cache->buckets[idx];
+	cache->buckets[idx] = e;
+
+	e->next = NULL;
+	e->prev = cache->tail;
+	if (cache->tail) cache->tail->next = e;
+	else cache->head = e;
+	cache->tail = e;
+	cache->count++;
+}
+
+static void font_cache_unlink(GF_FontCache *cache, GF_FontCacheEntry *e)
+{
+	if (e->prev) e->prev->next = e->next;
+	else cache->head = e->next;
+	if (e->next) e->next->prev = e->prev;
+	else cache->tail = e->prev;
+	e->prev = e->next = NULL;
+}
+
+static void font_cache_remove(GF_FontCache *cache, GF_FontCacheEntry *e)
+{
+	GF_FontCacheEntry **prev = &cache->buckets[e->crc & (cache->nb_buckets-1)];
+	while (*prev) {
+		if (*prev == e) {
+			*prev = e->hash_next;
+			break;
+		}
+		prev = &(*prev)->hash_next;
+	}
+	e->hash_next = NULL;
+	font_cache_unlink(cache, e);
+	cache->count--;
+}
+
+/*moves an entry to most recently used*/
+static void font_cache_touch(GF_FontCache *cache, GF_FontCacheEntry *e)
+{
+	if (cache->tail == e) return;
+	font_cache_unlink(cache, e);
+	e->prev = cache->tail;
+	cache->tail->next = e;
+	cache->tail = e;
+}
+
+static void font_cache_del_shape(GF_ShapedSpan *ss)
+{
+	gf_free(ss->text);
+	if (ss->lang) gf_free(ss->lang);
+	if (ss->glyph_ids) gf_free(ss->glyph_ids);
+	gf_free(ss);
+}
+
+static void font_cache_del_raster(GF_RasterSpan *rs)
+{
+	gf_free(rs->glyph_ids);
+	gf_free(rs->data);
+	gf_free(rs);
+}
+
+/*evicts least recently used entries, rasterized spans first, until size bytes fit in the cache*/
+static Bool font_cache_make_room(GF_FontManager *fm, u32 size)
+{
+	if (size > fm->cache_max_bytes) return GF_FALSE;
+	while (fm->cache_bytes + size > fm->cache_max_bytes) {
+		GF_FontCacheEntry *e;
+		if ((e = fm->raster_cache.head)) {
+			font_cache_remove(&fm->raster_cache, e);
+			fm->cache_bytes -= e->size;
+			font_cache_del_raster((GF_RasterSpan *)e);
+		} else if ((e = fm->shape_cache.head)) {
+			font_cache_remove(&fm->shape_cache, e);
+			fm->cache_bytes -= e->size;
+			font_cache_del_shape((GF_ShapedSpan *)e);
+		} else {
+			return GF_FALSE;
+		}
+	}
+	return GF_TRUE;
+}
+
+/*removes all cache entries for the given font, or all entries if font is NULL*/
+static void font_cache_purge(GF_FontManager *fm, GF_Font *font)
+{
+	GF_FontCacheEntry *e, *next;
+	if (!fm) return;
+	for (e = fm->shape_cache.head; e; e = next) {
+		next = e->next;
+		if (font && (e->font != font)) continue;
+		font_cache_remove(&fm->shape_cache, e);
+		fm->cache_bytes -= e->size;
+		font_cache_del_shape((GF_ShapedSpan *)e);
+	}
+	for (e = fm->raster_cache.head; e; e = next) {
+		next = e->next;
+		if (font && (e->font != font)) continue;
+		font_cache_remove(&fm->raster_cache, e);
+		fm->cache_bytes -= e->size;
+		font_cache_del_raster((GF_RasterSpan *)e);
+	}
+}
+
+void gf_font_manager_get_cache_stats(GF_FontManager *fm, u32 *shape_hits, u32 *shape_miss, u32 *raster_hits, u32 *raster_miss, u32 *bytes_used)
+{
+	if (shape_hits) *shape_hits = fm->shape_hits;
+	if (shape_miss) *shape_miss = fm->shape_miss;
+	if (raster_hits) *raster_hits = fm->raster_hits;
+	if (raster_miss) *raster_miss = fm->raster_miss;
+	if (bytes_used) *bytes_used = fm->cache_bytes;
+}
+
 
 GF_FontManager *gf_font_manager_new(GF_User *user)
 {
@@ -100,6 +307,16 @@ GF_FontManager *gf_font_manager_new(GF_User *user)
 	if (!opt) gf_cfg_set_key(user->config, "FontEngine", "WaitForFontLoad", "no");
 	if (opt && !strcmp(opt, "yes")) font_mgr->wait_font_load = 1;
 
+	/*text cache size in kilobytes, 0 disables the cache*/
+	opt = gf_cfg_get_key(user->config, "FontEngine", "TextCacheSize");
+	if (!opt) {
+		gf_cfg_set_key(user->config, "FontEngine", "TextCacheSize", "2048");
+		opt = "2048";
+	}
+	font_mgr->cache_max_bytes = 1024 * atoi(opt);
+	font_cache_init(&font_mgr->shape_cache);
+	font_cache_init(&font_mgr->raster_cache);
+
 	return font_mgr;
 }
 
@@ -149,6 +366,12 @@ void gf_font_manager_del(GF_FontManager *fm)
 		gf_font_del(font);
 		font = next;
 	}
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_COMPOSE, ("[Compositor] Text cache: %d/%d shaped span hits/misses - %d/%d rasterized span hits/misses - %d bytes used\n", fm->shape_hits, fm->shape_miss, fm->raster_hits, fm->raster_miss, fm->cache_bytes));
+	font_cache_purge(fm, NULL);
+	if (fm->shape_cache.buckets) gf_free(fm->shape_cache.buckets);
+	if (fm->raster_cache.buckets) gf_free(fm->raster_cache.buckets);
+
 	gf_free(fm->id_buffer);
 	gf_path_del(fm->line_path);
 	gf_free(fm);
@@ -184,6 +407,7 @@ GF_Err gf_font_manager_unregister_font(GF_FontManager *fm, GF_Font *font)
 	} else {
 		fm->font = font->next;
 	}
+	font_cache_purge(fm, font);
 	gf_font_predestroy(font);
 	return GF_OK;
 }
@@ -395,32 +619,97 @@ static GF_Glyph *gf_font_get_glyph(GF_FontManager *fm, GF_Font *font, u32 name)
 }
 
 
+/*only spans laid out by the font reader are cached, embedded fonts (SVG) may change their glyphs while loading*/
+static GF_ShapedSpan *font_cache_get_shape(GF_FontManager *fm, GF_Font *font, const char *text, const char *xml_lang, u32 styles)
+{
+	u32 crc;
+	GF_FontCacheEntry *e;
+	if (!fm->cache_max_bytes || font->get_glyphs) return NULL;
+
+	crc = gf_crc_32(text, (u32) strlen(text));
+	for (e = font_cache_bucket(&fm->shape_cache, crc); e; e = e->hash_next) {
+		GF_ShapedSpan *ss = (GF_ShapedSpan *)e;
+		if ((e->crc != crc) || (e->font != font) || (ss->styles != styles)) continue;
+		if (strcmp(ss->text, text)) continue;
+		if ((ss->lang || xml_lang) && (!ss->lang || !xml_lang || strcmp(ss->lang, xml_lang))) continue;
+		font_cache_touch(&fm->shape_cache, e);
+		fm->shape_hits++;
+		return ss;
+	}
+	fm->shape_miss++;
+	return NULL;
+}
+
+static void font_cache_add_shape(GF_FontManager *fm, GF_Font *font, const char *text, const char *xml_lang, u32 styles, u32 *glyph_ids, u32 nb_glyphs, Bool is_rtl)
+{
+	GF_ShapedSpan *ss;
+	u32 size, text_len;
+	if (!fm->cache_max_bytes || font->get_glyphs || !fm->shape_cache.nb_buckets) return;
+
+	text_len = (u32) strlen(text);
+	size = sizeof(GF_ShapedSpan) + text_len + 1 + sizeof(u32)*nb_glyphs;
+	if (xml_lang) size += (u32) strlen(xml_lang) + 1;
+	if (!font_cache_make_room(fm, size)) return;
+
+	GF_SAFEALLOC(ss, GF_ShapedSpan);
+	if (!ss) return;
+	ss->entry.font = font;
+	ss->entry.crc = gf_crc_32(text, text_len);
+	ss->styles = styles;
+	ss->text = gf_strdup(text);
+	if (xml_lang) ss->lang = gf_strdup(xml_lang);
+	if (nb_glyphs) {
+		ss->glyph_ids = gf_malloc(sizeof(u32)*nb_glyphs);
+		memcpy(ss->glyph_ids, glyph_ids, sizeof(u32)*nb_glyphs);
+	}
+	ss->nb_glyphs = nb_glyphs;
+	ss->is_rtl = is_rtl;
+	ss->entry.size = size;
+	font_cache_insert(&fm->shape_cache, &ss->entry);
+	fm->cache_bytes += size;
+}
+
 GF_TextSpan *gf_font_manager_create_span(GF_FontManager *fm, GF_Font *font, char *text, Fixed font_size, Bool needs_x_offset, Bool needs_y_offset, Bool needs_rotate, const char *xml_lang, Bool fliped_text, u32 styles, GF_Node *user)
 {
 	GF_Err e;
 	Bool is_rtl;
 	u32 len, i;
 	GF_TextSpan *span;
+	GF_ShapedSpan *shaped;
 
 	if (!strlen(text)) return NULL;
 
-	len = fm->id_buffer_size;
-	if (font->get_glyphs)
-		e = font->get_glyphs(font->udta, text, fm->id_buffer, &len, xml_lang, &is_rtl);
-	else
-		e = fm->reader->get_glyphs(fm->reader, text, fm->id_buffer, &len, xml_lang, &is_rtl);
-
-	if (e==GF_BUFFER_TOO_SMALL) {
-		fm->id_buffer_size = len;
-		fm->id_buffer = gf_realloc(fm->id_buffer, sizeof(u32) * len);
-		if (!fm->id_buffer) return NULL;
-
+	is_rtl = GF_FALSE;
+	shaped = font_cache_get_shape(fm, font, text, xml_lang, styles);
+	if (shaped) {
+		len = shaped->nb_glyphs;
+		if (len > fm->id_buffer_size) {
+			fm->id_buffer_size = len;
+			fm->id_buffer = gf_realloc(fm->id_buffer, sizeof(u32) * len);
+			if (!fm->id_buffer) return NULL;
+		}
+		memcpy(fm->id_buffer, shaped->glyph_ids, sizeof(u32) * len);
+		is_rtl = shaped->is_rtl;
+	} else {
+		len = fm->id_buffer_size;
 		if (font->get_glyphs)
 			e = font->get_glyphs(font->udta, text, fm->id_buffer, &len, xml_lang, &is_rtl);
 		else
 			e = fm->reader->get_glyphs(fm->reader, text, fm->id_buffer, &len, xml_lang, &is_rtl);
+
+		if (e==GF_BUFFER_TOO_SMALL) {
+			fm->id_buffer_size = len;
+			fm->id_buffer = gf_realloc(fm->id_buffer, sizeof(u32) * len);
+			if (!fm->id_buffer) return NULL;
+
+			if (font->get_glyphs)
+				e = font->get_glyphs(font->udta, text, fm->id_buffer, &len, xml_lang, &is_rtl);
+			else
+				e = fm->reader->get_glyphs(fm->reader, text, fm->id_buffer, &len, xml_lang, &is_rtl);
+		}
+		if (e) return NULL;
+		font_cache_add_shape(fm, font, text, xml_lang, styles, fm->id_buffer, len, is_rtl);
 	}
-	if (e) return NULL;
 
 	GF_SAFEALLOC(span, GF_TextSpan);
 	if (!span) return NULL;
@@ -664,6 +953,78 @@ static void span_build_mesh(GF_TextSpan *span)
 /*and don't build too small ones otherwise result is as crap as non-textured*/
 #define MIN_TX_SIZE		32
 
+/*builds the glyph key of a span for the raster cache - returns 0 if the span cannot be cached*/
+static u32 span_get_raster_key(GF_FontManager *fm, GF_TextSpan *span)
+{
+	u32 i;
+	if (!fm || !fm->cache_max_bytes || span->font->get_glyphs) return 0;
+	/*per-glyph positioning is usually animated (SVG), don't cache*/
+	if (span->dx || span->dy || span->rot) return 0;
+	if (!span->nb_glyphs) return 0;
+
+	if (span->nb_glyphs > fm->id_buffer_size) {
+		fm->id_buffer_size = span->nb_glyphs;
+		fm->id_buffer = gf_realloc(fm->id_buffer, sizeof(u32) * span->nb_glyphs);
+		if (!fm->id_buffer) return 0;
+	}
+	for (i=0; i<span->nb_glyphs; i++) {
+		fm->id_buffer[i] = span->glyphs[i] ? span->glyphs[i]->ID : 0;
+	}
+	return gf_crc_32((char *) fm->id_buffer, sizeof(u32) * span->nb_glyphs);
+}
+
+static GF_RasterSpan *span_get_cached_raster(GF_FontManager *fm, GF_TextSpan *span, u32 crc, GF_Rect *bounds, u32 width, u32 height)
+{
+	GF_FontCacheEntry *e;
+	for (e = font_cache_bucket(&fm->raster_cache, crc); e; e = e->hash_next) {
+		GF_RasterSpan *rs = (GF_RasterSpan *)e;
+		if ((e->crc != crc) || (e->font != span->font) || (rs->nb_glyphs != span->nb_glyphs)) continue;
+		if ((rs->tx_width != width) || (rs->tx_height != height) || (rs->flags != span->flags)) continue;
+		if ((rs->font_scale != span->font_scale) || (rs->x_scale != span->x_scale) || (rs->y_scale != span->y_scale)) continue;
+		if ((rs->width != bounds->width) || (rs->height != bounds->height)) continue;
+		if ((rs->off_x != span->off_x - bounds->x) || (rs->off_y != span->off_y - bounds->y)) continue;
+		if (memcmp(rs->glyph_ids, fm->id_buffer, sizeof(u32) * span->nb_glyphs)) continue;
+
+		font_cache_touch(&fm->raster_cache, e);
+		fm->raster_hits++;
+		return rs;
+	}
+	fm->raster_miss++;
+	return NULL;
+}
+
+static void span_add_cached_raster(GF_FontManager *fm, GF_TextSpan *span, u32 crc, GF_Rect *bounds, GF_TextureHandler *txh)
+{
+	GF_RasterSpan *rs;
+	u32 data_size = txh->stride * txh->height;
+	u32 size = sizeof(GF_RasterSpan) + data_size + sizeof(u32) * span->nb_glyphs;
+	if (!fm->raster_cache.nb_buckets) return;
+	if (!font_cache_make_room(fm, size)) return;
+
+	GF_SAFEALLOC(rs, GF_RasterSpan);
+	if (!rs) return;
+	rs->entry.font = span->font;
+	rs->entry.crc = crc;
+	rs->flags = span->flags;
+	rs->nb_glyphs = span->nb_glyphs;
+	rs->glyph_ids = gf_malloc(sizeof(u32) * span->nb_glyphs);
+	memcpy(rs->glyph_ids, fm->id_buffer, sizeof(u32) * span->nb_glyphs);
+	rs->font_scale = span->font_scale;
+	rs->x_scale = span->x_scale;
+	rs->y_scale = span->y_scale;
+	rs->width = bounds->width;
+	rs->height = bounds->height;
+	rs->off_x = span->off_x - bounds->x;
+	rs->off_y = span->off_y - bounds->y;
+	rs->tx_width = txh->width;
+	rs->tx_height = txh->height;
+	rs->data = gf_malloc(sizeof(char) * data_size);
+	memcpy(rs->data, txh->data, sizeof(char) * data_size);
+	rs->entry.size = size;
+	font_cache_insert(&fm->raster_cache, &rs->entry);
+	fm->cache_bytes += size;
+}
+
 static Bool span_setup_texture(GF_Compositor *compositor, GF_TextSpan *span, Bool for_3d, GF_TraverseState *tr_state)
 {
 	GF_Path *span_path;
@@ -675,6 +1036,8 @@ static Bool span_setup_texture(GF_Compositor *compositor, GF_TextSpan *span, Boo
 	GF_SURFACE surface;
 	u32 width, height;
 	Fixed scale;
+	u32 cache_crc;
+	GF_RasterSpan *cached;
 	GF_Raster2D *raster = compositor->rasterizer;
 
 	span_alloc_extensions(span);
@@ -756,37 +1119,48 @@ static Bool span_setup_texture(GF_Compositor *compositor, GF_TextSpan *span, Boo
 	span->ext->txh->transparent = 1;
 	span->ext->txh->flags |= GF_SR_TEXTURE_NO_GL_FLIP;
 
-	surface = raster->surface_new(raster, 1);
-	if (!surface) {
-		gf_sc_texture_release(span->ext->txh);
-		return 0;
-	}
-	span->ext->txh->data = (char *) gf_malloc(sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
-	memset(span->ext->txh->data, 0, sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
+	cache_crc = span_get_raster_key(compositor->font_manager, span);
+	cached = cache_crc ? span_get_cached_raster(compositor->font_manager, span, cache_crc, &bounds, width, height) : NULL;
 
-	raster->stencil_set_texture(stencil, span->ext->txh->data, span->ext->txh->width, span->ext->txh->height, span->ext->txh->stride, span->ext->txh->pixelformat, span->ext->txh->pixelformat, 1);
-	raster->surface_attach_to_texture(surface, stencil);
+	if (cached) {
+		span->ext->txh->data = (char *) gf_malloc(sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
+		memcpy(span->ext->txh->data, cached->data, sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
+		raster->stencil_set_texture(stencil, span->ext->txh->data, span->ext->txh->width, span->ext->txh->height, span->ext->txh->stride, span->ext->txh->pixelformat, span->ext->txh->pixelformat, 1);
+	} else {
+		surface = raster->surface_new(raster, 1);
+		if (!surface) {
+			gf_sc_texture_release(span->ext->txh);
+			return 0;
+		}
+		span->ext->txh->data = (char *) gf_malloc(sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
+		memset(span->ext->txh->data, 0, sizeof(char)*span->ext->txh->stride*span->ext->txh->height);
+
+		raster->stencil_set_texture(stencil, span->ext->txh->data, span->ext->txh->width, span->ext->txh->height, span->ext->txh->stride, span->ext->txh->pixelformat, span->ext->txh->pixelformat, 1);
+		raster->surface_attach_to_texture(surface, stencil);
 
-	brush = raster->stencil_new(raster, GF_STENCIL_SOLID);
-	raster->stencil_set_brush_color(brush, 0xFF000000);
+		brush = raster->stencil_new(raster, GF_STENCIL_SOLID);
+		raster->stencil_set_brush_color(brush, 0xFF000000);
 
-	cx = bounds.x + bounds.width/2;
-	cy = bounds.y - bounds.height/2;
+		cx = bounds.x + bounds.width/2;
+		cy = bounds.y - bounds.height/2;
 
-	gf_mx2d_init(mx);
-	gf_mx2d_add_translation(&mx, -cx, -cy);
-	gf_mx2d_add_scale(&mx, sx, sy);
-//	gf_mx2d_add_scale(&mx, 99*FIX_ONE/100, 99*FIX_ONE/100);
+		gf_mx2d_init(mx);
+		gf_mx2d_add_translation(&mx, -cx, -cy);
+		gf_mx2d_add_scale(&mx, sx, sy);
+//		gf_mx2d_add_scale(&mx, 99*FIX_ONE/100, 99*FIX_ONE/100);
 
-	raster->surface_set_matrix(surface, &mx);
-	raster->surface_set_raster_level(surface, GF_RASTER_HIGH_QUALITY);
-	span_path = gf_font_span_create_path(span);
-	raster->surface_set_path(surface, span_path);
+		raster->surface_set_matrix(surface, &mx);
+		raster->surface_set_raster_level(surface, GF_RASTER_HIGH_QUALITY);
+		span_path = gf_font_span_create_path(span);
+		raster->surface_set_path(surface, span_path);
 
-	raster->surface_fill(surface, brush);
-	raster->stencil_delete(brush);
-	raster->surface_delete(surface);
-	gf_path_del(span_path);
+		raster->surface_fill(surface, brush);
+		raster->stencil_delete(brush);
+		raster->surface_delete(surface);
+		gf_path_del(span_path);
+
+		if (cache_crc) span_add_cached_raster(compositor->font_manager, span, cache_crc, &bounds, span->ext->txh);
+	}
 
 	if (span->font->baseline) {
 		Fixed dy = gf_mulfix(span->font->baseline, span->font_scale);
@@ -45,6 +45,10 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_sys_get_argc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sys_get_arg) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_sleep) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_arena_new) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_arena_del) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_arena_reset) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_arena_alloc) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_mkdir) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rmdir) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_dir_exists) )
@@ -67,6 +71,11 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_set_strict_error) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_set_callback) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_get_tools_levels) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_start) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_stop) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_is_on) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_event) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_trace_dump) )
 
 #ifndef GPAC_DISABLE_LOG
 #pragma comment (linker, EXPORT_SYMBOL(gf_log_tool_level_on) )
@@ -231,6 +240,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_th_status) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_th_set_priority) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_th_id) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_th_name) )
 
 /* Lock */
 #pragma comment (linker, EXPORT_SYMBOL(gf_mx_new) )
@@ -311,6 +321,8 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_remove) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_save) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_key) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_key_handle) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_key_by_handle) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_sub_key) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_set_key) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_cfg_get_section_count) )
@@ -675,6 +687,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_last_error) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_probe_file) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_open) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_fragment_parser_threads) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_close) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_delete) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_mode) )
@@ -734,6 +747,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_set_sample_padding) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_info) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_run) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_flags) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_for_media_time) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_isom_get_sample_for_movie_time) )
@@ -1266,6 +1280,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_init) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_process_ref) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_format_sdp) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_builder_get_payload_name) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_depacketizer_new) )
@@ -1278,6 +1293,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_reset) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_add) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_rtp_reorderer_get_ex) )
 
 #endif /*GPAC_DISABLE_STREAMING*/
 
@@ -1299,6 +1315,7 @@
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_new) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_del) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_process) )
+#pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_process_parallel) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_finalize) )
 #pragma comment (linker, EXPORT_SYMBOL(gf_hinter_track_get_bandwidth) )
@@ -335,7 +335,7 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
 {
 	GF_Err e;
 	u32 seq_num, res;
-	char *pck;
+	const char *pck;
 
 	//only if the socket exist (otherwise RTSP interleaved channel)
 	if (!ch || !ch->rtp) return 0;
@@ -348,16 +348,17 @@ u32 gf_rtp_read_rtp(GF_RTPChannel *ch, char *buffer, u32 buffer_size)
 	}
 	//add the packet to our Queue if any
 	if (ch->po) {
-		if (res) {
-			seq_num = ((buffer[2] << 8) & 0xFF00) | (buffer[3] & 0xFF);
-			gf_rtp_reorderer_add(ch->po, (void *) buffer, res, seq_num);
-		}
+		seq_num = res ? ((buffer[2] << 8) & 0xFF00) | (buffer[3] & 0xFF) : 0;
+		//in-order packet and nothing queued, no need to go through the queue
+		if (res && !ch->po->Count && ch->po->IsInit && (seq_num == ch->po->head_seqnum)) {
+			ch->po->head_seqnum = (seq_num + 1) & 0xFFFF;
+			ch->po->LastTime = 0;
+		} else {
+			if (res) gf_rtp_reorderer_add(ch->po, (void *) buffer, res, seq_num);
 
-		//pck queue may need to be flushed
-		pck = (char *) gf_rtp_reorderer_get(ch->po, &res);
-		if (pck) {
-			memcpy(buffer, pck, res);
-			gf_free(pck);
+			//pck queue may need to be flushed
+			pck = gf_rtp_reorderer_get_ex(ch->po, &res);
+			if (pck) memcpy(buffer, pck, res);
 		}
 	}
 	/*monitor keep-alive period*/
@@ -775,6 +776,8 @@ void gf_rtp_get_ports(GF_RTPChannel *ch, u16 *rtp_port, u16 *rtcp_port)
 */
 
 #define SN_CHECK_OFFSET		0x0A
+/*minimal size of a slot buffer, so that slots are not reallocated for each packet size change*/
+#define SLOT_MIN_SIZE		1500
 
 GF_EXPORT
 GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
@@ -787,24 +790,35 @@ GF_RTPReorder *gf_rtp_reorderer_new(u32 MaxCount, u32 MaxDelay)
 	if (!tmp) return NULL;
 	tmp->MaxCount = MaxCount;
 	tmp->MaxDelay = MaxDelay;
+	/*the ring covers twice the max queue size so that a full queue never wraps*/
+	tmp->nb_slots = 16;
+	while (tmp->nb_slots < 2*MaxCount) tmp->nb_slots *= 2;
+	if (tmp->nb_slots > 0x8000) tmp->nb_slots = 0x8000;
+	tmp->slots = (GF_POItem *) gf_malloc(sizeof(GF_POItem) * tmp->nb_slots);
+	if (!tmp->slots) {
+		gf_free(tmp);
+		return NULL;
+	}
+	memset(tmp->slots, 0, sizeof(GF_POItem) * tmp->nb_slots);
 	return tmp;
 }
 
-static void DelItem(GF_POItem *it)
+GF_EXPORT
+void gf_rtp_reorderer_del(GF_RTPReorder *po)
 {
-	if (it) {
-		if (it->next) DelItem(it->next);
-		gf_free(it->pck);
-		gf_free(it);
+	u32 i;
+	for (i=0; i<po->nb_slots; i++) {
+		if (po->slots[i].pck) gf_free(po->slots[i].pck);
 	}
+	gf_free(po->slots);
+	gf_free(po);
 }
 
-
-GF_EXPORT
-void gf_rtp_reorderer_del(GF_RTPReorder *po)
+static void reorderer_flush_slots(GF_RTPReorder *po)
 {
-	if (po->in) DelItem(po->in);
-	gf_free(po);
+	u32 i;
+	for (i=0; i<po->nb_slots; i++) po->slots[i].used = GF_FALSE;
+	po->Count = 0;
 }
 
 GF_EXPORT
@@ -812,170 +826,144 @@ void gf_rtp_reorderer_reset(GF_RTPReorder *po)
 {
 	if (!po) return;
 
-	if (po->in) DelItem(po->in);
+	/*slot buffers are kept for the next packets*/
+	reorderer_flush_slots(po);
 	po->head_seqnum = 0;
-	po->Count = 0;
 	po->IsInit = 0;
-	po->in = NULL;
+	po->LastTime = 0;
 }
 
 GF_EXPORT
 GF_Err gf_rtp_reorderer_add(GF_RTPReorder *po, const void * pck, u32 pck_size, u32 pck_seqnum)
 {
-	GF_POItem *it, *cur;
-	u32 bounds;
+	GF_POItem *it;
+	u32 diff, mask;
 
 	if (!po) return GF_BAD_PARAM;
 
-	it = (GF_POItem *) gf_malloc(sizeof(GF_POItem));
-	it->pck_seq_num = pck_seqnum;
-	it->next = NULL;
-	it->size = pck_size;
-	it->pck = gf_malloc(pck_size);
-	memcpy(it->pck, pck, pck_size);
-	/*reset timeout*/
-	po->LastTime = 0;
-
-	//no input, this packet will be the input
-	if (!po->in) {
-		//the seq num was not initialized
-		if (!po->head_seqnum) {
-			po->head_seqnum = pck_seqnum;
-		} else if (!po->IsInit) {
-			//this is not in our current range for init
-			if (ABSDIFF(po->head_seqnum, pck_seqnum) > SN_CHECK_OFFSET) goto discard;
-			po->IsInit = 1;
-		}
-
-		po->in = it;
-		po->Count += 1;
-		return GF_OK;
-	}
-
-	//this is 16 bitr seq num, as we work with RTP only for now
-	bounds = 0;
-	if ( (po->head_seqnum >= 0xf000 ) || (po->head_seqnum <= 0x1000) ) bounds = 0x2000;
+	//this is 16 bit seq num, as we work with RTP only for now
+	pck_seqnum &= 0xFFFF;
+	mask = po->nb_slots - 1;
 
-	//first check the head of the list
-	//same seq num, we drop
-	if (po->in->pck_seq_num == pck_seqnum) goto discard;
-
-	if ( ( (u16) (pck_seqnum + bounds) <= (u16) (po->in->pck_seq_num + bounds) ) ) {
-
-		it->next = po->in;
-		po->in = it;
-		po->Count += 1;
-
-		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: inserting packet %d at head\n", pck_seqnum));
-		return GF_OK;
-	}
+	//first packet, this will be the head
+	if (!po->IsInit && !po->Count) po->head_seqnum = pck_seqnum;
 
-	//no, insert at the right place
-	cur = po->in;
+	diff = (u16) (pck_seqnum - po->head_seqnum);
 
-	while (1) {
-		//same seq num, we drop
-		if (cur->pck_seq_num == pck_seqnum) goto discard;
-
-		//end of list
-		if (!cur->next) {
-			cur->next = it;
-			po->Count += 1;
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Appending packet %d (last %d)\n", pck_seqnum, cur->pck_seq_num));
-			return GF_OK;
+	//late packet, older than the head but within the reordering window
+	if ((diff >= 0x8000) && (0x10000 - diff <= po->MaxCount)) {
+		u32 i, nb_back = 0x10000 - diff;
+		//nothing sent yet, a packet slightly older than the first received one becomes the head
+		if (po->IsInit || (nb_back > SN_CHECK_OFFSET)) goto discard;
+		for (i=0; i<nb_back; i++) {
+			if (po->slots[(pck_seqnum + i) & mask].used) goto discard;
 		}
+		po->head_seqnum = pck_seqnum;
+	}
+	//packet too far ahead, or too far behind to be a late one (sender restart, backward jump):
+	//we lost sync, restart from this packet
+	else if (diff >= po->nb_slots) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_RTP, ("[rtp] Packet Reorderer: sequence number jump from %d to %d - flushing %d packets\n", po->head_seqnum, pck_seqnum, po->Count));
+		reorderer_flush_slots(po);
+		po->head_seqnum = pck_seqnum;
+		po->LastTime = 0;
+	}
 
-		//are we in the bounds ??
-		if ( ( (u16) (cur->pck_seq_num + bounds) < (u16) (pck_seqnum + bounds) )
-		        && ( (u16) (pck_seqnum + bounds) < (u16) (cur->next->pck_seq_num + bounds)) ) {
-
-			//insert
-			it->next = cur->next;
-			cur->next = it;
-			po->Count += 1;
-
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Inserting packet %d\n", pck_seqnum));
-			//done
-			return GF_OK;
+	it = &po->slots[pck_seqnum & mask];
+	//same seq num, we drop
+	if (it->used) goto discard;
+
+	if (it->alloc_size < pck_size) {
+		it->alloc_size = MAX(pck_size, SLOT_MIN_SIZE);
+		it->pck = (char *) gf_realloc(it->pck, it->alloc_size);
+		if (!it->pck) {
+			it->alloc_size = 0;
+			return GF_OUT_OF_MEM;
 		}
-		cur = cur->next;
 	}
-
+	memcpy(it->pck, pck, pck_size);
+	it->size = pck_size;
+	it->pck_seq_num = pck_seqnum;
+	it->used = GF_TRUE;
+	po->Count += 1;
+	return GF_OK;
 
 discard:
-	gf_free(it->pck);
-	gf_free(it);
 	GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[rtp] Packet Reorderer: Dropping packet %d\n", pck_seqnum));
 	return GF_OK;
 }
 
-//retrieve the first available packet. Note that the behavior will be undefined if the first
-//ever received packet if its SeqNum was unknown
-//the BUFFER is yours, you must delete it
+//retrieve the first available packet. The packet data is owned by the reorderer
 GF_EXPORT
-void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+const char *gf_rtp_reorderer_get_ex(GF_RTPReorder *po, u32 *pck_size)
 {
-	GF_POItem *t;
-	u32 bounds;
-	void *ret;
+	GF_POItem *it;
+	u32 mask;
 
 	if (!po || !pck_size) return NULL;
 
 	*pck_size = 0;
 
 	//empty queue
-	if (!po->in) return NULL;
-
-	//check we have received the first packet
-	if ( po->head_seqnum && po->MaxCount
-	        && (po->MaxCount > po->Count)
-	        && (po->in->pck_seq_num != po->head_seqnum))
-		return NULL;
+	if (!po->Count) return NULL;
 
-	//no entry
-	if (!po->in->next) goto check_timeout;
+	mask = po->nb_slots - 1;
+	it = &po->slots[po->head_seqnum & mask];
 
-	bounds = 0;
-	if ( (po->head_seqnum >= 0xf000 ) || (po->head_seqnum <= 0x1000) ) bounds = 0x2000;
-
-	//release the output if SN in order or maxCount reached
-	if (( (u16) (po->in->pck_seq_num + bounds + 1) == (u16) (po->in->next->pck_seq_num + bounds))
-	        || (po->MaxCount && (po->Count >= po->MaxCount)) ) {
-
-#ifndef GPAC_DISABLE_LOG
-		if (po->in->pck_seq_num + 1 != po->in->next->pck_seq_num)
-			GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[rtp] WARNING Packet Loss: Sending %d out of the queue but next is %d\n", po->in->pck_seq_num, po->in->next->pck_seq_num ));
-#endif
-		goto send_it;
+	if (it->used) {
+		//release the head if in order. Until the first packet is sent, wait for the next one
+		//to make sure the first received packet is the first one sent
+		if (po->IsInit || po->slots[(po->head_seqnum + 1) & mask].used || (po->Count >= po->MaxCount))
+			goto send_it;
+	}
+	//missing packet, release the next one if maxCount reached
+	else if (po->Count >= po->MaxCount) {
+		goto skip_missing;
 	}
+
 	//update timing
-	else {
-check_timeout:
-		if (!po->LastTime) {
-			po->LastTime = gf_sys_clock();
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: starting timeout at %d\n", po->LastTime));
-			return NULL;
-		}
-		//if exceeding the delay send the head
-		if (gf_sys_clock() - po->LastTime >= po->MaxDelay) {
-			GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Forcing output after %d ms wait (max allowed %d)\n", gf_sys_clock() - po->LastTime, po->MaxDelay));
-			goto send_it;
+	if (!po->LastTime) {
+		po->LastTime = gf_sys_clock();
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: starting timeout at %d\n", po->LastTime));
+		return NULL;
+	}
+	//if exceeding the delay send the first available packet
+	if (gf_sys_clock() - po->LastTime < po->MaxDelay) return NULL;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Forcing output after %d ms wait (max allowed %d)\n", gf_sys_clock() - po->LastTime, po->MaxDelay));
+
+skip_missing:
+	if (!it->used) {
+		u32 first_lost = po->head_seqnum;
+		//the queue is not empty, we will find a packet in the ring
+		while (!it->used) {
+			po->head_seqnum = (po->head_seqnum + 1) & 0xFFFF;
+			it = &po->slots[po->head_seqnum & mask];
 		}
+		GF_LOG(GF_LOG_INFO, GF_LOG_RTP, ("[rtp] WARNING Packet Loss: Sending %d out of the queue but expected %d\n", po->head_seqnum, first_lost));
 	}
-	return NULL;
-
 
 send_it:
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Fetching %d\n", po->in->pck_seq_num));
-	*pck_size = po->in->size;
-	t = po->in;
-	po->in = po->in->next;
-	//no other output. reset the head seqnum
-	po->head_seqnum = po->in ? po->in->pck_seq_num : 0;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_RTP, ("[rtp] Packet Reorderer: Fetching %d\n", it->pck_seq_num));
+	it->used = GF_FALSE;
 	po->Count -= 1;
-	//release the item
-	ret = t->pck;
-	gf_free(t);
+	po->head_seqnum = (po->head_seqnum + 1) & 0xFFFF;
+	po->IsInit = 1;
+	po->LastTime = 0;
+	*pck_size = it->size;
+	return it->pck;
+}
+
+//retrieve the first available packet
+//the BUFFER is yours, you must delete it
+GF_EXPORT
+void *gf_rtp_reorderer_get(GF_RTPReorder *po, u32 *pck_size)
+{
+	char *ret;
+	const char *pck = gf_rtp_reorderer_get_ex(po, pck_size);
+	if (!pck) return NULL;
+	ret = (char *) gf_malloc(sizeof(char) * (*pck_size));
+	if (ret) memcpy(ret, pck, *pck_size);
 	return ret;
 }
 
@@ -582,17 +582,33 @@ static void gf_rtp_parse_ttxt(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, char *
 	gf_bs_del(bs);
 }
 
+/*appends data to the NAL reassembly buffer, growing it if needed*/
+static Bool gf_rtp_nal_buf_append(GF_RTPDepacketizer *rtp, const char *data, u32 size)
+{
+	if (rtp->nal_buf_size + size > rtp->nal_buf_alloc) {
+		u32 new_size = rtp->nal_buf_alloc ? rtp->nal_buf_alloc : 4096;
+		while (rtp->nal_buf_size + size > new_size) new_size *= 2;
+		rtp->nal_buf = (char *) gf_realloc(rtp->nal_buf, sizeof(char) * new_size);
+		if (!rtp->nal_buf) {
+			rtp->nal_buf_alloc = rtp->nal_buf_size = 0;
+			return GF_FALSE;
+		}
+		rtp->nal_buf_alloc = new_size;
+	}
+	memcpy(rtp->nal_buf + rtp->nal_buf_size, data, size);
+	rtp->nal_buf_size += size;
+	return GF_TRUE;
+}
+
 static void gf_rtp_h264_flush(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, Bool missed_end)
 {
 	char *data;
 	u32 data_size, nal_s;
-	if (!rtp->inter_bs) return;
+	if (!rtp->nal_buf_size) return;
 
-	data = NULL;
-	data_size = 0;
-	gf_bs_get_content(rtp->inter_bs, &data, &data_size);
-	gf_bs_del(rtp->inter_bs);
-	rtp->inter_bs = NULL;
+	data = rtp->nal_buf;
+	data_size = rtp->nal_buf_size;
+	rtp->nal_buf_size = 0;
 	nal_s = data_size-4;
 
 	if (rtp->flags & GF_RTP_AVC_USE_ANNEX_B) {
@@ -614,7 +630,6 @@ static void gf_rtp_h264_flush(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, Bool m
 	rtp->on_sl_packet(rtp->udta, data, data_size, &rtp->sl_hdr, GF_OK);
 	rtp->sl_hdr.accessUnitStartFlag = 0;
 	rtp->sl_hdr.randomAccessPointFlag = 0;
-	gf_free(data);
 }
 
 void gf_rtp_parse_h264(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, char *payload, u32 size)
@@ -726,20 +741,19 @@ void gf_rtp_parse_h264(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, char *payload
 			return;
 
 		/*setup*/
-		if (!rtp->inter_bs) {
-			u8 nal_hdr;
-			rtp->inter_bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+		if (!rtp->nal_buf_size) {
+			/*dummy size field*/
+			char nal_hdr[5];
+			nal_hdr[0] = nal_hdr[1] = nal_hdr[2] = nal_hdr[3] = 0;
 			/*copy F and NRI*/
-			nal_hdr = payload[0] & 0xE0;
+			nal_hdr[4] = payload[0] & 0xE0;
 			/*start bit not set, signal corrupted data (we missed start packet)*/
-			if (!is_start) nal_hdr |= 0x80;
+			if (!is_start) nal_hdr[4] |= 0x80;
 			/*copy NALU type*/
-			nal_hdr |= (payload[1] & 0x1F);
-			/*dummy size field*/
-			gf_bs_write_u32(rtp->inter_bs, 0);
-			gf_bs_write_u8(rtp->inter_bs, nal_hdr);
+			nal_hdr[4] |= (payload[1] & 0x1F);
+			if (!gf_rtp_nal_buf_append(rtp, nal_hdr, 5)) return;
 		}
-		gf_bs_write_data(rtp->inter_bs, payload+2, size-2);
+		if (!gf_rtp_nal_buf_append(rtp, payload+2, size-2)) return;
 		if (is_end || hdr->Marker) gf_rtp_h264_flush(rtp, hdr, GF_FALSE);
 	}
 }
@@ -750,13 +764,11 @@ static void gf_rtp_hevc_flush(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, Bool m
 {
 	char *data;
 	u32 data_size, nal_s;
-	if (!rtp->inter_bs) return;
+	if (!rtp->nal_buf_size) return;
 
-	data = NULL;
-	data_size = 0;
-	gf_bs_get_content(rtp->inter_bs, &data, &data_size);
-	gf_bs_del(rtp->inter_bs);
-	rtp->inter_bs = NULL;
+	data = rtp->nal_buf;
+	data_size = rtp->nal_buf_size;
+	rtp->nal_buf_size = 0;
 	nal_s = data_size-4;
 
 	data[0] = nal_s>>24;
@@ -773,7 +785,6 @@ static void gf_rtp_hevc_flush(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, Bool m
 	rtp->on_sl_packet(rtp->udta, data, data_size, &rtp->sl_hdr, GF_OK);
 	rtp->sl_hdr.accessUnitStartFlag = 0;
 	rtp->sl_hdr.randomAccessPointFlag = 0;
-	gf_free(data);
 }
 
 static void gf_rtp_parse_hevc(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, char *payload, u32 size)
@@ -869,20 +880,19 @@ static void gf_rtp_parse_hevc(GF_RTPDepacketizer *rtp, GF_RTPHeader *hdr, char *
 		}
 
 		/*setup*/
-		if (!rtp->inter_bs) {
-			char nal_hdr[2];
-			rtp->inter_bs = gf_bs_new(NULL, 0, GF_BITSTREAM_WRITE);
+		if (!rtp->nal_buf_size) {
+			/*dummy size field*/
+			char nal_hdr[6];
+			nal_hdr[0] = nal_hdr[1] = nal_hdr[2] = nal_hdr[3] = 0;
 			/*coypy F bit highest bit of LayerId*/
-			nal_hdr[0] = payload[0] & 0x81;
+			nal_hdr[4] = payload[0] & 0x81;
 			/*assign NAL type*/
-			nal_hdr[0] |= (payload[2] & 0x3F) << 1;
+			nal_hdr[4] |= (payload[2] & 0x3F) << 1;
 			/*copy LayerId and TID*/
-			nal_hdr[1] = payload[1];
-			/*dummy size field*/
-			gf_bs_write_u32(rtp->inter_bs, 0);
-			gf_bs_write_data(rtp->inter_bs, nal_hdr, 2);
+			nal_hdr[5] = payload[1];
+			if (!gf_rtp_nal_buf_append(rtp, nal_hdr, 6)) return;
 		}
-		gf_bs_write_data(rtp->inter_bs, payload+3, size-3);
+		if (!gf_rtp_nal_buf_append(rtp, payload+3, size-3)) return;
 		if (is_end || hdr->Marker) gf_rtp_hevc_flush(rtp, hdr, GF_FALSE);
 	}
 }
@@ -1709,6 +1719,7 @@ void gf_rtp_depacketizer_reset(GF_RTPDepacketizer *rtp, Bool full_reset)
 	if (rtp) {
 		if (rtp->inter_bs) gf_bs_del(rtp->inter_bs);
 		rtp->inter_bs = NULL;
+		rtp->nal_buf_size = 0;
 		rtp->flags |= GF_RTP_NEW_AU;
 		if (full_reset) {
 			u32 dur = rtp->sl_hdr.au_duration;
@@ -1725,6 +1736,7 @@ void gf_rtp_depacketizer_del(GF_RTPDepacketizer *rtp)
 		gf_rtp_depacketizer_reset(rtp, GF_FALSE);
 		if (rtp->sl_map.config) gf_free(rtp->sl_map.config);
 		if (rtp->key) gf_free(rtp->key);
+		if (rtp->nal_buf) gf_free(rtp->nal_buf);
 		gf_free(rtp);
 	}
 }
@@ -87,6 +87,8 @@ GF_EXPORT
 GF_Err gf_rtp_builder_process(GP_RTPPacketizer *builder, char *data, u32 data_size, u8 IsAUEnd, u32 FullAUSize, u32 duration, u8 descIndex)
 {
 	if (!builder) return GF_BAD_PARAM;
+	/*no data means flush*/
+	if (!data) data_size = 0;
 
 	switch (builder->rtp_payt) {
 	case GF_RTP_PAYT_MPEG4:
@@ -125,6 +127,24 @@ GF_Err gf_rtp_builder_process(GP_RTPPacketizer *builder, char *data, u32 data_si
 	}
 }
 
+GF_EXPORT
+GF_Err gf_rtp_builder_process_ref(GP_RTPPacketizer *builder, u32 data_size, u8 IsAUEnd, u32 FullAUSize, u32 duration)
+{
+	/*the payload is never read, it must be referenced through OnDataReference*/
+	if (!builder || !builder->OnDataReference || !data_size) return GF_BAD_PARAM;
+
+	switch (builder->rtp_payt) {
+	case GF_RTP_PAYT_MPEG4:
+		return gp_rtp_builder_do_mpeg4(builder, NULL, data_size, IsAUEnd, FullAUSize);
+	case GF_RTP_PAYT_LATM:
+		return gp_rtp_builder_do_latm(builder, NULL, data_size, IsAUEnd, FullAUSize, duration);
+	case GF_RTP_PAYT_AC3:
+		return gp_rtp_builder_do_ac3(builder, NULL, data_size, IsAUEnd, FullAUSize);
+	default:
+		return GF_NOT_SUPPORTED;
+	}
+}
+
 
 //Compute the #params of the slMap
 GF_EXPORT
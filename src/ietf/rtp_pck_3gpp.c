@@ -690,8 +690,8 @@ GF_Err gp_rtp_builder_do_ac3(GP_RTPPacketizer *builder, char *data, u32 data_siz
 	char hdr[2];
 	u32 offset, nb_pck;
 
-	/*flush*/
-	if (!data) {
+	/*flush - no data with a size is a referenced payload*/
+	if (!data && !data_size) {
 		gf_rtp_ac3_flush(builder);
 		return GF_OK;
 	}
@@ -213,8 +213,8 @@ GF_Err gp_rtp_builder_do_mpeg4(GP_RTPPacketizer *builder, char *data, u32 data_s
 	flush_pck = 0;
 
 	bytesLeftInPacket = data_size;
-	/*flush everything*/
-	if (!data) {
+	/*flush everything - no data with a size is a referenced payload*/
+	if (!data && !data_size) {
 		if (builder->payload) goto flush_packet;
 		return GF_OK;
 	}
@@ -704,7 +704,8 @@ GF_Err gp_rtp_builder_do_latm(GP_RTPPacketizer *builder, char *data, u32 data_si
 	Bool fragmented;
 	unsigned char *latm_hdr;
 
-	if (!data) {
+	/*flush - no data with a size is a referenced payload*/
+	if (!data && !data_size) {
 		latm_flush(builder);
 		return GF_OK;
 	}
@@ -423,6 +423,7 @@ GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32
 						base_samp = gf_isom_get_sample(mdia->mediaTrack->moov->mov, ref_track, sampleNumber + mdia->mediaTrack->sample_count_at_seg_start, &di);
 						if (base_samp && base_samp->data) {
 							sample->data = gf_realloc(sample->data, sample->dataLength+base_samp->dataLength);
+							sample->alloc_size = 0;
 							memmove(sample->data + base_samp->dataLength, sample->data , sample->dataLength);
 							memcpy(sample->data, base_samp->data, base_samp->dataLength);
 							sample->dataLength += base_samp->dataLength;
@@ -443,6 +444,7 @@ GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32
 				tile_samp = gf_isom_get_sample(mdia->mediaTrack->moov->mov, ref_track, sampleNumber + mdia->mediaTrack->sample_count_at_seg_start, &di);
 				if (tile_samp  && tile_samp ->data) {
 					sample->data = gf_realloc(sample->data, sample->dataLength+tile_samp->dataLength);
+					sample->alloc_size = 0;
 					memcpy(sample->data + sample->dataLength, tile_samp->data, tile_samp->dataLength);
 					sample->dataLength += tile_samp->dataLength;
 				}
@@ -596,6 +598,7 @@ GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32
 				gf_bs_write_data(dst_bs, sample->data, sample->dataLength);
 				gf_free(sample->data);
 				sample->data = NULL;
+				sample->alloc_size = 0;
 				gf_bs_get_content(dst_bs, &sample->data, &sample->dataLength);
 				gf_bs_del(src_bs);
 				gf_bs_del(dst_bs);
@@ -615,6 +618,7 @@ GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32
 		gf_bs_write_data(dst_bs, sample->data, sample->dataLength);
 		gf_free(sample->data);
 		sample->data = NULL;
+		sample->alloc_size = 0;
 		gf_bs_get_content(dst_bs, &sample->data, &sample->dataLength);
 		gf_bs_del(src_bs);
 		gf_bs_del(dst_bs);
@@ -757,6 +761,7 @@ GF_Err gf_isom_nalu_sample_rewrite(GF_MediaBox *mdia, GF_ISOSample *sample, u32
 	/*done*/
 	gf_free(sample->data);
 	sample->data = NULL;
+	sample->alloc_size = 0;
 	gf_bs_get_content(dst_bs, &sample->data, &sample->dataLength);
 
 	/*rewrite temporal ID of AU Ddelim NALU (first one)*/
@@ -774,6 +779,25 @@ exit:
 	return e;
 }
 
+Bool gf_isom_nalu_sample_rewrite_changes_data(GF_MediaBox *mdia, GF_MPEGVisualSampleEntryBox *entry)
+{
+	u32 track_num;
+	GF_ISOFile *file = mdia->mediaTrack->moov->mov;
+
+	if (mdia->mediaTrack->extractor_mode & (GF_ISOM_NALU_EXTRACT_INBAND_PS_FLAG | GF_ISOM_NALU_EXTRACT_ANNEXB_FLAG))
+		return GF_TRUE;
+	/*layered configs are always rewritten (extractors, VDRD, base layer aggregation)*/
+	if (entry->svc_config || entry->mvc_config || entry->lhvc_config)
+		return GF_TRUE;
+
+	/*tile aggregation, extractor resolution and base track config*/
+	track_num = 1 + gf_list_find(mdia->mediaTrack->moov->trackList, mdia->mediaTrack);
+	if (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_SCAL) > 0) return GF_TRUE;
+	if (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_SABT) > 0) return GF_TRUE;
+	if (gf_isom_get_reference_count(file, track_num, GF_ISOM_REF_TBAS) > 0) return GF_TRUE;
+	return GF_FALSE;
+}
+
 GF_HEVCConfig *HEVC_DuplicateConfig(GF_HEVCConfig *cfg)
 {
 	char *data;
@@ -3605,6 +3605,8 @@ void moof_del(GF_Box *s)
 	if (ptr->mfhd) gf_isom_box_del((GF_Box *) ptr->mfhd);
 	gf_isom_box_array_del(ptr->TrackList);
 	if (ptr->mdat) gf_free(ptr->mdat);
+	//must be done after deleting the trafs
+	if (ptr->arena) gf_arena_del(ptr->arena);
 	gf_free(ptr);
 }
 
@@ -3627,6 +3629,9 @@ GF_Err moof_AddBox(GF_Box *s, GF_Box *a)
 
 GF_Err moof_Read(GF_Box *s, GF_BitStream *bs)
 {
+	GF_MovieFragmentBox *ptr = (GF_MovieFragmentBox *)s;
+	//trun entries and senc aux info of all trafs are allocated from a single arena, released with the moof
+	if (!ptr->arena) ptr->arena = gf_arena_new(4096);
 	return gf_isom_box_array_read(s, bs, moof_AddBox);
 }
 
@@ -4971,6 +4976,7 @@ void stbl_del(GF_Box *s)
 
 	if (ptr->sai_sizes) gf_isom_box_array_del(ptr->sai_sizes);
 	if (ptr->sai_offsets) gf_isom_box_array_del(ptr->sai_offsets);
+	if (ptr->lazy_offsets) gf_free(ptr->lazy_offsets);
 
 	gf_free(ptr);
 }
@@ -5098,6 +5104,101 @@ GF_Err stbl_Read(GF_Box *s, GF_BitStream *bs)
 	return GF_OK;
 }
 
+/*checks if the next child box of the sample table can be loaded later on, and if so records its offset and skips it
+returns the number of bytes skipped, 0 if the box shall be parsed now*/
+u64 stbl_SkipLazyBox(GF_SampleTableBox *ptr, GF_BitStream *bs)
+{
+	u32 type;
+	u64 size, pos;
+
+	if (gf_bs_available(bs) < 16) return 0;
+	size = gf_bs_peek_bits(bs, 32, 0);
+	type = gf_bs_peek_bits(bs, 32, 4);
+	/*large size or broken boxes go through the regular parser*/
+	if ((size < 8) || (size > ptr->size) || (size > gf_bs_available(bs))) return 0;
+
+	switch (type) {
+	case GF_ISOM_BOX_TYPE_STTS:
+	case GF_ISOM_BOX_TYPE_CTTS:
+	case GF_ISOM_BOX_TYPE_STSS:
+	case GF_ISOM_BOX_TYPE_STSC:
+	case GF_ISOM_BOX_TYPE_STCO:
+	case GF_ISOM_BOX_TYPE_CO64:
+	case GF_ISOM_BOX_TYPE_SDTP:
+	case GF_ISOM_BOX_TYPE_SBGP:
+		break;
+	/*the sample count is needed without loading the table: keep a stub with size and count only*/
+	case GF_ISOM_BOX_TYPE_STSZ:
+	{
+		GF_SampleSizeBox *stub;
+		if (size < 20) return 0;
+		/*constant sample size, nothing to save*/
+		if (gf_bs_peek_bits(bs, 32, 12)) return 0;
+		if (ptr->SampleSize) return 0;
+		stub = (GF_SampleSizeBox *) gf_isom_box_new(GF_ISOM_BOX_TYPE_STSZ);
+		if (!stub) return 0;
+		stub->sampleCount = gf_bs_peek_bits(bs, 32, 16);
+		stub->size = size;
+		ptr->SampleSize = stub;
+	}
+		break;
+	default:
+		return 0;
+	}
+
+	pos = gf_bs_get_position(bs);
+	ptr->lazy_offsets = (u64*)gf_realloc(ptr->lazy_offsets, sizeof(u64) * (ptr->nb_lazy_offsets+1));
+	if (!ptr->lazy_offsets) {
+		ptr->nb_lazy_offsets = 0;
+		return 0;
+	}
+	ptr->lazy_offsets[ptr->nb_lazy_offsets] = pos;
+	ptr->nb_lazy_offsets++;
+	gf_bs_skip_bytes(bs, size);
+	return size;
+}
+
+/*parses all sample table boxes skipped by stbl_SkipLazyBox*/
+GF_Err stbl_LoadLazyBoxes(GF_SampleTableBox *ptr, GF_BitStream *bs)
+{
+	u32 i;
+	u64 pos;
+	GF_Err e = GF_OK;
+
+	if (!ptr->lazy_offsets) return GF_OK;
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Loading %d sample table boxes on demand\n", ptr->nb_lazy_offsets));
+
+	/*remove the size stub, the real box is in the list*/
+	if (ptr->SampleSize && !ptr->SampleSize->sizes && !ptr->SampleSize->sampleSize) {
+		gf_isom_box_del((GF_Box *)ptr->SampleSize);
+		ptr->SampleSize = NULL;
+	}
+
+	pos = gf_bs_get_position(bs);
+	for (i=0; i<ptr->nb_lazy_offsets; i++) {
+		GF_Box *a = NULL;
+		gf_bs_seek(bs, ptr->lazy_offsets[i]);
+		e = gf_isom_box_parse(&a, bs);
+		if (!e) {
+			e = stbl_AddBox((GF_Box *)ptr, a);
+			if (e == GF_ISOM_INVALID_MEDIA) e = GF_OK;
+			else if (e) gf_isom_box_del(a);
+		} else if (a) {
+			gf_isom_box_del(a);
+		}
+		if (e) break;
+	}
+	gf_bs_seek(bs, pos);
+
+	gf_free(ptr->lazy_offsets);
+	ptr->lazy_offsets = NULL;
+	ptr->nb_lazy_offsets = 0;
+
+	ptr->no_sync_found = ptr->SyncSample ? 0 : 1;
+	return e;
+}
+
 GF_Box *stbl_New()
 {
 	ISOM_DECL_BOX_ALLOC(GF_SampleTableBox, GF_ISOM_BOX_TYPE_STBL);
@@ -7584,14 +7685,16 @@ GF_Err trep_Size(GF_Box *s)
 
 void trun_del(GF_Box *s)
 {
-	GF_TrunEntry *p;
+	u32 i, count;
 	GF_TrackFragmentRunBox *ptr = (GF_TrackFragmentRunBox *)s;
 	if (ptr == NULL) return;
 
-	while (gf_list_count(ptr->entries)) {
-		p = (GF_TrunEntry*)gf_list_get(ptr->entries, 0);
-		gf_list_rem(ptr->entries, 0);
-		gf_free(p);
+	//entries allocated from the moof arena are released with the moof
+	if (!ptr->arena) {
+		count = gf_list_count(ptr->entries);
+		for (i=0; i<count; i++) {
+			gf_free(gf_list_get(ptr->entries, i));
+		}
 	}
 	gf_list_del(ptr->entries);
 	if (ptr->cache) gf_bs_del(ptr->cache);
@@ -7600,8 +7703,8 @@ void trun_del(GF_Box *s)
 
 GF_Err trun_Read(GF_Box *s, GF_BitStream *bs)
 {
-	u32 i;
-	GF_TrunEntry *p;
+	u32 i, entry_size;
+	GF_TrunEntry *p, *arena_entries = NULL;
 	GF_TrackFragmentRunBox *ptr = (GF_TrackFragmentRunBox *)s;
 
 	//check this is a good file
@@ -7620,12 +7723,30 @@ GF_Err trun_Read(GF_Box *s, GF_BitStream *bs)
 		ISOM_DECREASE_SIZE(ptr, 4);
 	}
 
+	if (ptr->arena && ptr->sample_count) {
+		//all entries of the run are allocated at once, check the box can hold them first
+		entry_size = 0;
+		if (ptr->flags & GF_ISOM_TRUN_DURATION) entry_size += 4;
+		if (ptr->flags & GF_ISOM_TRUN_SIZE) entry_size += 4;
+		if (ptr->flags & GF_ISOM_TRUN_FLAGS) entry_size += 4;
+		if (ptr->flags & GF_ISOM_TRUN_CTS_OFFSET) entry_size += 4;
+		if ((u64) ptr->sample_count * entry_size > ptr->size) return GF_ISOM_INVALID_FILE;
+		if ((u64) ptr->sample_count * sizeof(GF_TrunEntry) > 0x7FFFFFFF) return GF_OUT_OF_MEM;
+
+		arena_entries = (GF_TrunEntry *) gf_arena_alloc(ptr->arena, ptr->sample_count * sizeof(GF_TrunEntry));
+		if (!arena_entries) return GF_OUT_OF_MEM;
+	}
+
 	//read each entry (even though nothing may be written)
 	for (i=0; i<ptr->sample_count; i++) {
 		u32 trun_size = 0;
-		p = (GF_TrunEntry *) gf_malloc(sizeof(GF_TrunEntry));
-		if (!p) return GF_OUT_OF_MEM;
-		memset(p, 0, sizeof(GF_TrunEntry));
+		if (arena_entries) {
+			p = &arena_entries[i];
+		} else {
+			p = (GF_TrunEntry *) gf_malloc(sizeof(GF_TrunEntry));
+			if (!p) return GF_OUT_OF_MEM;
+			memset(p, 0, sizeof(GF_TrunEntry));
+		}
 
 		if (ptr->flags & GF_ISOM_TRUN_DURATION) {
 			p->Duration = gf_bs_read_u32(bs);
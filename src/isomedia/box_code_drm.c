@@ -1097,7 +1097,8 @@ GF_Box *piff_psec_New()
 void piff_psec_del(GF_Box *s)
 {
 	GF_SampleEncryptionBox *ptr = (GF_SampleEncryptionBox *)s;
-	while (gf_list_count(ptr->samp_aux_info)) {
+	//aux info allocated from the moof arena is released with the moof
+	while (!ptr->sai_in_arena && gf_list_count(ptr->samp_aux_info)) {
 		GF_CENCSampleAuxInfo *sai = (GF_CENCSampleAuxInfo *)gf_list_get(ptr->samp_aux_info, 0);
 		if (sai) gf_isom_cenc_samp_aux_info_del(sai);
 		gf_list_rem(ptr->samp_aux_info, 0);
@@ -1296,7 +1297,8 @@ GF_Box *senc_New()
 void senc_del(GF_Box *s)
 {
 	GF_SampleEncryptionBox *ptr = (GF_SampleEncryptionBox *)s;
-	while (gf_list_count(ptr->samp_aux_info)) {
+	//aux info allocated from the moof arena is released with the moof
+	while (!ptr->sai_in_arena && gf_list_count(ptr->samp_aux_info)) {
 		GF_CENCSampleAuxInfo *sai = (GF_CENCSampleAuxInfo *)gf_list_get(ptr->samp_aux_info, 0);
 		if (sai) gf_isom_cenc_samp_aux_info_del(sai);
 		gf_list_rem(ptr->samp_aux_info, 0);
@@ -1313,6 +1315,7 @@ GF_Err senc_Parse(GF_BitStream *bs, GF_TrackBox *trak, void *traf, GF_SampleEncr
 {
 	GF_Err e;
 	u32 i, j, count;
+	GF_MemArena *arena = NULL;
 	u64 pos = gf_bs_get_position(bs);
 
 #ifdef	GPAC_DISABLE_ISOM_FRAGMENTS
@@ -1324,11 +1327,24 @@ GF_Err senc_Parse(GF_BitStream *bs, GF_TrackBox *trak, void *traf, GF_SampleEncr
 
 	count = gf_bs_read_u32(bs);
 	if (!senc->samp_aux_info) senc->samp_aux_info = gf_list_new();
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	//aux info of a fragment lives as long as its moof, allocate it from the moof arena
+	if (traf && traf->arena && (senc->sai_in_arena || !gf_list_count(senc->samp_aux_info))) {
+		arena = traf->arena;
+		senc->sai_in_arena = GF_TRUE;
+	}
+#endif
 	for (i=0; i<count; i++) {
 		u32 is_encrypted;
 		u32 samp_count;
-		GF_CENCSampleAuxInfo *sai = (GF_CENCSampleAuxInfo *)gf_malloc(sizeof(GF_CENCSampleAuxInfo));
-		memset(sai, 0, sizeof(GF_CENCSampleAuxInfo));
+		GF_CENCSampleAuxInfo *sai;
+		if (arena) {
+			sai = (GF_CENCSampleAuxInfo *)gf_arena_alloc(arena, sizeof(GF_CENCSampleAuxInfo));
+		} else {
+			sai = (GF_CENCSampleAuxInfo *)gf_malloc(sizeof(GF_CENCSampleAuxInfo));
+			if (sai) memset(sai, 0, sizeof(GF_CENCSampleAuxInfo));
+		}
+		if (!sai) return GF_OUT_OF_MEM;
 
 		samp_count = i+1;
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
@@ -1338,6 +1354,7 @@ GF_Err senc_Parse(GF_BitStream *bs, GF_TrackBox *trak, void *traf, GF_SampleEncr
 		e = gf_isom_get_sample_cenc_info_ex(trak, traf, senc, samp_count, &is_encrypted, &sai->IV_size, NULL, NULL, NULL, NULL, NULL);
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[isobmf] could not get cenc info for sample %d: %s\n", samp_count, gf_error_to_string(e) ));
+			if (!arena) gf_free(sai);
 			return e;
 		}
 
@@ -1345,7 +1362,10 @@ GF_Err senc_Parse(GF_BitStream *bs, GF_TrackBox *trak, void *traf, GF_SampleEncr
 			gf_bs_read_data(bs, (char *)sai->IV, sai->IV_size);
 			if (senc->flags & 0x00000002) {
 				sai->subsample_count = gf_bs_read_u16(bs);
-				sai->subsamples = (GF_CENCSubSampleEntry *)gf_malloc(sai->subsample_count*sizeof(GF_CENCSubSampleEntry));
+				if (arena)
+					sai->subsamples = (GF_CENCSubSampleEntry *)gf_arena_alloc(arena, sai->subsample_count*sizeof(GF_CENCSubSampleEntry));
+				else
+					sai->subsamples = (GF_CENCSubSampleEntry *)gf_malloc(sai->subsample_count*sizeof(GF_CENCSubSampleEntry));
 				for (j = 0; j < sai->subsample_count; j++) {
 					sai->subsamples[j].bytes_clear_data = gf_bs_read_u16(bs);
 					sai->subsamples[j].bytes_encrypted_data = gf_bs_read_u32(bs);
@@ -117,6 +117,15 @@ GF_Err gf_isom_dump(GF_ISOFile *mov, FILE * trace)
 	GF_Box *box;
 	if (!mov || !trace) return GF_BAD_PARAM;
 
+	//dump the complete sample tables of files opened in lazy mode
+	if (mov->moov) {
+		GF_TrackBox *trak;
+		i=0;
+		while ((trak = (GF_TrackBox *)gf_list_enum(mov->moov->trackList, &i))) {
+			Track_LoadSampleTables(trak);
+		}
+	}
+
 	use_dump_mode = mov->dump_mode_alloc;
 	fprintf(trace, "<!--MP4Box dump trace-->\n");
 
@@ -31,15 +31,18 @@
 static Bool skip_box_dump_del = GF_FALSE;
 Bool use_dump_mode = GF_FALSE;
 
+static GF_Err gf_isom_box_parse_arena(GF_Box **outBox, GF_BitStream *bs, u32 parent_type, Bool is_root_box, GF_MemArena *arena, Bool lazy_stbl);
+
 //Add this funct to handle incomplete files...
 //bytesExpected is 0 most of the time. If the file is incomplete, bytesExpected
 //is the number of bytes missing to parse the box...
-GF_Err gf_isom_parse_root_box(GF_Box **outBox, GF_BitStream *bs, u64 *bytesExpected, Bool progressive_mode)
+//lazy_stbl is set when parsing a file opened in GF_ISOM_OPEN_READ_LAZY mode
+GF_Err gf_isom_parse_root_box(GF_Box **outBox, GF_BitStream *bs, u64 *bytesExpected, Bool progressive_mode, Bool lazy_stbl)
 {
 	GF_Err ret;
 	u64 start;
 	start = gf_bs_get_position(bs);
-	ret = gf_isom_box_parse_ex(outBox, bs, 0, GF_TRUE);
+	ret = gf_isom_box_parse_arena(outBox, bs, 0, GF_TRUE, NULL, lazy_stbl);
 	if (ret == GF_ISOM_INCOMPLETE_FILE) {
 		if (!*outBox) {
 			// We could not even read the box size, we at least need 8 bytes 
@@ -85,7 +88,27 @@ u32 gf_isom_solve_uuid_box(char *UUID)
 
 static GF_Err gf_isom_full_box_read(GF_Box *ptr, GF_BitStream *bs);
 
-GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type, Bool is_root_box)
+//returns the lazy sample table parsing flag of the boxes leading to the sample table, NULL for other boxes
+static Bool *gf_isom_box_lazy_stbl_flag(GF_Box *a)
+{
+	switch (a->type) {
+	case GF_ISOM_BOX_TYPE_MOOV:
+		return &((GF_MovieBox *)a)->lazy_stbl;
+	case GF_ISOM_BOX_TYPE_TRAK:
+		return &((GF_TrackBox *)a)->lazy_stbl;
+	case GF_ISOM_BOX_TYPE_MDIA:
+		return &((GF_MediaBox *)a)->lazy_stbl;
+	case GF_ISOM_BOX_TYPE_MINF:
+		return &((GF_MediaInformationBox *)a)->lazy_stbl;
+	case GF_ISOM_BOX_TYPE_STBL:
+		return &((GF_SampleTableBox *)a)->lazy_stbl;
+	}
+	return NULL;
+}
+
+//arena is the allocation arena of the parent box if any, passed to the boxes storing per-sample info
+//lazy_stbl is the lazy sample table flag of the parent box, passed down to the sample table
+static GF_Err gf_isom_box_parse_arena(GF_Box **outBox, GF_BitStream *bs, u32 parent_type, Bool is_root_box, GF_MemArena *arena, Bool lazy_stbl)
 {
 	u32 type, uuid_type, hdr_size;
 	u64 size, start, end;
@@ -182,6 +205,17 @@ GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type,
 
 	if (!newBox->type) newBox->type = type;
 
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+	if (arena) {
+		if (newBox->type==GF_ISOM_BOX_TYPE_TRAF) ((GF_TrackFragmentBox *)newBox)->arena = arena;
+		else if (newBox->type==GF_ISOM_BOX_TYPE_TRUN) ((GF_TrackFragmentRunBox *)newBox)->arena = arena;
+	}
+#endif
+	if (lazy_stbl) {
+		Bool *flag = gf_isom_box_lazy_stbl_flag(newBox);
+		if (flag) *flag = GF_TRUE;
+	}
+
 	end = gf_bs_available(bs);
 	if (size - hdr_size > end ) {
 		newBox->size = size - hdr_size - end;
@@ -226,6 +260,11 @@ GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type,
 	return e;
 }
 
+GF_Err gf_isom_box_parse_ex(GF_Box **outBox, GF_BitStream *bs, u32 parent_type, Bool is_root_box)
+{
+	return gf_isom_box_parse_arena(outBox, bs, parent_type, is_root_box, NULL, GF_FALSE);
+}
+
 GF_EXPORT
 GF_Err gf_isom_box_parse(GF_Box **outBox, GF_BitStream *bs)
 {
@@ -1212,9 +1251,25 @@ GF_Err gf_isom_box_array_read_ex(GF_Box *parent, GF_BitStream *bs, GF_Err (*add_
 {
 	GF_Err e;
 	GF_Box *a = NULL;
+	GF_MemArena *arena = NULL;
+	Bool *lazy_stbl = gf_isom_box_lazy_stbl_flag(parent);
+
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+	if (parent->type==GF_ISOM_BOX_TYPE_MOOF) arena = ((GF_MovieFragmentBox *)parent)->arena;
+	else if (parent->type==GF_ISOM_BOX_TYPE_TRAF) arena = ((GF_TrackFragmentBox *)parent)->arena;
+#endif
+
 	//we may have terminators in some QT files (4 bytes set to 0 ...)
 	while (parent->size>=8) {
-		e = gf_isom_box_parse_ex(&a, bs, parent_type, GF_FALSE);
+		//in lazy mode, sample tables are only located and will be parsed on first access
+		if (lazy_stbl && *lazy_stbl && (parent->type==GF_ISOM_BOX_TYPE_STBL)) {
+			u64 skipped = stbl_SkipLazyBox((GF_SampleTableBox *)parent, bs);
+			if (skipped) {
+				parent->size -= skipped;
+				continue;
+			}
+		}
+		e = gf_isom_box_parse_arena(&a, bs, parent_type, GF_FALSE, arena, lazy_stbl ? *lazy_stbl : GF_FALSE);
 		if (e) {
 			if (a) gf_isom_box_del(a);
 			return e;
@@ -25,13 +25,22 @@
 
 #include <gpac/internal/isomedia_dev.h>
 #include <gpac/network.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
 /**************************************************************
 		Some Local functions for movie creation
 **************************************************************/
-GF_Err gf_isom_parse_root_box(GF_Box **outBox, GF_BitStream *bs, u64 *bytesExpected, Bool progressive_mode);
+GF_Err gf_isom_parse_root_box(GF_Box **outBox, GF_BitStream *bs, u64 *bytesExpected, Bool progressive_mode, Bool lazy_stbl);
+
+static u32 isom_frag_parser_threads = 0;
+
+GF_EXPORT
+void gf_isom_set_fragment_parser_threads(u32 nb_threads)
+{
+	isom_frag_parser_threads = nb_threads;
+}
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 GF_Err MergeTrack(GF_TrackBox *trak, GF_TrackFragmentBox *traf, u64 moof_offset, Bool is_first_merge);
@@ -174,13 +183,299 @@ static void FixSDTPInTRAF(GF_MovieFragmentBox *moof)
 	}
 }
 
+
+/*parallel parsing of movie fragments at open time: the top-level boxes are first scanned to locate all complete
+MOOF boxes, which are then parsed by a pool of threads (each with its own bitstream on the file). Parsed fragments
+are handed back to gf_isom_parse_movie_boxes in file order, and merged in the track sample tables as usual*/
+
+/*min number of fragments to use parallel parsing*/
+#define ISOM_FRAG_PARSER_MIN_MOOFS	16
+#define ISOM_FRAG_PARSER_MAX_THREADS	8
+/*max number of fragments parsed ahead of the merge, per thread*/
+#define ISOM_FRAG_PARSER_AHEAD	16
+
+typedef struct
+{
+	u64 offset, size;
+	GF_MovieFragmentBox *moof;
+	/*0: not parsed, 1: parsing, 2: done*/
+	u32 state;
+} GF_FragParserEntry;
+
+typedef struct
+{
+	GF_FragParserEntry *entries;
+	u32 nb_entries;
+	/*next entry to parse, next entry to merge*/
+	u32 next_parse, next_merge, max_ahead;
+	Bool stop;
+
+	GF_Mutex *mx;
+	/*notified when a fragment is parsed, and when a fragment is merged*/
+	GF_Semaphore *parsed, *merged;
+
+	u32 nb_threads;
+	GF_Thread **threads;
+	GF_BitStream **bs;
+	FILE **files;
+} GF_FragParser;
+
+static u32 isom_frag_parser_run(void *par)
+{
+	GF_BitStream *bs;
+	GF_FragParser *fp = (GF_FragParser *)par;
+	u32 i;
+
+	/*pick our bitstream*/
+	gf_mx_p(fp->mx);
+	for (i=0; i<fp->nb_threads; i++) {
+		if (fp->bs[i]) break;
+	}
+	bs = fp->bs[i];
+	fp->bs[i] = NULL;
+	gf_mx_v(fp->mx);
+
+	while (1) {
+		GF_Err e;
+		GF_Box *a = NULL;
+		u64 missing;
+		GF_FragParserEntry *ent;
+
+		gf_mx_p(fp->mx);
+		if (fp->stop || (fp->next_parse == fp->nb_entries)) {
+			gf_mx_v(fp->mx);
+			break;
+		}
+		if (fp->next_parse >= fp->next_merge + fp->max_ahead) {
+			gf_mx_v(fp->mx);
+			gf_sema_wait(fp->merged);
+			continue;
+		}
+		ent = &fp->entries[fp->next_parse];
+		fp->next_parse++;
+		ent->state = 1;
+		gf_mx_v(fp->mx);
+
+		gf_bs_seek(bs, ent->offset);
+		e = gf_isom_parse_root_box(&a, bs, &missing, GF_FALSE, GF_FALSE);
+		if (a && (e || (a->type != GF_ISOM_BOX_TYPE_MOOF))) {
+			gf_isom_box_del(a);
+			a = NULL;
+		}
+		/*left to the merge thread on error*/
+		if (a && !e) {
+			FixSDTPInTRAF((GF_MovieFragmentBox *)a);
+		}
+
+		gf_mx_p(fp->mx);
+		ent->moof = (GF_MovieFragmentBox *)a;
+		ent->state = 2;
+		gf_mx_v(fp->mx);
+		gf_sema_notify(fp->parsed, 1);
+	}
+	/*give back our bitstream for destruction*/
+	gf_mx_p(fp->mx);
+	fp->bs[i] = bs;
+	gf_mx_v(fp->mx);
+	return 0;
+}
+
+static void isom_frag_parser_del(GF_FragParser *fp)
+{
+	u32 i;
+	if (!fp) return;
+	if (fp->threads) {
+		gf_mx_p(fp->mx);
+		fp->stop = GF_TRUE;
+		gf_mx_v(fp->mx);
+		/*wake up threads waiting for merge*/
+		gf_sema_notify(fp->merged, fp->nb_threads);
+		for (i=0; i<fp->nb_threads; i++) {
+			if (!fp->threads[i]) continue;
+			gf_th_stop(fp->threads[i]);
+			gf_th_del(fp->threads[i]);
+		}
+		gf_free(fp->threads);
+	}
+	for (i=0; i<fp->nb_threads; i++) {
+		if (fp->bs && fp->bs[i]) gf_bs_del(fp->bs[i]);
+		if (fp->files && fp->files[i]) gf_fclose(fp->files[i]);
+	}
+	if (fp->bs) gf_free(fp->bs);
+	if (fp->files) gf_free(fp->files);
+	for (i=0; i<fp->nb_entries; i++) {
+		if (fp->entries[i].moof) gf_isom_box_del((GF_Box *)fp->entries[i].moof);
+	}
+	if (fp->entries) gf_free(fp->entries);
+	if (fp->parsed) gf_sema_del(fp->parsed);
+	if (fp->merged) gf_sema_del(fp->merged);
+	if (fp->mx) gf_mx_del(fp->mx);
+	gf_free(fp);
+}
+
+/*locates all complete MOOF boxes after the current position and starts the parsing threads*/
+static GF_FragParser *isom_frag_parser_new(GF_ISOFile *mov)
+{
+	u32 i, nb_threads, nb_alloc;
+	u64 pos, end;
+	GF_FragParser *fp;
+	GF_BitStream *bs = mov->movieFileMap->bs;
+
+	nb_threads = isom_frag_parser_threads;
+	if (!nb_threads) {
+		GF_SystemRTInfo rti;
+		memset(&rti, 0, sizeof(GF_SystemRTInfo));
+		gf_sys_get_rti(1000, &rti, 0);
+		nb_threads = MIN(rti.nb_cores, ISOM_FRAG_PARSER_MAX_THREADS);
+	}
+	if (nb_threads <= 1) return NULL;
+	/*the threads need their own access to the file data*/
+	if ((mov->movieFileMap->type != GF_ISOM_DATA_FILE) && (mov->movieFileMap->type != GF_ISOM_DATA_FILE_MAPPING)) return NULL;
+
+	GF_SAFEALLOC(fp, GF_FragParser);
+	if (!fp) return NULL;
+
+	pos = gf_bs_get_position(bs);
+	end = pos + gf_bs_available(bs);
+	nb_alloc = 0;
+	while (pos + 8 <= end) {
+		u64 size;
+		u32 type;
+		gf_bs_seek(bs, pos);
+		size = gf_bs_read_u32(bs);
+		type = gf_bs_read_u32(bs);
+		if (size == 1) {
+			if (pos + 16 > end) break;
+			size = gf_bs_read_u64(bs);
+		}
+		/*box till the end of file or broken size, let the regular parsing handle it*/
+		if (size < 8) break;
+		if (pos + size > end) break;
+
+		if (type == GF_ISOM_BOX_TYPE_MOOF) {
+			if (fp->nb_entries == nb_alloc) {
+				nb_alloc = nb_alloc ? 2*nb_alloc : 256;
+				fp->entries = (GF_FragParserEntry *)gf_realloc(fp->entries, sizeof(GF_FragParserEntry) * nb_alloc);
+				if (!fp->entries) {
+					fp->nb_entries = 0;
+					break;
+				}
+			}
+			memset(&fp->entries[fp->nb_entries], 0, sizeof(GF_FragParserEntry));
+			fp->entries[fp->nb_entries].offset = pos;
+			fp->entries[fp->nb_entries].size = size;
+			fp->nb_entries++;
+		}
+		pos += size;
+	}
+	gf_bs_seek(bs, mov->current_top_box_start);
+
+	if (fp->nb_entries < ISOM_FRAG_PARSER_MIN_MOOFS) {
+		isom_frag_parser_del(fp);
+		return NULL;
+	}
+	if (nb_threads > fp->nb_entries / ISOM_FRAG_PARSER_AHEAD) nb_threads = MAX(2, fp->nb_entries / ISOM_FRAG_PARSER_AHEAD);
+
+	fp->nb_threads = nb_threads;
+	fp->max_ahead = nb_threads * ISOM_FRAG_PARSER_AHEAD;
+	fp->bs = (GF_BitStream **)gf_malloc(sizeof(GF_BitStream *) * nb_threads);
+	fp->files = (FILE **)gf_malloc(sizeof(FILE *) * nb_threads);
+	fp->threads = (GF_Thread **)gf_malloc(sizeof(GF_Thread *) * nb_threads);
+	if (!fp->bs || !fp->files || !fp->threads) {
+		if (fp->threads) gf_free(fp->threads);
+		fp->threads = NULL;
+		fp->nb_threads = 0;
+		isom_frag_parser_del(fp);
+		return NULL;
+	}
+	memset(fp->bs, 0, sizeof(GF_BitStream *) * nb_threads);
+	memset(fp->files, 0, sizeof(FILE *) * nb_threads);
+	memset(fp->threads, 0, sizeof(GF_Thread *) * nb_threads);
+
+	for (i=0; i<nb_threads; i++) {
+		fp->files[i] = gf_fopen(mov->fileName, "rb");
+		if (fp->files[i]) fp->bs[i] = gf_bs_from_file(fp->files[i], GF_BITSTREAM_READ);
+		if (!fp->bs[i]) {
+			GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Cannot reopen %s for parallel fragment parsing\n", mov->fileName));
+			gf_free(fp->threads);
+			fp->threads = NULL;
+			isom_frag_parser_del(fp);
+			return NULL;
+		}
+	}
+
+	fp->mx = gf_mx_new("ISOFragParser");
+	fp->parsed = gf_sema_new(fp->nb_entries + nb_threads, 0);
+	fp->merged = gf_sema_new(fp->nb_entries + nb_threads, 0);
+	for (i=0; i<nb_threads; i++) {
+		fp->threads[i] = gf_th_new("ISOFragParser");
+		if (gf_th_run(fp->threads[i], isom_frag_parser_run, fp) != GF_OK) {
+			isom_frag_parser_del(fp);
+			return NULL;
+		}
+	}
+	GF_LOG(GF_LOG_INFO, GF_LOG_CONTAINER, ("[iso file] Parsing %d movie fragments using %d threads\n", fp->nb_entries, nb_threads));
+	return fp;
+}
+
+/*gets the parsed MOOF starting at the given position, waiting for the parsing thread if needed. Returns NULL if
+no fragment was located at this position or if it failed to parse, in which case the box is parsed the regular way*/
+static GF_MovieFragmentBox *isom_frag_parser_get(GF_FragParser *fp, u64 pos)
+{
+	u32 nb_skip = 0;
+	GF_FragParserEntry *ent;
+	GF_MovieFragmentBox *moof;
+
+	gf_mx_p(fp->mx);
+	while ((fp->next_merge < fp->nb_entries) && (fp->entries[fp->next_merge].offset < pos)) {
+		fp->next_merge++;
+		nb_skip++;
+	}
+	if ((fp->next_merge == fp->nb_entries) || (fp->entries[fp->next_merge].offset != pos)) {
+		gf_mx_v(fp->mx);
+		if (nb_skip) gf_sema_notify(fp->merged, nb_skip);
+		return NULL;
+	}
+	ent = &fp->entries[fp->next_merge];
+	while (ent->state != 2) {
+		gf_mx_v(fp->mx);
+		gf_sema_wait(fp->parsed);
+		gf_mx_p(fp->mx);
+	}
+	moof = ent->moof;
+	ent->moof = NULL;
+	fp->next_merge++;
+	gf_mx_v(fp->mx);
+	gf_sema_notify(fp->merged, nb_skip+1);
+	return moof;
+}
+
+static GF_Err gf_isom_parse_movie_boxes_internal(GF_ISOFile *mov, u64 *bytesMissing, Bool progressive_mode, GF_FragParser **frag_parser);
+
+GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progressive_mode)
+{
+	GF_Err e;
+	GF_FragParser *frag_parser = NULL;
+	e = gf_isom_parse_movie_boxes_internal(mov, bytesMissing, progressive_mode, &frag_parser);
+	isom_frag_parser_del(frag_parser);
+	return e;
+}
+
 #endif
 
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+static GF_Err gf_isom_parse_movie_boxes_internal(GF_ISOFile *mov, u64 *bytesMissing, Bool progressive_mode, GF_FragParser **frag_parser)
+#else
 GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progressive_mode)
+#endif
 {
 	GF_Box *a;
 	u64 totSize;
 	GF_Err e = GF_OK;
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	/*only try parallel fragment parsing once, when reaching the first fragment after the moov*/
+	Bool check_frag_parser = !mov->dump_mode_alloc && !mov->single_moof_mode && (mov->openMode==GF_ISOM_OPEN_READ) && !(mov->FragmentsFlags & GF_ISOM_FRAG_READ_DEBUG);
+#endif
 
 #ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
 	if (mov->single_moof_mode && mov->single_moof_state == 2) {
@@ -201,7 +496,21 @@ GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progre
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_CONTAINER, ("[iso file] Starting to parse a top-level box at position %d\n", mov->current_top_box_start));
 #endif
 
-		e = gf_isom_parse_root_box(&a, mov->movieFileMap->bs, bytesMissing, progressive_mode);
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+		a = NULL;
+		if (check_frag_parser && mov->moov && mov->moov->mvex) {
+			check_frag_parser = GF_FALSE;
+			*frag_parser = isom_frag_parser_new(mov);
+		}
+		if (*frag_parser) {
+			a = (GF_Box *) isom_frag_parser_get(*frag_parser, mov->current_top_box_start);
+		}
+		if (a) {
+			e = GF_OK;
+			gf_bs_seek(mov->movieFileMap->bs, mov->current_top_box_start + a->size);
+		} else
+#endif
+			e = gf_isom_parse_root_box(&a, mov->movieFileMap->bs, bytesMissing, progressive_mode, mov->lazy_stbl);
 
 		if (e >= 0) {
 
@@ -238,6 +547,17 @@ GF_Err gf_isom_parse_movie_boxes(GF_ISOFile *mov, u64 *bytesMissing, Bool progre
 			
 			totSize += a->size;
 
+#ifndef GPAC_DISABLE_ISOM_FRAGMENTS
+			//fragmented files need the complete sample tables to merge fragments
+			if (mov->moov->mvex) {
+				u32 k;
+				for (k=0; k<gf_list_count(mov->moov->trackList); k++) {
+					e = Track_LoadSampleTables((GF_TrackBox *)gf_list_get(mov->moov->trackList, k));
+					if (e) return e;
+				}
+			}
+#endif
+
 			//dump senc info in dump mode
 			if (mov->dump_mode_alloc) {
 				u32 k;
@@ -534,10 +854,11 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 	mov->fileName = gf_strdup(fileName);
 	mov->openMode = OpenMode;
 
-	if ( (OpenMode == GF_ISOM_OPEN_READ) || (OpenMode == GF_ISOM_OPEN_READ_DUMP) ) {
+	if ( (OpenMode == GF_ISOM_OPEN_READ) || (OpenMode == GF_ISOM_OPEN_READ_DUMP) || (OpenMode == GF_ISOM_OPEN_READ_LAZY) ) {
 		//always in read ...
 		mov->openMode = GF_ISOM_OPEN_READ;
 		mov->es_id_default_sync = -1;
+		if (OpenMode == GF_ISOM_OPEN_READ_LAZY) mov->lazy_stbl = GF_TRUE;
 		//for open, we do it the regular way and let the GF_DataMap assign the appropriate struct
 		//this can be FILE (the only one supported...) as well as remote
 		//(HTTP, ...),not suported yet
@@ -601,6 +922,7 @@ GF_ISOFile *gf_isom_open_file(const char *fileName, u32 OpenMode, const char *tm
 	use_dump_mode = mov->dump_mode_alloc;
 
 	//OK, let's parse the movie...
+	//in lazy mode only locate sample tables, they are parsed on first access to the track
 	mov->LastError = gf_isom_parse_movie_boxes(mov, &bytes, 0);
 
 	if (!mov->LastError && (OpenMode == GF_ISOM_OPEN_CAT_FRAGMENTS)) {
@@ -682,15 +1004,30 @@ GF_TrackBox *gf_isom_get_track_from_original_id(GF_MovieBox *moov, u32 originalI
 	return NULL;
 }
 
-GF_TrackBox *gf_isom_get_track_from_file(GF_ISOFile *movie, u32 trackNumber)
+GF_TrackBox *gf_isom_get_track_from_file_ex(GF_ISOFile *movie, u32 trackNumber, Bool load_tables)
 {
 	GF_TrackBox *trak;
 	if (!movie) return NULL;
 	trak = gf_isom_get_track(movie->moov, trackNumber);
-	if (!trak) movie->LastError = GF_BAD_PARAM;
+	if (!trak) {
+		movie->LastError = GF_BAD_PARAM;
+		return NULL;
+	}
+	if (load_tables && trak->Media && trak->Media->information && trak->Media->information->sampleTable && trak->Media->information->sampleTable->lazy_offsets) {
+		GF_Err e = Track_LoadSampleTables(trak);
+		if (e) {
+			movie->LastError = e;
+			return NULL;
+		}
+	}
 	return trak;
 }
 
+GF_TrackBox *gf_isom_get_track_from_file(GF_ISOFile *movie, u32 trackNumber)
+{
+	return gf_isom_get_track_from_file_ex(movie, trackNumber, GF_TRUE);
+}
+
 
 //WARNING: MOVIETIME IS EXPRESSED IN MEDIA TS
 GF_Err GetMediaTime(GF_TrackBox *trak, Bool force_non_empty, u64 movieTime, u64 *MediaTime, s64 *SegmentStartTime, s64 *MediaOffset, u8 *useEdit, u64 *next_edit_start_plus_one)
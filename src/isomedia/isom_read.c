@@ -85,7 +85,7 @@ GF_EXPORT
 void gf_isom_sample_del(GF_ISOSample **samp)
 {
 	if (! *samp) return;
-	if ((*samp)->data && (*samp)->dataLength) gf_free((*samp)->data);
+	if ((*samp)->data && ((*samp)->dataLength || (*samp)->alloc_size)) gf_free((*samp)->data);
 	gf_free(*samp);
 	*samp = NULL;
 }
@@ -409,6 +409,7 @@ GF_ISOFile *gf_isom_open(const char *fileName, u32 OpenMode, const char *tmp_dir
 	switch (OpenMode & 0xFF) {
 	case GF_ISOM_OPEN_READ_DUMP:
 	case GF_ISOM_OPEN_READ:
+	case GF_ISOM_OPEN_READ_LAZY:
 		movie = gf_isom_open_file(fileName, OpenMode, NULL);
 		break;
 
@@ -604,7 +605,7 @@ u32 gf_isom_get_track_id(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
 	if (!movie) return 0;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 	return trak->Header->trackID;
 }
@@ -621,7 +622,7 @@ u32 gf_isom_get_track_by_id(GF_ISOFile *the_file, u32 trackID)
 	count = gf_isom_get_track_count(the_file);
 	if (!count) return 0;
 	for (i = 0; i < count; i++) {
-		trak = gf_isom_get_track_from_file(the_file, i+1);
+		trak = gf_isom_get_track_from_file_ex(the_file, i+1, GF_FALSE);
 		if (!trak) return 0;
 		if (trak->Header->trackID == trackID) return i+1;
 	}
@@ -633,7 +634,7 @@ u32 gf_isom_get_track_original_id(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
 	if (!movie) return 0;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 	return trak->originalID;
 }
@@ -817,7 +818,7 @@ GF_EXPORT
 u8 gf_isom_is_track_enabled(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 
 	if (!trak) return 2;
 	return (trak->Header->flags & 1) ? 1 : 0;
@@ -830,12 +831,12 @@ GF_EXPORT
 u64 gf_isom_get_track_duration(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
-	/*in all modes except dump recompute duration in case headers are wrong*/
-	if (movie->openMode != GF_ISOM_OPEN_READ_DUMP) {
+	/*in all modes except dump recompute duration in case headers are wrong - sample tables not loaded yet are not parsed for this*/
+	if ((movie->openMode != GF_ISOM_OPEN_READ_DUMP) && !trak->Media->information->sampleTable->lazy_offsets) {
 		SetTrackDuration(trak);
 	}
 #endif
@@ -852,7 +853,7 @@ GF_Err gf_isom_get_media_language(GF_ISOFile *the_file, u32 trackNumber, char **
 		return GF_BAD_PARAM;
 	}
 	*lang = NULL;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak) return GF_BAD_PARAM;
 	count = gf_list_count(trak->Media->other_boxes);
 	if (count>0) {
@@ -937,7 +938,7 @@ s32 gf_isom_get_reference_count(GF_ISOFile *movie, u32 trackNumber, u32 referenc
 {
 	GF_TrackBox *trak;
 	GF_TrackReferenceTypeBox *dpnd;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return -1;
 	if (!trak->References) return 0;
 	if (movie->openMode == GF_ISOM_OPEN_WRITE) {
@@ -961,7 +962,7 @@ GF_Err gf_isom_get_reference(GF_ISOFile *movie, u32 trackNumber, u32 referenceTy
 	GF_TrackBox *trak;
 	GF_TrackReferenceTypeBox *dpnd;
 	u32 refTrackNum;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 
 	*refTrack = 0;
 	if (!trak || !trak->References) return GF_BAD_PARAM;
@@ -993,7 +994,7 @@ GF_Err gf_isom_get_reference_ID(GF_ISOFile *movie, u32 trackNumber, u32 referenc
 	GF_Err e;
 	GF_TrackBox *trak;
 	GF_TrackReferenceTypeBox *dpnd;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 
 	*refTrackID = 0;
 	if (!trak || !trak->References) return GF_BAD_PARAM;
@@ -1069,7 +1070,7 @@ GF_EXPORT
 u32 gf_isom_get_sample_description_count(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 
 	return gf_list_count(trak->Media->information->sampleTable->SampleDescription->other_boxes);
@@ -1100,7 +1101,7 @@ GF_DecoderConfig *gf_isom_get_decoder_config(GF_ISOFile *the_file, u32 trackNumb
 	GF_TrackBox *trak;
 	GF_ESD *esd;
 	GF_Descriptor *decInfo;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak) return NULL;
 	//get the ESD (possibly emulated)
 	Media_GetESD(trak->Media, StreamDescriptionIndex, &esd, GF_FALSE);
@@ -1118,14 +1119,14 @@ GF_EXPORT
 u64 gf_isom_get_media_duration(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 
-	/*except in dump mode always recompute the duration*/
-	if (movie->openMode != GF_ISOM_OPEN_READ_DUMP) {
+	/*except in dump mode always recompute the duration, unless sample tables are not loaded yet*/
+	if ((movie->openMode != GF_ISOM_OPEN_READ_DUMP) && !trak->Media->information->sampleTable->lazy_offsets) {
 		if ( (movie->LastError = Media_SetDuration(trak)) ) return 0;
 	}
 
@@ -1140,7 +1141,7 @@ GF_EXPORT
 u64 gf_isom_get_media_original_duration(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 
 	return trak->Media->mediaHeader->original_duration;
@@ -1151,7 +1152,7 @@ GF_EXPORT
 u32 gf_isom_get_media_timescale(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 	return trak->Media->mediaHeader->timeScale;
 }
@@ -1272,7 +1273,7 @@ GF_EXPORT
 u32 gf_isom_get_media_type(GF_ISOFile *movie, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return GF_BAD_PARAM;
 	return (trak->Media && trak->Media->handler) ? trak->Media->handler->handlerType : 0;
 }
@@ -1327,7 +1328,7 @@ u32 gf_isom_get_media_subtype(GF_ISOFile *the_file, u32 trackNumber, u32 Descrip
 {
 	GF_TrackBox *trak;
 	GF_Box *entry;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak || !DescriptionIndex || !trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) return 0;
 	entry = (GF_Box*)gf_list_get(trak->Media->information->sampleTable->SampleDescription->other_boxes, DescriptionIndex-1);
 	if (!entry) return 0;
@@ -1354,7 +1355,7 @@ u32 gf_isom_get_mpeg4_subtype(GF_ISOFile *the_file, u32 trackNumber, u32 Descrip
 {
 	GF_TrackBox *trak;
 	GF_Box *entry;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak || !DescriptionIndex) return 0;
 	entry = (GF_Box*)gf_list_get(trak->Media->information->sampleTable->SampleDescription->other_boxes, DescriptionIndex-1);
 	if (!entry) return 0;
@@ -1369,7 +1370,7 @@ GF_EXPORT
 GF_Err gf_isom_get_handler_name(GF_ISOFile *the_file, u32 trackNumber, const char **outName)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak || !outName) return GF_BAD_PARAM;
 	*outName = trak->Media->handler->nameUTF8;
 	return GF_OK;
@@ -1437,7 +1438,7 @@ GF_EXPORT
 u32 gf_isom_get_sample_count(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak || !trak->Media->information->sampleTable->SampleSize) return 0;
 	return trak->Media->information->sampleTable->SampleSize->sampleCount
 #ifndef GPAC_DISABLE_ISOM_FRAGMENTS
@@ -1449,7 +1450,7 @@ u32 gf_isom_get_sample_count(GF_ISOFile *the_file, u32 trackNumber)
 u32 gf_isom_get_constant_sample_size(GF_ISOFile *the_file, u32 trackNumber)
 {
 	GF_TrackBox *trak;
-	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak) return 0;
 	return trak->Media->information->sampleTable->SampleSize->sampleSize;
 }
@@ -1550,6 +1551,139 @@ GF_ISOSample *gf_isom_get_sample(GF_ISOFile *the_file, u32 trackNumber, u32 samp
 	return samp;
 }
 
+GF_EXPORT
+GF_Err gf_isom_get_sample_into(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, GF_ISOSample *samp, u32 *sampleDescriptionIndex)
+{
+	GF_Err e;
+	u32 descIndex, size;
+	GF_TrackBox *trak;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !samp || !sampleNumber) return GF_BAD_PARAM;
+
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (sampleNumber<=trak->sample_count_at_seg_start)
+		return GF_BAD_PARAM;
+	sampleNumber -= trak->sample_count_at_seg_start;
+#endif
+
+	/*buffer of unknown size left by a sample rewrite, drop it*/
+	if (!samp->alloc_size && samp->data) {
+		gf_free(samp->data);
+		samp->data = NULL;
+	}
+	/*first use, allocate the buffer so that Media_GetSample reuses it*/
+	if (!samp->alloc_size) {
+		e = stbl_GetSampleSize(trak->Media->information->sampleTable->SampleSize, sampleNumber, &size);
+		if (e) return e;
+		if (size) {
+			samp->alloc_size = size + trak->padding_bytes;
+			samp->data = (char *) gf_malloc(sizeof(char) * samp->alloc_size);
+			if (!samp->data) {
+				samp->alloc_size = 0;
+				return GF_OUT_OF_MEM;
+			}
+		}
+	}
+	samp->dataLength = 0;
+	e = Media_GetSample(trak->Media, sampleNumber, &samp, &descIndex, GF_FALSE, NULL);
+	if (e) {
+		gf_isom_set_last_error(the_file, e);
+		return e;
+	}
+	if (sampleDescriptionIndex) *sampleDescriptionIndex = descIndex;
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	samp->DTS += trak->dts_at_seg_start;
+#endif
+	return GF_OK;
+}
+
+GF_EXPORT
+GF_Err gf_isom_get_sample_run(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber, u32 nb_samples, char *buffer, u32 buffer_size, u32 *nb_read, u32 *data_size)
+{
+	GF_Err e;
+	GF_TrackBox *trak;
+	GF_MediaBox *mdia;
+	GF_SampleEntryBox *entry;
+	GF_DataMap *map;
+	GF_ISOSample *samp;
+	u32 i, descIndex, first_di, dataRefIndex, size;
+	u64 offset, run_offset, file_size;
+
+	if (!nb_read || !data_size) return GF_BAD_PARAM;
+	*nb_read = *data_size = 0;
+	trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	if (!trak || !buffer || !sampleNumber || !nb_samples) return GF_BAD_PARAM;
+
+	mdia = trak->Media;
+	/*samples rewritten when fetched cannot be read as is*/
+	if (mdia->handler->handlerType == GF_ISOM_MEDIA_OD) return GF_NOT_SUPPORTED;
+	if (the_file->convert_streaming_text
+	        && ((mdia->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (mdia->handler->handlerType == GF_ISOM_MEDIA_SUBT)) )
+		return GF_NOT_SUPPORTED;
+
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (sampleNumber<=trak->sample_count_at_seg_start) return GF_BAD_PARAM;
+	sampleNumber -= trak->sample_count_at_seg_start;
+#endif
+
+	/*gather the run - in edit mode samples are read either from the original or from the edit file, hence the data map check*/
+	samp = gf_isom_sample_new();
+	if (!samp) return GF_OUT_OF_MEM;
+	e = GF_OK;
+	size = first_di = 0;
+	run_offset = 0;
+	map = NULL;
+	for (i=0; i<nb_samples; i++) {
+		e = Media_GetSample(mdia, sampleNumber+i, &samp, &descIndex, GF_TRUE, &offset);
+		if (e) break;
+		if (!i) {
+			e = Media_GetSampleDesc(mdia, descIndex, &entry, &dataRefIndex);
+			if (e) break;
+			if (gf_isom_is_nalu_based_entry(mdia, entry)) {
+				e = GF_NOT_SUPPORTED;
+				break;
+			}
+			if (samp->dataLength > buffer_size) {
+				e = GF_BUFFER_TOO_SMALL;
+				break;
+			}
+			first_di = descIndex;
+			run_offset = offset;
+			map = mdia->information->dataHandler;
+		} else if ((descIndex != first_di) || (map != mdia->information->dataHandler)
+		           || (offset != run_offset + size) || (size + samp->dataLength > buffer_size)) {
+			break;
+		}
+		size += samp->dataLength;
+		(*nb_read) ++;
+	}
+	gf_isom_sample_del(&samp);
+	/*errors past the first sample are reported by the next call*/
+	if (! *nb_read) {
+		if (!e) e = GF_BAD_PARAM;
+		gf_isom_set_last_error(the_file, e);
+		return e;
+	}
+
+	if (size) {
+		file_size = gf_bs_get_size(map->bs);
+		if (run_offset + size > file_size) {
+			file_size = gf_bs_get_refreshed_size(map->bs);
+			if (run_offset + size > file_size) {
+				*nb_read = 0;
+				mdia->BytesMissing = run_offset + size - file_size;
+				return GF_ISOM_INCOMPLETE_FILE;
+			}
+		}
+		if (gf_isom_datamap_get_data(map, buffer, size, run_offset) < size) {
+			*nb_read = 0;
+			return GF_IO_ERR;
+		}
+	}
+	*data_size = size;
+	return GF_OK;
+}
+
 GF_EXPORT
 u32 gf_isom_get_sample_duration(GF_ISOFile *the_file, u32 trackNumber, u32 sampleNumber)
 {
@@ -3027,7 +3161,7 @@ GF_Err gf_isom_get_visual_info(GF_ISOFile *movie, u32 trackNumber, u32 StreamDes
 	GF_SampleEntryBox *entry;
 	GF_SampleDescriptionBox *stsd;
 
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return GF_BAD_PARAM;
 
 	stsd = trak->Media->information->sampleTable->SampleDescription;
@@ -3058,7 +3192,7 @@ GF_Err gf_isom_get_audio_info(GF_ISOFile *movie, u32 trackNumber, u32 StreamDesc
 	GF_SampleEntryBox *entry;
 	GF_SampleDescriptionBox *stsd;
 
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak) return GF_BAD_PARAM;
 
 	stsd = trak->Media->information->sampleTable->SampleDescription;
@@ -3085,7 +3219,7 @@ GF_Err gf_isom_get_pixel_aspect_ratio(GF_ISOFile *movie, u32 trackNumber, u32 St
 	GF_VisualSampleEntryBox *entry;
 	GF_SampleDescriptionBox *stsd;
 
-	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	trak = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!trak || !hSpacing || !vSpacing) return GF_BAD_PARAM;
 	*hSpacing = 1;
 	*vSpacing = 1;
@@ -3152,7 +3286,7 @@ u8 gf_isom_get_pl_indication(GF_ISOFile *movie, u8 PL_Code)
 GF_EXPORT
 GF_Err gf_isom_get_track_matrix(GF_ISOFile *the_file, u32 trackNumber, u32 matrix[9])
 {
-	GF_TrackBox *trak = gf_isom_get_track_from_file(the_file, trackNumber);
+	GF_TrackBox *trak = gf_isom_get_track_from_file_ex(the_file, trackNumber, GF_FALSE);
 	if (!trak || !trak->Header) return GF_BAD_PARAM;
 	memcpy(matrix, trak->Header->matrix, sizeof(trak->Header->matrix));
 	return GF_OK;
@@ -3161,7 +3295,7 @@ GF_Err gf_isom_get_track_matrix(GF_ISOFile *the_file, u32 trackNumber, u32 matri
 GF_EXPORT
 GF_Err gf_isom_get_track_layout_info(GF_ISOFile *movie, u32 trackNumber, u32 *width, u32 *height, s32 *translation_x, s32 *translation_y, s16 *layer)
 {
-	GF_TrackBox *tk = gf_isom_get_track_from_file(movie, trackNumber);
+	GF_TrackBox *tk = gf_isom_get_track_from_file_ex(movie, trackNumber, GF_FALSE);
 	if (!tk) return GF_BAD_PARAM;
 	if (width) *width = tk->Header->width>>16;
 	if (height) *height = tk->Header->height>>16;
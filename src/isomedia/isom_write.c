@@ -507,6 +507,7 @@ u32 gf_isom_new_track(GF_ISOFile *movie, u32 trakID, u32 MediaType, u32 TimeScal
 	GF_TrackBox *trak;
 	GF_TrackHeaderBox *tkhd;
 	GF_MediaBox *mdia;
+	Bool auto_track_id;
 
 	e = CanAccessMovie(movie, GF_ISOM_OPEN_WRITE);
 	if (e) {
@@ -515,6 +516,8 @@ u32 gf_isom_new_track(GF_ISOFile *movie, u32 trakID, u32 MediaType, u32 TimeScal
 	}
 	gf_isom_insert_moov(movie);
 
+	auto_track_id = trakID ? GF_FALSE : GF_TRUE;
+
 
 	isHint = 0;
 	//we're creating a hint track... it's the same, but mode HAS TO BE EDIT
@@ -587,6 +590,7 @@ u32 gf_isom_new_track(GF_ISOFile *movie, u32 trakID, u32 MediaType, u32 TimeScal
 	e = trak_AddBox((GF_Box*)trak, (GF_Box *) mdia);
 	if (e) goto err_exit;
 	tkhd->trackID = trakID;
+	trak->auto_track_id = auto_track_id;
 
 
 	//some default properties for Audio, Visual or private tracks
@@ -743,6 +747,301 @@ GF_Err gf_isom_add_sample(GF_ISOFile *movie, u32 trackNumber, u32 StreamDescript
 	return SetTrackDuration(trak);
 }
 
+/*max amount of media data read and written at once by gf_isom_copy_sample_run*/
+#define GF_ISOM_SAMPLE_RUN_MAX_SIZE	0x200000
+
+GF_EXPORT
+GF_Err gf_isom_copy_sample_run(GF_ISOFile *dest, u32 dst_track, GF_ISOFile *orig, u32 orig_track, u32 sampleNumber, u32 nb_samples, Double ts_scale, u64 dts_shift, u32 *nb_copied)
+{
+	GF_Err e;
+	GF_TrackBox *trak, *src_trak;
+	GF_MediaBox *src_mdia;
+	GF_SampleEntryBox *entry, *src_entry;
+	GF_DataEntryURLBox *Dentry;
+	GF_DataMap *map;
+	GF_ISOSample *samp, *infos;
+	Bool is_nalu;
+	char *data;
+	u32 i, count, alloc, descIndex, first_di, dataRefIndex, run_size, pos, first_sample;
+	u64 offset, run_offset, data_offset;
+
+	if (!nb_copied) return GF_BAD_PARAM;
+	*nb_copied = 0;
+	if (!nb_samples) return GF_OK;
+
+	e = CanAccessMovie(dest, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+	trak = gf_isom_get_track_from_file(dest, dst_track);
+	src_trak = gf_isom_get_track_from_file(orig, orig_track);
+	if (!trak || !src_trak) return GF_BAD_PARAM;
+
+	if (orig == dest) return GF_NOT_SUPPORTED;
+
+	src_mdia = src_trak->Media;
+	/*samples rewritten when fetched cannot be copied as is*/
+	if (src_mdia->handler->handlerType == GF_ISOM_MEDIA_OD) return GF_NOT_SUPPORTED;
+	if (orig->convert_streaming_text
+	        && ((src_mdia->handler->handlerType == GF_ISOM_MEDIA_TEXT) || (src_mdia->handler->handlerType == GF_ISOM_MEDIA_SUBT)) )
+		return GF_NOT_SUPPORTED;
+
+	first_sample = sampleNumber;
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (sampleNumber<=src_trak->sample_count_at_seg_start) return GF_BAD_PARAM;
+	sampleNumber -= src_trak->sample_count_at_seg_start;
+#endif
+
+	/*gather the longest run of samples contiguous in the source file and sharing the same sample description
+	samples of files opened in edit mode are read either from the original or from the edit file, hence the data map check*/
+	samp = gf_isom_sample_new();
+	if (!samp) return GF_OUT_OF_MEM;
+	infos = NULL;
+	data = NULL;
+	alloc = count = run_size = 0;
+	first_di = 0;
+	run_offset = 0;
+	map = NULL;
+	for (i=0; i<nb_samples; i++) {
+		e = Media_GetSample(src_mdia, sampleNumber+i, &samp, &descIndex, GF_TRUE, &offset);
+		if (e) break;
+		if (!i) {
+			first_di = descIndex;
+			run_offset = offset;
+			map = src_mdia->information->dataHandler;
+		} else if ((descIndex != first_di) || (map != src_mdia->information->dataHandler)
+		           || (offset != run_offset + run_size) || (run_size + samp->dataLength > GF_ISOM_SAMPLE_RUN_MAX_SIZE)) {
+			break;
+		}
+		if (count==alloc) {
+			alloc = alloc ? 2*alloc : 64;
+			infos = (GF_ISOSample *)gf_realloc(infos, sizeof(GF_ISOSample) * alloc);
+			if (!infos) {
+				e = GF_OUT_OF_MEM;
+				break;
+			}
+		}
+		infos[count] = *samp;
+		count++;
+		run_size += samp->dataLength;
+	}
+	gf_isom_sample_del(&samp);
+	if (!count) {
+		if (infos) gf_free(infos);
+		return e ? e : GF_BAD_PARAM;
+	}
+	/*errors past the first sample are reported by the next call*/
+
+	/*only copy from self-contained sample descriptions whose samples are not rewritten*/
+	e = Media_GetSampleDesc(src_mdia, first_di, &src_entry, &dataRefIndex);
+	if (e) goto exit;
+	if (!src_entry || !dataRefIndex) {
+		e = GF_BAD_PARAM;
+		goto exit;
+	}
+	Dentry = (GF_DataEntryURLBox*)gf_list_get(src_mdia->information->dataInformation->dref->other_boxes, dataRefIndex - 1);
+	if (!Dentry || Dentry->flags != 1) {
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+	is_nalu = gf_isom_is_nalu_based_entry(src_mdia, src_entry);
+	if (is_nalu && gf_isom_nalu_sample_rewrite_changes_data(src_mdia, (GF_MPEGVisualSampleEntryBox *)src_entry)) {
+		e = GF_NOT_SUPPORTED;
+		goto exit;
+	}
+
+	/*read the whole run at once*/
+	if (run_size) {
+		u64 file_size = gf_bs_get_size(map->bs);
+		if (run_offset + run_size > file_size) {
+			file_size = gf_bs_get_refreshed_size(map->bs);
+			if (run_offset + run_size > file_size) {
+				e = GF_ISOM_INCOMPLETE_FILE;
+				goto exit;
+			}
+		}
+		data = (char *)gf_malloc(sizeof(char) * run_size);
+		if (!data) {
+			e = GF_OUT_OF_MEM;
+			goto exit;
+		}
+		if (gf_isom_datamap_get_data(map, data, run_size, run_offset) < run_size) {
+			e = GF_IO_ERR;
+			goto exit;
+		}
+	}
+
+	/*and write it in a single call, setup is the same as gf_isom_add_sample*/
+	e = FlushCaptureMode(dest);
+	if (e) goto exit;
+	e = unpack_track(trak);
+	if (e) goto exit;
+	e = Media_GetSampleDesc(trak->Media, first_di, &entry, &dataRefIndex);
+	if (e) goto exit;
+	if (!entry || !dataRefIndex) {
+		e = GF_BAD_PARAM;
+		goto exit;
+	}
+	trak->Media->information->sampleTable->currentEntryIndex = first_di;
+	Dentry = (GF_DataEntryURLBox*)gf_list_get(trak->Media->information->dataInformation->dref->other_boxes, dataRefIndex - 1);
+	if (!Dentry || Dentry->flags != 1) {
+		e = GF_BAD_PARAM;
+		goto exit;
+	}
+	e = gf_isom_datamap_open(trak->Media, dataRefIndex, 1);
+	if (e) goto exit;
+	data_offset = gf_isom_datamap_get_offset(trak->Media->information->dataHandler);
+	if (run_size) {
+		e = gf_isom_datamap_add_data(trak->Media->information->dataHandler, data, run_size);
+		if (e) goto exit;
+	}
+
+	pos = 0;
+	for (i=0; i<count; i++) {
+		GF_ISOSample *s = &infos[i];
+		s->data = data ? data + pos : NULL;
+		/*NALU samples may be flagged as RAP by inspecting their payload, which is left untouched here*/
+		if (is_nalu) {
+			e = gf_isom_nalu_sample_rewrite(src_mdia, s, sampleNumber+i, (GF_MPEGVisualSampleEntryBox *)src_entry);
+			if (e) goto exit;
+		}
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+		s->DTS += src_trak->dts_at_seg_start;
+#endif
+		s->DTS = (u64) (ts_scale * s->DTS + dts_shift);
+		s->CTS_Offset = (u32) (s->CTS_Offset * ts_scale);
+
+		e = Media_AddSample(trak->Media, data_offset + pos, s, first_di, 0);
+		if (e) goto exit;
+		pos += s->dataLength;
+
+		e = gf_isom_copy_sample_info(dest, dst_track, orig, orig_track, first_sample+i);
+		if (e) goto exit;
+	}
+	*nb_copied = count;
+
+	if (!dest->keep_utc)
+		trak->Media->mediaHeader->modificationTime = gf_isom_get_mp4time();
+	e = SetTrackDuration(trak);
+
+exit:
+	if (data) gf_free(data);
+	gf_free(infos);
+	return e;
+}
+
+GF_EXPORT
+GF_Err gf_isom_add_samples_batch(GF_ISOFile *movie, u32 trackNumber, u32 StreamDescriptionIndex, const GF_ISOBatchSample *samples, u32 nb_samples)
+{
+	GF_Err e;
+	GF_TrackBox *trak;
+	GF_SampleEntryBox *entry;
+	GF_DataEntryURLBox *Dentry;
+	GF_ISOSample samp;
+	Bool self_contained;
+	const char *pending;
+	u32 i, dataRefIndex, descIndex, pending_size;
+	u64 data_offset;
+
+	if (!nb_samples) return GF_OK;
+	if (!samples) return GF_BAD_PARAM;
+
+	e = CanAccessMovie(movie, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+
+	trak = gf_isom_get_track_from_file(movie, trackNumber);
+	if (!trak) return GF_BAD_PARAM;
+
+	memset(&samp, 0, sizeof(GF_ISOSample));
+	/*OD frames are rewritten one by one*/
+	if (trak->Media->handler->handlerType == GF_ISOM_MEDIA_OD) {
+		for (i=0; i<nb_samples; i++) {
+			samp.dataLength = samples[i].dataLength;
+			samp.data = (char *) samples[i].data;
+			samp.DTS = samples[i].DTS;
+			samp.CTS_Offset = samples[i].CTS_Offset;
+			samp.IsRAP = samples[i].IsRAP;
+			e = gf_isom_add_sample(movie, trackNumber, StreamDescriptionIndex, &samp);
+			if (e) return e;
+		}
+		return GF_OK;
+	}
+
+	e = FlushCaptureMode(movie);
+	if (e) return e;
+
+	e = unpack_track(trak);
+	if (e) return e;
+
+	descIndex = StreamDescriptionIndex;
+	if (!StreamDescriptionIndex) {
+		descIndex = trak->Media->information->sampleTable->currentEntryIndex;
+	}
+	e = Media_GetSampleDesc(trak->Media, descIndex, &entry, &dataRefIndex);
+	if (e) return e;
+	if (!entry || !dataRefIndex) return GF_BAD_PARAM;
+	trak->Media->information->sampleTable->currentEntryIndex = descIndex;
+
+	Dentry = (GF_DataEntryURLBox*)gf_list_get(trak->Media->information->dataInformation->dref->other_boxes, dataRefIndex - 1);
+	if (!Dentry) return GF_BAD_PARAM;
+	self_contained = (Dentry->flags == 1) ? GF_TRUE : GF_FALSE;
+
+	data_offset = 0;
+	if (self_contained) {
+		e = gf_isom_datamap_open(trak->Media, dataRefIndex, 1);
+		if (e) return e;
+		data_offset = gf_isom_datamap_get_offset(trak->Media->information->dataHandler);
+	}
+
+	e = stbl_ReserveSamples(trak->Media->information->sampleTable, nb_samples);
+	if (e) return e;
+
+	pending = NULL;
+	pending_size = 0;
+	for (i=0; i<nb_samples; i++) {
+		const GF_ISOBatchSample *s = &samples[i];
+		samp.dataLength = s->dataLength;
+		samp.DTS = s->DTS;
+		samp.CTS_Offset = s->CTS_Offset;
+		samp.IsRAP = s->IsRAP;
+
+		if (!self_contained) {
+			e = Media_AddSample(trak->Media, s->dataOffset, &samp, descIndex, 0);
+			if (e) break;
+			continue;
+		}
+		if (s->dataLength && !s->data) {
+			e = GF_BAD_PARAM;
+			break;
+		}
+		e = Media_AddSample(trak->Media, data_offset, &samp, descIndex, 0);
+		if (e) break;
+		data_offset += s->dataLength;
+
+		if (!s->dataLength) continue;
+		/*merge payloads contiguous in memory in a single write*/
+		if (pending && (pending + pending_size == s->data)) {
+			pending_size += s->dataLength;
+			continue;
+		}
+		if (pending) {
+			e = gf_isom_datamap_add_data(trak->Media->information->dataHandler, (char *) pending, pending_size);
+			pending = NULL;
+			if (e) break;
+		}
+		pending = s->data;
+		pending_size = s->dataLength;
+	}
+	/*always flush data of the samples already added*/
+	if (pending) {
+		GF_Err wr_e = gf_isom_datamap_add_data(trak->Media->information->dataHandler, (char *) pending, pending_size);
+		if (!e) e = wr_e;
+	}
+	if (e) return e;
+
+	if (!movie->keep_utc)
+		trak->Media->mediaHeader->modificationTime = gf_isom_get_mp4time();
+	return SetTrackDuration(trak);
+}
+
 GF_Err gf_isom_add_sample_shadow(GF_ISOFile *movie, u32 trackNumber, GF_ISOSample *sample)
 {
 	GF_Err e;
@@ -2897,6 +3196,239 @@ GF_Err gf_isom_clone_track(GF_ISOFile *orig_file, u32 orig_track, GF_ISOFile *de
 	return GF_OK;
 }
 
+static Bool track_can_be_moved(GF_TrackBox *trak)
+{
+	u32 i;
+	GF_SampleTableBox *stbl;
+	if (!trak->Media || !trak->Media->information || !trak->Media->information->sampleTable) return GF_FALSE;
+	/*aux info offsets and sample encryption are not relocated*/
+	stbl = trak->Media->information->sampleTable;
+	if (trak->sample_encryption || (stbl->sai_offsets && gf_list_count(stbl->sai_offsets))) return GF_FALSE;
+	/*only self-contained media*/
+	for (i=0; i<gf_list_count(trak->Media->information->dataInformation->dref->other_boxes); i++) {
+		GF_DataEntryBox *ent = (GF_DataEntryBox *)gf_list_get(trak->Media->information->dataInformation->dref->other_boxes, i);
+		if (ent->flags != 1) return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+/*checks a track ID is neither used in the destination movie nor already given to a moved track*/
+static Bool move_tracks_id_available(GF_ISOFile *dest, u32 *id_map, u32 nb_ids, u32 trakID)
+{
+	u32 i;
+	if (dest->moov && !RequestTrack(dest->moov, trakID)) return GF_FALSE;
+	for (i=0; i<nb_ids; i++) {
+		if (id_map[2*i+1] == trakID) return GF_FALSE;
+	}
+	return GF_TRUE;
+}
+
+GF_EXPORT
+GF_Err gf_isom_move_tracks(GF_ISOFile *dest, GF_ISOFile *src)
+{
+	u32 i, j, k, count, next_id, *id_map;
+	u64 base_offset, src_size, pos;
+	GF_Box **co64_boxes;
+	char *buffer;
+	GF_Err e;
+
+	if (!dest || !src || !src->moov) return GF_BAD_PARAM;
+	if ((dest->openMode != GF_ISOM_OPEN_EDIT) && (dest->openMode != GF_ISOM_WRITE_EDIT)) return GF_ISOM_INVALID_MODE;
+	if ((src->openMode != GF_ISOM_OPEN_EDIT) && (src->openMode != GF_ISOM_WRITE_EDIT)) return GF_ISOM_INVALID_MODE;
+	e = CanAccessMovie(dest, GF_ISOM_OPEN_WRITE);
+	if (e) return e;
+
+	/*check we only have tracks to move: no root OD, movie-level user data, time scale change*/
+	if (src->moov->udta || src->moov->meta || gf_list_count(src->moov->other_boxes)) return GF_NOT_SUPPORTED;
+#ifndef	GPAC_DISABLE_ISOM_FRAGMENTS
+	if (src->moov->mvex) return GF_NOT_SUPPORTED;
+#endif
+	if (src->moov->iods && src->moov->iods->descriptor) {
+		GF_IsomInitialObjectDescriptor *iod = (GF_IsomInitialObjectDescriptor *)src->moov->iods->descriptor;
+		if (gf_list_count(iod->ES_ID_IncDescriptors) || gf_list_count(iod->ES_ID_RefDescriptors)) return GF_NOT_SUPPORTED;
+	}
+	count = gf_list_count(src->moov->trackList);
+	if (!count) return GF_OK;
+	for (i=0; i<count; i++) {
+		if (!track_can_be_moved(gf_list_get(src->moov->trackList, i))) return GF_NOT_SUPPORTED;
+	}
+	if (dest->moov && (src->moov->mvhd->timeScale != dest->moov->mvhd->timeScale)) return GF_NOT_SUPPORTED;
+
+	/*everything that may fail is done before modifying any of the two files: allocate the new track IDs, keeping them
+	if requested by the importer and available, otherwise allocating a new one as gf_isom_new_track does*/
+	id_map = (u32*)gf_malloc(sizeof(u32) * 2 * count);
+	if (!id_map) return GF_OUT_OF_MEM;
+	next_id = dest->moov ? dest->moov->mvhd->nextTrackID : 1;
+	for (i=0; i<count; i++) {
+		GF_TrackBox *trak = (GF_TrackBox*)gf_list_get(src->moov->trackList, i);
+		u32 trakID = trak->Header->trackID;
+		if (trak->auto_track_id || !move_tracks_id_available(dest, id_map, i, trakID)) {
+			trakID = next_id;
+			if (!trakID) trakID = 1;
+			if (trak->Media->handler->handlerType != GF_ISOM_MEDIA_HINT) {
+				if (trakID > 0xFFFF) trakID = 1;
+			}
+			while (!move_tracks_id_available(dest, id_map, i, trakID)) {
+				trakID += 1;
+				if (trakID == 0xFFFFFFFF) {
+					gf_free(id_map);
+					return GF_BAD_PARAM;
+				}
+			}
+		}
+		id_map[2*i] = trak->Header->trackID;
+		id_map[2*i+1] = trakID;
+		if (trakID+1 > next_id) next_id = trakID+1;
+	}
+
+	/*32 bit chunk offsets going past 4GB once the media data is appended are replaced by 64 bit ones*/
+	base_offset = gf_isom_datamap_get_offset(dest->editFileMap);
+	co64_boxes = (GF_Box **)gf_malloc(sizeof(GF_Box *) * count);
+	if (!co64_boxes) {
+		gf_free(id_map);
+		return GF_OUT_OF_MEM;
+	}
+	for (i=0; i<count; i++) {
+		GF_TrackBox *trak = (GF_TrackBox*)gf_list_get(src->moov->trackList, i);
+		GF_SampleTableBox *stbl = trak->Media->information->sampleTable;
+		co64_boxes[i] = NULL;
+		if (stbl->ChunkOffset && (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO)) {
+			GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+			GF_ChunkLargeOffsetBox *co64;
+			Bool needs_co64 = GF_FALSE;
+			for (j=0; j<stco->nb_entries; j++) {
+				if (stco->offsets[j] + base_offset > 0xFFFFFFFF) needs_co64 = GF_TRUE;
+			}
+			if (!needs_co64) continue;
+			co64 = (GF_ChunkLargeOffsetBox *) gf_isom_box_new(GF_ISOM_BOX_TYPE_CO64);
+			if (co64) {
+				co64->offsets = (u64*)gf_malloc(sizeof(u64) * stco->nb_entries);
+				if (!co64->offsets) {
+					gf_isom_box_del((GF_Box *)co64);
+					co64 = NULL;
+				}
+			}
+			if (!co64) {
+				for (k=0; k<i; k++) {
+					if (co64_boxes[k]) gf_isom_box_del(co64_boxes[k]);
+				}
+				gf_free(co64_boxes);
+				gf_free(id_map);
+				return GF_OUT_OF_MEM;
+			}
+			co64->nb_entries = co64->alloc_size = stco->nb_entries;
+			for (j=0; j<stco->nb_entries; j++) co64->offsets[j] = stco->offsets[j] + base_offset;
+			co64_boxes[i] = (GF_Box *)co64;
+		}
+	}
+
+	/*append media data. On failure, the data already appended to the destination edit data is not referenced by any track*/
+	gf_isom_datamap_flush(src->editFileMap);
+	src_size = gf_isom_datamap_get_offset(src->editFileMap);
+	buffer = (char*)gf_malloc(sizeof(char) * 1024 * 1024);
+	e = buffer ? GF_OK : GF_OUT_OF_MEM;
+	pos = 0;
+	while (!e && (pos < src_size)) {
+		u32 size = (u32) MIN(src_size - pos, 1024 * 1024);
+		if (gf_isom_datamap_get_data(src->editFileMap, buffer, size, pos) != size) {
+			e = GF_IO_ERR;
+			break;
+		}
+		e = gf_isom_datamap_add_data(dest->editFileMap, buffer, size);
+		pos += size;
+	}
+	if (buffer) gf_free(buffer);
+	if (e) {
+		for (i=0; i<count; i++) {
+			if (co64_boxes[i]) gf_isom_box_del(co64_boxes[i]);
+		}
+		gf_free(co64_boxes);
+		gf_free(id_map);
+		return e;
+	}
+
+	/*nothing can fail from here*/
+	if (!dest->moov) {
+		/*same as importing in a new movie*/
+		gf_isom_insert_moov(dest);
+		gf_isom_set_timescale(dest, src->moov->mvhd->timeScale);
+	}
+
+	/*movie-level changes done while importing: brands and PLs*/
+	if (src->brand) {
+		if ((src->brand->majorBrand != GF_ISOM_BRAND_ISOM) || (src->brand->minorVersion != 1))
+			gf_isom_set_brand_info(dest, src->brand->majorBrand, src->brand->minorVersion);
+		for (i=0; i<src->brand->altCount; i++) {
+			if (src->brand->altBrand[i] == GF_ISOM_BRAND_ISOM) break;
+		}
+		if (i==src->brand->altCount) gf_isom_modify_alternate_brand(dest, GF_ISOM_BRAND_ISOM, 0);
+		for (i=0; i<src->brand->altCount; i++) {
+			if (src->brand->altBrand[i] == GF_ISOM_BRAND_ISOM) continue;
+			gf_isom_modify_alternate_brand(dest, src->brand->altBrand[i], 1);
+		}
+	}
+	if (src->moov->iods && src->moov->iods->descriptor) {
+		u8 pl_types[] = {GF_ISOM_PL_AUDIO, GF_ISOM_PL_VISUAL, GF_ISOM_PL_GRAPHICS, GF_ISOM_PL_SCENE, GF_ISOM_PL_OD};
+		for (i=0; i<sizeof(pl_types); i++) {
+			u8 PL = gf_isom_get_pl_indication(src, pl_types[i]);
+			if ((PL != 0xFF) || !dest->moov->iods) gf_isom_set_pl_indication(dest, pl_types[i], PL);
+		}
+	}
+
+	/*move tracks*/
+	for (i=0; i<count; i++) {
+		GF_SampleTableBox *stbl;
+		GF_TrackBox *trak = (GF_TrackBox*)gf_list_get(src->moov->trackList, 0);
+		trak->Header->trackID = id_map[2*i+1];
+
+		gf_list_rem(src->moov->trackList, 0);
+		moov_AddBox((GF_Box*)dest->moov, (GF_Box *)trak);
+		if (trak->Header->trackID+1 > dest->moov->mvhd->nextTrackID)
+			dest->moov->mvhd->nextTrackID = trak->Header->trackID+1;
+
+		/*data is now in the destination edit map*/
+		trak->Media->information->dataHandler = NULL;
+		trak->Media->information->dataEntryIndex = 0;
+
+		stbl = trak->Media->information->sampleTable;
+		if (co64_boxes[i]) {
+			gf_isom_box_del(stbl->ChunkOffset);
+			stbl->ChunkOffset = co64_boxes[i];
+		} else if (stbl->ChunkOffset && (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO)) {
+			GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+			for (j=0; j<stco->nb_entries; j++) stco->offsets[j] += (u32) base_offset;
+		} else if (stbl->ChunkOffset) {
+			GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+			for (j=0; j<co64->nb_entries; j++) co64->offsets[j] += base_offset;
+		}
+		if (!dest->keep_utc)
+			trak->Media->mediaHeader->modificationTime = gf_isom_get_mp4time();
+		SetTrackDuration(trak);
+	}
+	gf_free(co64_boxes);
+
+	/*remap track references between moved tracks*/
+	for (i=0; i<count; i++) {
+		GF_TrackReferenceTypeBox *ref;
+		GF_TrackBox *trak = gf_list_get(dest->moov->trackList, gf_list_count(dest->moov->trackList) - count + i);
+		if (!trak->References) continue;
+		j=0;
+		while ((ref = (GF_TrackReferenceTypeBox *)gf_list_enum(trak->References->other_boxes, &j))) {
+			u32 l;
+			for (l=0; l<ref->trackIDCount; l++) {
+				for (k=0; k<count; k++) {
+					if (ref->trackIDs[l] == id_map[2*k]) {
+						ref->trackIDs[l] = id_map[2*k+1];
+						break;
+					}
+				}
+			}
+		}
+	}
+	gf_free(id_map);
+	return GF_OK;
+}
+
 GF_Err gf_isom_clone_sample_descriptions(GF_ISOFile *the_file, u32 trackNumber, GF_ISOFile *orig_file, u32 orig_track, Bool reset_existing)
 {
 	u32 i;
@@ -2985,7 +3517,7 @@ exit:
 	return e;
 }
 
-
+GF_EXPORT
 GF_Err gf_isom_new_generic_sample_description(GF_ISOFile *movie, u32 trackNumber, char *URLname, char *URNname, GF_GenericSampleDescription *udesc, u32 *outDescriptionIndex)
 {
 	GF_TrackBox *trak;
@@ -3304,6 +3836,7 @@ GF_Err gf_isom_set_track_id(GF_ISOFile *movie, u32 trackNumber, u32 trackID)
 
 	if (movie->moov->mvhd->nextTrackID<=trackID)
 		movie->moov->mvhd->nextTrackID = trackID;
+	trak->auto_track_id = GF_FALSE;
 
 	/*rewrite all dependencies*/
 	i=0;
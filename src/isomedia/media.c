@@ -354,6 +354,11 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	GF_SampleEntryBox *entry;
 
 	if (!mdia || !mdia->information->sampleTable) return GF_BAD_PARAM;
+	//referenced tracks (hint, scalable, ...) may not have been accessed yet
+	if (mdia->information->sampleTable->lazy_offsets) {
+		e = Track_LoadSampleTables(mdia->mediaTrack);
+		if (e) return e;
+	}
 	if (!mdia->information->sampleTable->SampleSize)
 		return GF_ISOM_INVALID_FILE;
 
@@ -432,9 +437,19 @@ GF_Err Media_GetSample(GF_MediaBox *mdia, u32 sampleNumber, GF_ISOSample **samp,
 	if (out_offset) *out_offset = offset;
 	if (no_data) return GF_OK;
 	if ((*samp)->dataLength != 0) {
-
-		/*and finally get the data, include padding if needed*/
-		(*samp)->data = (char *) gf_malloc(sizeof(char) * ( (*samp)->dataLength + mdia->mediaTrack->padding_bytes) );
+		u32 data_size = (*samp)->dataLength + mdia->mediaTrack->padding_bytes;
+
+		/*and finally get the data, include padding if needed - reuse the buffer of samples fetched with gf_isom_get_sample_into*/
+		if ((*samp)->alloc_size) {
+			if ((*samp)->alloc_size < data_size) {
+				gf_free((*samp)->data);
+				(*samp)->data = (char *) gf_malloc(sizeof(char) * data_size);
+				(*samp)->alloc_size = (*samp)->data ? data_size : 0;
+			}
+		} else {
+			(*samp)->data = (char *) gf_malloc(sizeof(char) * data_size);
+		}
+		if (!(*samp)->data) return GF_OUT_OF_MEM;
 		if (mdia->mediaTrack->padding_bytes)
 			memset((*samp)->data + (*samp)->dataLength, 0, sizeof(char) * mdia->mediaTrack->padding_bytes);
 
@@ -217,6 +217,7 @@ GF_Err Media_RewriteODFrame(GF_MediaBox *mdia, GF_ISOSample *sample)
 	gf_free(sample->data);
 	sample->data = NULL;
 	sample->dataLength = 0;
+	sample->alloc_size = 0;
 	e = gf_odf_codec_get_au(ODencode, &sample->data, &sample->dataLength);
 
 err_exit:
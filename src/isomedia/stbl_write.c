@@ -691,6 +691,67 @@ GF_Err stbl_AddChunkOffset(GF_MediaBox *mdia, u32 sampleNumber, u32 StreamDescIn
 	return GF_OK;
 }
 
+/*computes the new allocated size of a table to hold nb_items items, growing geometrically*/
+static u32 stbl_GetReserveSize(u32 alloc_size, u32 nb_items)
+{
+	u32 new_size = alloc_size;
+	if (nb_items <= alloc_size) return alloc_size;
+	ALLOC_INC(new_size);
+	if (new_size < nb_items) new_size = nb_items;
+	return new_size;
+}
+
+//used in edit/write before appending nb_samples samples (one chunk per sample), so that sizes and chunk tables are not reallocated
+GF_Err stbl_ReserveSamples(GF_SampleTableBox *stbl, u32 nb_samples)
+{
+	u32 size;
+	GF_SampleSizeBox *stsz = stbl->SampleSize;
+	GF_SampleToChunkBox *stsc = stbl->SampleToChunk;
+
+	/*sizes are only allocated once samples with different sizes are found*/
+	if (stsz->sizes) {
+		if (!stsz->alloc_size) stsz->alloc_size = stsz->sampleCount;
+		size = stbl_GetReserveSize(stsz->alloc_size, stsz->sampleCount + nb_samples);
+		if (size != stsz->alloc_size) {
+			stsz->sizes = (u32*)gf_realloc(stsz->sizes, sizeof(u32) * size);
+			if (!stsz->sizes) return GF_OUT_OF_MEM;
+			memset(&stsz->sizes[stsz->sampleCount], 0, sizeof(u32) * (size - stsz->sampleCount) );
+			stsz->alloc_size = size;
+		}
+	}
+
+	if (stbl->ChunkOffset->type == GF_ISOM_BOX_TYPE_STCO) {
+		GF_ChunkOffsetBox *stco = (GF_ChunkOffsetBox *)stbl->ChunkOffset;
+		if (!stco->alloc_size) stco->alloc_size = stco->nb_entries;
+		size = stbl_GetReserveSize(stco->alloc_size, stco->nb_entries + nb_samples);
+		if (size != stco->alloc_size) {
+			stco->offsets = (u32*)gf_realloc(stco->offsets, sizeof(u32) * size);
+			if (!stco->offsets) return GF_OUT_OF_MEM;
+			memset(&stco->offsets[stco->nb_entries], 0, sizeof(u32) * (size - stco->nb_entries) );
+			stco->alloc_size = size;
+		}
+	} else {
+		GF_ChunkLargeOffsetBox *co64 = (GF_ChunkLargeOffsetBox *)stbl->ChunkOffset;
+		if (!co64->alloc_size) co64->alloc_size = co64->nb_entries;
+		size = stbl_GetReserveSize(co64->alloc_size, co64->nb_entries + nb_samples);
+		if (size != co64->alloc_size) {
+			co64->offsets = (u64*)gf_realloc(co64->offsets, sizeof(u64) * size);
+			if (!co64->offsets) return GF_OUT_OF_MEM;
+			memset(&co64->offsets[co64->nb_entries], 0, sizeof(u64) * (size - co64->nb_entries) );
+			co64->alloc_size = size;
+		}
+	}
+
+	size = stbl_GetReserveSize(stsc->alloc_size, stsc->nb_entries + nb_samples);
+	if (size != stsc->alloc_size) {
+		stsc->entries = (GF_StscEntry*)gf_realloc(stsc->entries, sizeof(GF_StscEntry) * size);
+		if (!stsc->entries) return GF_OUT_OF_MEM;
+		memset(&stsc->entries[stsc->nb_entries], 0, sizeof(GF_StscEntry) * (size - stsc->nb_entries) );
+		stsc->alloc_size = size;
+	}
+	return GF_OK;
+}
+
 
 
 
@@ -49,6 +49,17 @@ GF_TrackBox *gf_isom_get_track(GF_MovieBox *moov, u32 trackNumber)
 
 }
 
+//parse the sample tables left aside when opening the file in GF_ISOM_OPEN_READ_LAZY mode
+GF_Err Track_LoadSampleTables(GF_TrackBox *trak)
+{
+	GF_SampleTableBox *stbl;
+	if (!trak || !trak->Media || !trak->Media->information) return GF_BAD_PARAM;
+	stbl = trak->Media->information->sampleTable;
+	if (!stbl || !stbl->lazy_offsets) return GF_OK;
+	if (!trak->moov || !trak->moov->mov || !trak->moov->mov->movieFileMap) return GF_BAD_PARAM;
+	return stbl_LoadLazyBoxes(stbl, trak->moov->mov->movieFileMap->bs);
+}
+
 //get the number of a track given its ID
 //return 0 if not found error
 u32 gf_isom_get_tracknum_from_id(GF_MovieBox *moov, u32 trackID)
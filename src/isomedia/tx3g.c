@@ -704,6 +704,7 @@ GF_Err gf_isom_rewrite_text_sample(GF_ISOSample *samp, u32 sampleDescriptionInde
 
 	gf_free(samp->data);
 	samp->data = NULL;
+	samp->alloc_size = 0;
 	gf_bs_get_content(bs, &samp->data, &samp->dataLength);
 	gf_bs_del(bs);
 	return GF_OK;
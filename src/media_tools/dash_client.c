@@ -43,6 +43,7 @@
 
 /*ISO 639 languages*/
 #include <gpac/iso639.h>
+#include <gpac/trace.h>
 
 /*set to 1 if you want MPD to use SegmentTemplate if possible instead of SegmentList*/
 #define M3U8_TO_MPD_USE_TEMPLATE	0
@@ -178,6 +179,8 @@ typedef struct
 	char *key_url;
 	bin128 key_IV;
 	Bool has_dep_following;
+	/*ID of the trace flow from download to consumption of the segment*/
+	u32 trace_flow_id;
 } segment_cache_entry;
 
 typedef enum
@@ -241,6 +244,8 @@ struct __dash_group
 	char * urlToDeleteNext;
 	volatile u32 max_cached_segments, nb_cached_segments, max_buffer_segments;
 	segment_cache_entry *cached;
+	/*number of segments added to the cache, used for trace flow IDs*/
+	u32 nb_segments_cached;
 
 	GF_DASHFileIOSession segment_download;
 	//0: not set, 1: abort because group has been stopped - 2: abort because bandwidth was too low
@@ -1505,7 +1510,6 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 	Bool force_timeline_setup = GF_FALSE;
 	u32 group_idx, rep_idx, i, j;
 	u64 fetch_time=0;
-	GF_DOMParser *mpd_parser;
 	u8 signature[GF_SHA1_DIGEST_SIZE];
 	GF_MPD_Period *period, *new_period;
 	const char *local_url;
@@ -1650,16 +1654,8 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 
 		/* It means we have to reparse the file ... */
 		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
-		if (e != GF_OK) {
-			gf_xml_dom_del(mpd_parser);
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in XML parsing %s\n", gf_error_to_string(e)));
-			return GF_NON_COMPLIANT_BITSTREAM;
-		}
 		new_mpd = gf_mpd_new();
-		e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), new_mpd, purl);
-		gf_xml_dom_del(mpd_parser);
+		e = gf_mpd_init_from_file(local_url, new_mpd, purl);
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot update playlist: error in MPD creation %s\n", gf_error_to_string(e)));
 			gf_mpd_del(new_mpd);
@@ -1820,7 +1816,11 @@ static GF_Err gf_dash_update_manifest(GF_DashClient *dash)
 
 					while (retry) {
 						if (dash->is_m3u8) {
-							e = gf_m3u8_solve_representation_xlink(new_rep, &group->dash->getter, &is_static, &dur);
+							//segments of the previous playlist are already in the segment list of the active representation, only parse the new ones
+							if (rep->segment_list && rep->segment_list->segment_URLs && !rep->segment_list->xlink_href)
+								e = gf_m3u8_solve_representation_xlink(new_rep, &group->dash->getter, &is_static, &dur, rep->m3u8_media_seq_min, rep->m3u8_media_seq_max);
+							else
+								e = gf_m3u8_solve_representation_xlink(new_rep, &group->dash->getter, &is_static, &dur, 0, 0);
 						} else {
 							e = gf_dash_solve_representation_xlink(group->dash, new_rep);
 						}
@@ -2087,7 +2087,7 @@ static void gf_dash_set_group_representation(GF_DASH_Group *group, GF_MPD_Repres
 		
 		while (retry) {
 			if (group->dash->is_m3u8) {
-				e = gf_m3u8_solve_representation_xlink(rep, &group->dash->getter, &is_static, &dur);
+				e = gf_m3u8_solve_representation_xlink(rep, &group->dash->getter, &is_static, &dur, 0, 0);
 			} else {
 				e = gf_dash_solve_representation_xlink(group->dash, rep);
 			}
@@ -5039,8 +5039,14 @@ static DownloadGroupStatus dash_download_group_download(GF_DashClient *dash, GF_
 			}
 			GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Added file to cache (%u/%u in cache): %s\n", base_group->nb_cached_segments+1, base_group->max_cached_segments, cache_entry->url));
 
+			/*flow IDs: group index in the upper 8 bits, segment count in the lower 24 bits*/
+			base_group->nb_segments_cached++;
+			cache_entry->trace_flow_id = ((1 + gf_list_find(dash->groups, base_group)) << 24) | (base_group->nb_segments_cached & 0xFFFFFF);
+			GF_TRACE_FLOW_START(GF_LOG_DASH, "segment", cache_entry->trace_flow_id);
+
 			base_group->nb_cached_segments++;
 			gf_dash_update_buffering(group, dash);
+			GF_TRACE_COUNTER(GF_LOG_DASH, "cached segments", base_group->nb_cached_segments);
 		}
 		dash_store_stats(dash, group, Bps, file_size);
 
@@ -5090,7 +5096,9 @@ static DownloadGroupStatus dash_download_group(GF_DashClient *dash, GF_DASH_Grou
 	DownloadGroupStatus res;
 
 	if (!group->current_dep_idx) {
+		GF_TRACE_BEGIN(GF_LOG_DASH, "download segment");
 		res = dash_download_group_download(dash, group, base_group, has_dep_following);
+		GF_TRACE_END(GF_LOG_DASH, "download segment");
 		if (res==GF_DASH_DownloadRestart) return res;
 		if (res==GF_DASH_DownloadCancel) return res;
 		group->current_dep_idx = 1;
@@ -6024,19 +6032,21 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] parsing MPD %s\n", local_url));
 
-		/* parse the MPD */
-		mpd_parser = gf_xml_dom_new();
-		e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
+		/* parse the manifest - MPDs are directly loaded from the file below*/
+		if (dash->is_smooth) {
+			mpd_parser = gf_xml_dom_new();
+			e = gf_xml_dom_parse(mpd_parser, local_url, NULL, NULL);
 
-		if (sep_cgi) sep_cgi[0] = '?';
-		if (sep_frag) sep_frag[0] = '#';
+			if (sep_cgi) sep_cgi[0] = '?';
+			if (sep_frag) sep_frag[0] = '#';
 
-		if (e != GF_OK) {
-			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
-			gf_xml_dom_del(mpd_parser);
-			dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
-			dash->mpd_dnload = NULL;
-			return GF_URL_ERROR;
+			if (e != GF_OK) {
+				GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD parsing problem %s\n", gf_xml_dom_get_error(mpd_parser) ));
+				gf_xml_dom_del(mpd_parser);
+				dash->dash_io->del(dash->dash_io, dash->mpd_dnload);
+				dash->mpd_dnload = NULL;
+				return GF_URL_ERROR;
+			}
 		}
 	}
 
@@ -6049,9 +6059,11 @@ GF_Err gf_dash_open(GF_DashClient *dash, const char *manifest_url)
 	} else if (dash->is_smooth) {
 		e = gf_mpd_init_smooth_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
 	} else {
-		e = gf_mpd_init_from_dom(gf_xml_dom_get_root(mpd_parser), dash->mpd, manifest_url);
+		e = gf_mpd_init_from_file(local_url, dash->mpd, manifest_url);
 	}
-	gf_xml_dom_del(mpd_parser);
+	if (mpd_parser) gf_xml_dom_del(mpd_parser);
+	if (sep_cgi) sep_cgi[0] = '?';
+	if (sep_frag) sep_frag[0] = '#';
 
 	if (e != GF_OK) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Error - cannot connect service: MPD creation problem %s\n", gf_error_to_string(e)));
@@ -6761,6 +6773,7 @@ discard_segment:
 
 		//remember the representation index of the last segment
 		group->prev_active_rep_index = group->cached[0].representation_index;
+		GF_TRACE_FLOW_END(GF_LOG_DASH, "segment", group->cached[0].trace_flow_id);
 
 		gf_dash_group_reset_cache_entry(&group->cached[0]);
 	}
@@ -34,6 +34,7 @@
 #include <time.h>
 #endif
 #include <gpac/internal/isomedia_dev.h>
+#include <gpac/trace.h>
 
 #ifndef GPAC_DISABLE_ISOM_WRITE
 #ifdef GPAC_DISABLE_ISOM
@@ -839,6 +840,8 @@ static GF_Err gf_media_isom_segment_file(GF_ISOFile *input, const char *output_f
 	u32 cur_seg, fragment_index, max_sap_type;
 	GF_ISOFile *output, *bs_switch_segment;
 	GF_ISOSample *sample, *next;
+	/*current and next samples are fetched in these two samples, reusing their buffers*/
+	GF_ISOSample *sample_pool[2];
 	GF_List *fragmenters;
 	u64 MaxFragmentDuration, MaxSegmentDuration, period_duration;
 	Double segment_start_time, SegmentDuration, maxFragDurationOverSegment;
@@ -896,6 +899,8 @@ static GF_Err gf_media_isom_segment_file(GF_ISOFile *input, const char *output_f
 	fragmenters = NULL;
 	
 	if (!dash_input) return GF_BAD_PARAM;
+	sample_pool[0] = gf_isom_sample_new();
+	sample_pool[1] = gf_isom_sample_new();
 	if (!seg_ext) seg_ext = "m4s";
 
 	if (dash_cfg->real_time && dash_cfg->dash_ctx) {
@@ -1678,11 +1683,9 @@ restart_fragmentation_pass:
 
 				/*first sample*/
 				if (!sample) {
-					sample = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex);
-					if (!sample) {
-						e = gf_isom_last_error(input);
-						goto err_exit;
-					}
+					e = gf_isom_get_sample_into(input, tf->OriginalTrack, tf->SampleNum + 1, sample_pool[0], &descIndex);
+					if (e) goto err_exit;
+					sample = sample_pool[0];
 
 					/*FIXME - use negative ctts to indicate "past" DTS for splitted sample*/
 					if (tf->split_sample_dts_shift) {
@@ -1705,7 +1708,9 @@ restart_fragmentation_pass:
 
 				gf_isom_get_sample_padding_bits(input, tf->OriginalTrack, tf->SampleNum+1, &NbBits);
 
-				next = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 2, &j);
+				next = (sample == sample_pool[0]) ? sample_pool[1] : sample_pool[0];
+				if (gf_isom_get_sample_into(input, tf->OriginalTrack, tf->SampleNum + 2, next, &j) != GF_OK)
+					next = NULL;
 				if (next) {
 					defaultDuration = (u32) (next->DTS - sample->DTS);
 				} else {
@@ -1802,10 +1807,9 @@ restart_fragmentation_pass:
 				tf->next_sample_dts = sample->DTS + defaultDuration;
 
 				if (split_sample_duration) {
-					gf_isom_sample_del(&next);
+					next = NULL;
 					sample->DTS += defaultDuration;
 				} else {
-					gf_isom_sample_del(&sample);
 					sample = next;
 					tf->SampleNum += 1;
 					tf->split_sample_dts_shift = 0;
@@ -1915,7 +1919,6 @@ restart_fragmentation_pass:
 				}
 
 				if (stop_frag) {
-					gf_isom_sample_del(&sample);
 					sample = next = NULL;
 
 					//only compute max dur over segment for the track used for indexing / deriving MPD start time
@@ -1970,7 +1973,9 @@ restart_fragmentation_pass:
 				                                   gf_sys_clock_high_res(), gf_net_get_utc(), generation_start_utc + end_time));
 			}
 
+			GF_TRACE_BEGIN(GF_LOG_DASH, "flush fragment");
 			e = gf_isom_flush_fragments(output, flush_all_samples ? GF_TRUE : GF_FALSE);
+			GF_TRACE_END(GF_LOG_DASH, "flush fragment");
 			if (e) goto err_exit;
 
 			nbFragmentInSegment++;
@@ -2058,7 +2063,9 @@ restart_fragmentation_pass:
 				}
 
 				GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Closing segment %s at "LLU" us, at UTC "LLU" - segment AST "LLU" (MPD AST "LLU")\n", SegmentName, gf_sys_clock_high_res(), gf_net_get_utc(), generation_start_utc + period_duration + (u64)segment_start_time, generation_start_utc ));
+				GF_TRACE_BEGIN(GF_LOG_DASH, "close segment");
 				gf_isom_close_segment(output, dash_cfg->enable_sidx ? dash_cfg->subsegs_per_sidx : 0, dash_cfg->enable_sidx ? ref_track_id : 0, ref_track_first_dts, tfref ? tfref->media_time_to_pres_time_shift : tf->media_time_to_pres_time_shift, ref_track_next_cts, dash_cfg->daisy_chain_sidx, last_segment, dash_cfg->segment_marker_4cc, &idx_start_range, &idx_end_range);
+				GF_TRACE_END(GF_LOG_DASH, "close segment");
 				nbFragmentInSegment = 0;
 
 				//take care of scalable reps
@@ -2132,7 +2139,9 @@ restart_fragmentation_pass:
 		last_seg_dur = SegmentDuration;
 
 		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[DASH] Closing segment %s at "LLU" us, at UTC "LLU"\n", SegmentName, gf_sys_clock_high_res(), gf_net_get_utc()));
+		GF_TRACE_BEGIN(GF_LOG_DASH, "close segment");
 		gf_isom_close_segment(output, dash_cfg->enable_sidx ? dash_cfg->subsegs_per_sidx : 0, dash_cfg->enable_sidx ? ref_track_id : 0, ref_track_first_dts, tfref ? tfref->media_time_to_pres_time_shift : tf->media_time_to_pres_time_shift, ref_track_next_cts, dash_cfg->daisy_chain_sidx, GF_TRUE, dash_cfg->segment_marker_4cc, &idx_start_range, &idx_end_range);
+		GF_TRACE_END(GF_LOG_DASH, "close segment");
 		nb_segments++;
 
 		if (!seg_rad_name) {
@@ -2555,6 +2564,8 @@ restart_fragmentation_pass:
 	}
 
 err_exit:
+	gf_isom_sample_del(&sample_pool[0]);
+	gf_isom_sample_del(&sample_pool[1]);
 	if (langCode) {
 		gf_free(langCode);
 	}
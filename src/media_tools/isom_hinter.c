@@ -29,6 +29,7 @@
 #include <gpac/constants.h>
 #include <gpac/maths.h>
 #include <gpac/ietf.h>
+#include <gpac/thread.h>
 
 #ifndef GPAC_DISABLE_ISOM
 
@@ -92,8 +93,18 @@ void gf_media_get_sample_average_infos(GF_ISOFile *file, u32 Track, u32 *avgSize
 struct __tag_isom_hinter
 {
 	GF_ISOFile *file;
+	/*file holding the hint track: the media file, or a private movie when tracks are hinted in parallel*/
+	GF_ISOFile *hint_file;
+	/*lock on sample reads from the media file when tracks are hinted in parallel, NULL otherwise*/
+	GF_Mutex *read_mx;
 	/*IDs are kept for mp4 hint sample building*/
 	u32 TrackNum, TrackID, HintTrack, HintID;
+	/*hint track setup*/
+	Bool copy_media;
+	u32 InterleaveGroupID;
+	u8 InterleaveGroupPriority;
+	/*media is only referenced and the packetizer never reads the payload (see gf_rtp_builder_process_ref): samples are not loaded*/
+	Bool ref_only;
 	/*current Hint sample and associated RTP time*/
 	u32 HintSample, RTPTime;
 
@@ -180,7 +191,7 @@ void MP4T_OnPacketDone(void *cbk, GF_RTPHeader *header)
 		disposable = 1;
 	}
 
-	gf_isom_rtp_packet_set_flags(tkHint->file, tkHint->HintTrack, 0, 0, header->Marker, disposable, 0);
+	gf_isom_rtp_packet_set_flags(tkHint->hint_file, tkHint->HintTrack, 0, 0, header->Marker, disposable, 0);
 }
 
 
@@ -190,7 +201,7 @@ void MP4T_OnDataRef(void *cbk, u32 payload_size, u32 offset_from_orig)
 	if (!tkHint || !payload_size) return;
 
 	/*add reference*/
-	gf_isom_hint_sample_data(tkHint->file, tkHint->HintTrack, tkHint->TrackID,
+	gf_isom_hint_sample_data(tkHint->hint_file, tkHint->HintTrack, tkHint->TrackID,
 	                         tkHint->CurrentSample, (u16) payload_size, offset_from_orig + tkHint->base_offset_in_sample,
 	                         NULL, 0);
 }
@@ -203,9 +214,9 @@ void MP4T_OnData(void *cbk, char *data, u32 data_size, Bool is_header)
 
 	at_begin = is_header ? 1 : 0;
 	if (data_size <= 14) {
-		gf_isom_hint_direct_data(tkHint->file, tkHint->HintTrack, data, data_size, at_begin);
+		gf_isom_hint_direct_data(tkHint->hint_file, tkHint->HintTrack, data, data_size, at_begin);
 	} else {
-		gf_isom_hint_sample_data(tkHint->file, tkHint->HintTrack, tkHint->HintID, 0, (u16) data_size, 0, data, at_begin);
+		gf_isom_hint_sample_data(tkHint->hint_file, tkHint->HintTrack, tkHint->HintID, 0, (u16) data_size, 0, data, at_begin);
 	}
 }
 
@@ -221,20 +232,59 @@ void MP4T_OnNewPacket(void *cbk, GF_RTPHeader *header)
 	/*do we need a new sample*/
 	if (!tkHint->HintSample || (tkHint->RTPTime != header->TimeStamp)) {
 		/*close current sample*/
-		if (tkHint->HintSample) gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, tkHint->SampleIsRAP);
+		if (tkHint->HintSample) gf_isom_end_hint_sample(tkHint->hint_file, tkHint->HintTrack, tkHint->SampleIsRAP);
 
 		/*start new sample: We use DTS as the sampling instant (RTP TS) to make sure
 		all packets are sent in order*/
-		gf_isom_begin_hint_sample(tkHint->file, tkHint->HintTrack, 1, header->TimeStamp-res);
+		gf_isom_begin_hint_sample(tkHint->hint_file, tkHint->HintTrack, 1, header->TimeStamp-res);
 		tkHint->HintSample ++;
 		tkHint->RTPTime = header->TimeStamp;
 		tkHint->SampleIsRAP = tkHint->rtp_p->sl_config.hasRandomAccessUnitsOnlyFlag ? 1 : tkHint->rtp_p->sl_header.randomAccessPointFlag;
 	}
 	/*create an RTP Packet with the appropriated marker flag - note: the flags are temp ones,
 	they are set when the full packet is signaled (to handle multi AUs per RTP)*/
-	gf_isom_rtp_packet_begin(tkHint->file, tkHint->HintTrack, 0, 0, 0, header->Marker, header->PayloadType, 0, 0, header->SequenceNumber);
+	gf_isom_rtp_packet_begin(tkHint->hint_file, tkHint->HintTrack, 0, 0, 0, header->Marker, header->PayloadType, 0, 0, header->SequenceNumber);
 	/*Add the delta TS to make sure RTP TS is indeed the CTS (sampling time)*/
-	if (res) gf_isom_rtp_packet_set_offset(tkHint->file, tkHint->HintTrack, res);
+	if (res) gf_isom_rtp_packet_set_offset(tkHint->hint_file, tkHint->HintTrack, res);
+}
+
+/*sets interleaving of the hint track - only done on files opened in edit mode*/
+static void hinter_set_hint_track_group(GF_RTPHinter *tkHint, GF_ISOFile *file)
+{
+	if (!tkHint->copy_media) {
+		/*if we don't copy data set hint track and media track in the same group*/
+		gf_isom_set_track_interleaving_group(file, tkHint->HintTrack, tkHint->InterleaveGroupID);
+	} else {
+		gf_isom_set_track_interleaving_group(file, tkHint->HintTrack, tkHint->InterleaveGroupID + OFFSET_HINT_GROUP_ID);
+	}
+	/*use user-secified priority*/
+	gf_isom_set_track_priority_in_group(file, tkHint->HintTrack, 2*tkHint->InterleaveGroupPriority);
+}
+
+/*creates the hint track of the hinter in @file*/
+static GF_Err hinter_new_hint_track(GF_RTPHinter *tkHint, GF_ISOFile *file)
+{
+	GF_Err e;
+	u32 descIndex;
+
+	tkHint->HintTrack = gf_isom_new_track(file, tkHint->HintID, GF_ISOM_MEDIA_HINT, tkHint->rtp_p->sl_config.timestampResolution);
+	if (!tkHint->HintTrack) return gf_isom_last_error(file);
+	e = gf_isom_setup_hint_track(file, tkHint->HintTrack, GF_ISOM_HINT_RTP);
+	if (e) return e;
+	/*create a hint description*/
+	e = gf_isom_new_hint_description(file, tkHint->HintTrack, -1, -1, 0, &descIndex);
+	if (e) return e;
+	gf_isom_rtp_set_timescale(file, tkHint->HintTrack, descIndex, tkHint->rtp_p->sl_config.timestampResolution);
+
+	hinter_set_hint_track_group(tkHint, file);
+
+#if 0
+	/*QT FF: not setting these flags = server uses a random offset*/
+	gf_isom_rtp_set_time_offset(file, tkHint->HintTrack, 1, 0);
+	/*we don't use seq offset for maintainance pruposes*/
+	gf_isom_rtp_set_time_sequence_offset(file, tkHint->HintTrack, 1, 0);
+#endif
+	return GF_OK;
 }
 
 
@@ -245,7 +295,7 @@ GF_RTPHinter *gf_hinter_track_new(GF_ISOFile *file, u32 TrackNum,
 {
 
 	GF_SLConfig my_sl;
-	u32 descIndex, MinSize, MaxSize, avgTS, streamType, oti, const_dur, nb_ch, maxDTSDelta;
+	u32 MinSize, MaxSize, avgTS, streamType, oti, const_dur, nb_ch, maxDTSDelta;
 	u8 OfficialPayloadID;
 	u32 TrackMediaSubType, TrackMediaType, hintType, nbEdts, required_rate, force_dts_delta, avc_nalu_size, PL_ID, bandwidth, IV_length, KI_length;
 	const char *url, *urn;
@@ -549,6 +599,7 @@ GF_RTPHinter *gf_hinter_track_new(GF_ISOFile *file, u32 TrackNum,
 	}
 
 	tmp->file = file;
+	tmp->hint_file = file;
 	tmp->TrackNum = TrackNum;
 	tmp->avc_nalu_size = avc_nalu_size;
 	tmp->nb_chan = nb_ch;
@@ -624,11 +675,14 @@ GF_RTPHinter *gf_hinter_track_new(GF_ISOFile *file, u32 TrackNum,
 	tmp->HintID = tmp->TrackID + 65535;
 	while (gf_isom_get_track_by_id(file, tmp->HintID)) tmp->HintID++;
 
-	tmp->HintTrack = gf_isom_new_track(file, tmp->HintID, GF_ISOM_MEDIA_HINT, my_sl.timestampResolution);
-	gf_isom_setup_hint_track(file, tmp->HintTrack, GF_ISOM_HINT_RTP);
-	/*create a hint description*/
-	gf_isom_new_hint_description(file, tmp->HintTrack, -1, -1, 0, &descIndex);
-	gf_isom_rtp_set_timescale(file, tmp->HintTrack, descIndex, my_sl.timestampResolution);
+	tmp->copy_media = copy_media;
+	tmp->InterleaveGroupID = InterleaveGroupID;
+	tmp->InterleaveGroupPriority = InterleaveGroupPriority;
+	*e = hinter_new_hint_track(tmp, file);
+	if (*e) {
+		gf_hinter_track_del(tmp);
+		return NULL;
+	}
 
 	if (hintType==GF_RTP_PAYT_MPEG4) {
 		tmp->rtp_p->slMap.ObjectTypeIndication = oti;
@@ -639,23 +693,20 @@ GF_RTPHinter *gf_hinter_track_new(GF_ISOFile *file, u32 TrackNum,
 
 	/*set interleaving*/
 	gf_isom_set_track_interleaving_group(file, TrackNum, InterleaveGroupID);
-	if (!copy_media) {
-		/*if we don't copy data set hint track and media track in the same group*/
-		gf_isom_set_track_interleaving_group(file, tmp->HintTrack, InterleaveGroupID);
-	} else {
-		gf_isom_set_track_interleaving_group(file, tmp->HintTrack, InterleaveGroupID + OFFSET_HINT_GROUP_ID);
-	}
 	/*use user-secified priority*/
-	InterleaveGroupPriority*=2;
-	gf_isom_set_track_priority_in_group(file, TrackNum, InterleaveGroupPriority+1);
-	gf_isom_set_track_priority_in_group(file, tmp->HintTrack, InterleaveGroupPriority);
+	gf_isom_set_track_priority_in_group(file, TrackNum, 2*InterleaveGroupPriority+1);
+
+	/*when media is only referenced, these packetizers only need the payload size: samples are not loaded for hinting*/
+	if (!copy_media && !IV_length) {
+		switch (hintType) {
+		case GF_RTP_PAYT_MPEG4:
+		case GF_RTP_PAYT_LATM:
+		case GF_RTP_PAYT_AC3:
+			tmp->ref_only = GF_TRUE;
+			break;
+		}
+	}
 
-#if 0
-	/*QT FF: not setting these flags = server uses a random offset*/
-	gf_isom_rtp_set_time_offset(file, tmp->HintTrack, 1, 0);
-	/*we don't use seq offset for maintainance pruposes*/
-	gf_isom_rtp_set_time_sequence_offset(file, tmp->HintTrack, 1, 0);
-#endif
 	*e = GF_OK;
 	return tmp;
 }
@@ -691,11 +742,13 @@ GF_EXPORT
 GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 {
 	GF_Err e;
-	u32 i, descIndex, duration;
+	u32 i, descIndex, data_size, duration = 0;
 	u64 ts;
 	u8 PadBits;
 	Double ft;
+	char *data;
 	GF_ISOSample *samp;
+	GF_ISMASample *s;
 
 	tkHint->HintSample = tkHint->RTPTime = 0;
 
@@ -703,10 +756,32 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 	ft = tkHint->rtp_p->sl_config.timestampResolution;
 	ft /= tkHint->OrigTimeScale;
 
+	/*the sample buffer is reused across samples*/
+	samp = tkHint->ref_only ? NULL : gf_isom_sample_new();
+
 	e = GF_OK;
 	for (i=0; i<tkHint->TotalSample; i++) {
-		samp = gf_isom_get_sample(tkHint->file, tkHint->TrackNum, i+1, &descIndex);
-		if (!samp) return GF_IO_ERR;
+		s = NULL;
+		PadBits = 0;
+		if (tkHint->read_mx) gf_mx_p(tkHint->read_mx);
+		if (tkHint->ref_only) {
+			u64 offset;
+			if (samp) gf_isom_sample_del(&samp);
+			samp = gf_isom_get_sample_info(tkHint->file, tkHint->TrackNum, i+1, &descIndex, &offset);
+			if (!samp) e = GF_IO_ERR;
+		} else {
+			e = gf_isom_get_sample_into(tkHint->file, tkHint->TrackNum, i+1, samp, &descIndex);
+			if (!e && tkHint->rtp_p->slMap.IV_length) s = gf_isom_get_ismacryp_sample(tkHint->file, tkHint->TrackNum, samp, descIndex);
+		}
+		if (!e) {
+			if (tkHint->rtp_p->sl_config.usePaddingFlag) gf_isom_get_sample_padding_bits(tkHint->file, tkHint->TrackNum, i+1, &PadBits);
+			duration = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, i+1);
+		}
+		if (tkHint->read_mx) gf_mx_v(tkHint->read_mx);
+		if (e) {
+			e = GF_IO_ERR;
+			break;
+		}
 
 		//setup SL
 		tkHint->CurrentSample = i + 1;
@@ -726,36 +801,30 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 		tkHint->rtp_p->sl_header.randomAccessPointFlag = samp->IsRAP;
 
 		tkHint->base_offset_in_sample = 0;
+		data = samp->data;
+		data_size = samp->dataLength;
+		/*empty samples are passed without data, as sample buffers may be reused*/
+		if (!data_size) data = NULL;
+
 		/*crypted*/
-		if (tkHint->rtp_p->slMap.IV_length) {
-			GF_ISMASample *s = gf_isom_get_ismacryp_sample(tkHint->file, tkHint->TrackNum, samp, descIndex);
+		if (s) {
 			/*one byte take for selective_enc flag*/
 			if (s->flags & GF_ISOM_ISMA_USE_SEL_ENC) tkHint->base_offset_in_sample += 1;
 			if (s->flags & GF_ISOM_ISMA_IS_ENCRYPTED) tkHint->base_offset_in_sample += s->IV_length + s->KI_length;
-			gf_free(samp->data);
-			samp->data = s->data;
-			samp->dataLength = s->dataLength;
+			data = s->data;
+			data_size = s->dataLength;
 			gp_rtp_builder_set_cryp_info(tkHint->rtp_p, s->IV, (char*)s->key_indicator, (s->flags & GF_ISOM_ISMA_IS_ENCRYPTED) ? 1 : 0);
-			s->data = NULL;
-			s->dataLength = 0;
-			gf_isom_ismacryp_delete_sample(s);
 		}
 
-		if (tkHint->rtp_p->sl_config.usePaddingFlag) {
-			gf_isom_get_sample_padding_bits(tkHint->file, tkHint->TrackNum, i+1, &PadBits);
-			tkHint->rtp_p->sl_header.paddingBits = PadBits;
-		} else {
-			tkHint->rtp_p->sl_header.paddingBits = 0;
-		}
+		tkHint->rtp_p->sl_header.paddingBits = PadBits;
 
-		duration = gf_isom_get_sample_duration(tkHint->file, tkHint->TrackNum, i+1);
 //		ts = (u32) (ft * (s64) (duration));
 
 		/*unpack nal units*/
 		if (tkHint->avc_nalu_size) {
 			u32 v, size;
-			u32 remain = samp->dataLength;
-			char *ptr = samp->data;
+			u32 remain = data_size;
+			char *ptr = data;
 
 			tkHint->rtp_p->sl_header.accessUnitStartFlag = 1;
 			tkHint->rtp_p->sl_header.accessUnitEndFlag = 0;
@@ -769,38 +838,152 @@ GF_Err gf_hinter_track_process(GF_RTPHinter *tkHint)
 					v-=1;
 					if (v) size<<=8;
 				}
-				tkHint->base_offset_in_sample = samp->dataLength-remain;
+				tkHint->base_offset_in_sample = data_size-remain;
 				if (remain < size) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_RTP, ("[rtp hinter] Broken AVC nalu encapsulation: NALU size is %d but only %d bytes left in sample %d\n", size, remain, tkHint->CurrentSample));
 					break;
 				}
 				remain -= size;
 				tkHint->rtp_p->sl_header.accessUnitEndFlag = remain ? 0 : 1;
-				e = gf_rtp_builder_process(tkHint->rtp_p, ptr, size, (u8) !remain, samp->dataLength, duration, (u8) (descIndex + GF_RTP_TX3G_SIDX_OFFSET) );
+				e = gf_rtp_builder_process(tkHint->rtp_p, ptr, size, (u8) !remain, data_size, duration, (u8) (descIndex + GF_RTP_TX3G_SIDX_OFFSET) );
 				ptr += size;
 				tkHint->rtp_p->sl_header.accessUnitStartFlag = 0;
 			}
+		}
+		/*payload is only referenced, the sample data was not loaded*/
+		else if (tkHint->ref_only && data_size) {
+			e = gf_rtp_builder_process_ref(tkHint->rtp_p, data_size, 1, data_size, duration);
 		} else {
-			e = gf_rtp_builder_process(tkHint->rtp_p, samp->data, samp->dataLength, 1, samp->dataLength, duration, (u8) (descIndex + GF_RTP_TX3G_SIDX_OFFSET) );
+			e = gf_rtp_builder_process(tkHint->rtp_p, data, data_size, 1, data_size, duration, (u8) (descIndex + GF_RTP_TX3G_SIDX_OFFSET) );
 		}
 		tkHint->rtp_p->sl_header.packetSequenceNumber += 1;
 
-		//signal some progress
-		gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
+		//signal some progress - when hinting in parallel, progress is signaled by the caller
+		if (!tkHint->read_mx) gf_set_progress("Hinting", tkHint->CurrentSample, tkHint->TotalSample);
 
 		tkHint->rtp_p->sl_header.AU_sequenceNumber += 1;
-		gf_isom_sample_del(&samp);
+		if (s) gf_isom_ismacryp_delete_sample(s);
 
-		if (e) return e;
+		if (e) break;
 	}
+	if (samp) gf_isom_sample_del(&samp);
+	if (e) return e;
 
 	//flush
 	gf_rtp_builder_process(tkHint->rtp_p, NULL, 0, 1, 0, 0, 0);
 
-	gf_isom_end_hint_sample(tkHint->file, tkHint->HintTrack, (u8) tkHint->SampleIsRAP);
+	gf_isom_end_hint_sample(tkHint->hint_file, tkHint->HintTrack, (u8) tkHint->SampleIsRAP);
 	return GF_OK;
 }
 
+typedef struct
+{
+	GF_RTPHinter *tkHint;
+	GF_ISOFile *movie;
+	GF_Thread *th;
+	GF_Err e;
+} GF_HintJob;
+
+static u32 hinter_job_run(void *par)
+{
+	GF_HintJob *job = (GF_HintJob *)par;
+	job->e = gf_hinter_track_process(job->tkHint);
+	return 0;
+}
+
+GF_EXPORT
+GF_Err gf_hinter_track_process_parallel(GF_List *hinters, const char *tmp_dir)
+{
+	GF_Err e;
+	GF_ISOFile *file;
+	GF_Mutex *read_mx;
+	GF_HintJob *jobs;
+	u32 i, count;
+	Bool running;
+
+	count = gf_list_count(hinters);
+	if (!count) return GF_OK;
+	file = ((GF_RTPHinter *)gf_list_get(hinters, 0))->file;
+	for (i=1; i<count; i++) {
+		if (((GF_RTPHinter *)gf_list_get(hinters, i))->file != file) return GF_BAD_PARAM;
+	}
+	if (count==1) return gf_hinter_track_process((GF_RTPHinter *)gf_list_get(hinters, 0));
+
+	jobs = (GF_HintJob *)gf_malloc(sizeof(GF_HintJob) * count);
+	if (!jobs) return GF_OUT_OF_MEM;
+	memset(jobs, 0, sizeof(GF_HintJob) * count);
+	read_mx = gf_mx_new("HintRead");
+
+	/*the ISO writer is not thread-safe: each hint track is built in its own temporary movie*/
+	e = GF_OK;
+	for (i=0; i<count; i++) {
+		GF_RTPHinter *tkHint = (GF_RTPHinter *)gf_list_get(hinters, i);
+		jobs[i].tkHint = tkHint;
+		jobs[i].movie = gf_isom_open("_gpac_hint", GF_ISOM_WRITE_EDIT, tmp_dir);
+		if (!jobs[i].movie) {
+			e = gf_isom_last_error(NULL);
+			break;
+		}
+		gf_isom_set_timescale(jobs[i].movie, gf_isom_get_timescale(file));
+		e = hinter_new_hint_track(tkHint, jobs[i].movie);
+		if (e) break;
+		tkHint->hint_file = jobs[i].movie;
+		tkHint->read_mx = read_mx;
+	}
+
+	if (!e) {
+		for (i=0; i<count; i++) {
+			jobs[i].th = gf_th_new("HintTrack");
+			gf_th_run(jobs[i].th, hinter_job_run, &jobs[i]);
+		}
+		/*wait for all tracks*/
+		do {
+			u32 cur = 0, total = 0;
+			running = GF_FALSE;
+			for (i=0; i<count; i++) {
+				if (gf_th_status(jobs[i].th) == GF_THREAD_STATUS_RUN) running = GF_TRUE;
+				cur += jobs[i].tkHint->CurrentSample;
+				total += jobs[i].tkHint->TotalSample;
+			}
+			if (running) {
+				gf_set_progress("Hinting", cur, total ? total : 1);
+				gf_sleep(10);
+			}
+		} while (running);
+	}
+
+	/*move hint tracks to the media file, in hinter order*/
+	for (i=0; i<count; i++) {
+		GF_RTPHinter *tkHint = jobs[i].tkHint;
+		if (jobs[i].th) {
+			gf_th_stop(jobs[i].th);
+			gf_th_del(jobs[i].th);
+			if (!e) e = jobs[i].e;
+		}
+		if (!e && jobs[i].movie) {
+			e = gf_isom_remove_track(file, gf_isom_get_track_by_id(file, tkHint->HintID));
+			if (!e) e = gf_isom_move_tracks(file, jobs[i].movie);
+		}
+		if (jobs[i].movie) gf_isom_delete(jobs[i].movie);
+		if (tkHint) {
+			tkHint->hint_file = file;
+			tkHint->read_mx = NULL;
+		}
+	}
+	if (!e) gf_set_progress("Hinting", 1, 1);
+
+	/*track numbers may have changed*/
+	for (i=0; i<count; i++) {
+		GF_RTPHinter *tkHint = (GF_RTPHinter *)gf_list_get(hinters, i);
+		tkHint->HintTrack = gf_isom_get_track_by_id(file, tkHint->HintID);
+		/*interleaving is not kept when moving tracks*/
+		if (!e) hinter_set_hint_track_group(tkHint, file);
+	}
+	gf_mx_del(read_mx);
+	gf_free(jobs);
+	return e;
+}
+
 static u32 write_nalu_config_array(char *sdpLine, GF_List *nalus)
 {
 	u32 i, count, b64s;
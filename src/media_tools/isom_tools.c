@@ -3125,6 +3125,8 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 	u32 tag_len;
 	GF_ISOFile *output;
 	GF_ISOSample *sample, *next;
+	/*current and next samples are fetched in these two samples, reusing their buffers*/
+	GF_ISOSample *sample_pool[2];
 	GF_List *fragmenters;
 	u32 MaxFragmentDuration;
 	GF_TrackFragmenter *tf;
@@ -3134,6 +3136,9 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 	output = gf_isom_open(output_file, GF_ISOM_OPEN_WRITE, NULL);
 	if (!output) return gf_isom_last_error(NULL);
 
+	sample_pool[0] = gf_isom_sample_new();
+	sample_pool[1] = gf_isom_sample_new();
+
     gf_isom_no_version_date_info(output, drop_version);
 
 
@@ -3271,11 +3276,15 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 			//ok write samples
 			while (1) {
 				if (!sample) {
-					sample = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 1, &descIndex);
+					e = gf_isom_get_sample_into(input, tf->OriginalTrack, tf->SampleNum + 1, sample_pool[0], &descIndex);
+					if (e) goto err_exit;
+					sample = sample_pool[0];
 				}
 				gf_isom_get_sample_padding_bits(input, tf->OriginalTrack, tf->SampleNum+1, &NbBits);
 
-				next = gf_isom_get_sample(input, tf->OriginalTrack, tf->SampleNum + 2, &j);
+				next = (sample == sample_pool[0]) ? sample_pool[1] : sample_pool[0];
+				if (gf_isom_get_sample_into(input, tf->OriginalTrack, tf->SampleNum + 2, next, &j) != GF_OK)
+					next = NULL;
 				if (next) {
 					defaultDuration = (u32) (next->DTS - sample->DTS);
 				} else {
@@ -3296,7 +3305,6 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 				gf_set_progress("ISO File Fragmenting", nb_done, nb_samp);
 				nb_done++;
 
-				gf_isom_sample_del(&sample);
 				sample = next;
 				tf->FragmentLength += defaultDuration;
 				tf->SampleNum += 1;
@@ -3305,7 +3313,6 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 				if ((tf->SampleNum==tf->SampleCount) ||
 				        /* TODO: should probably test the time position (not only duration) to avoid drift */
 				        (tf->FragmentLength*1000 >= MaxFragmentDuration*tf->TimeScale)) {
-					gf_isom_sample_del(&next);
 					sample = next = NULL;
 					tf->FragmentLength = 0;
 					break;
@@ -3321,6 +3328,8 @@ GF_Err gf_media_fragment_file(GF_ISOFile *input, const char *output_file, Double
 	}
 
 err_exit:
+	gf_isom_sample_del(&sample_pool[0]);
+	gf_isom_sample_del(&sample_pool[1]);
 	while (gf_list_count(fragmenters)) {
 		tf = (GF_TrackFragmenter *)gf_list_get(fragmenters, 0);
 		gf_free(tf);
@@ -1605,7 +1605,6 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 	u32 adaptation_field_control, payload_length, payload_to_copy, padding_length, hdr_len, pos, copy_next;
 
 	assert(stream->pid);
-	bs = gf_bs_new(packet, 188, GF_BITSTREAM_WRITE);
 
 	if (stream->pcr_only_mode) {
 		payload_length = 184 - 8;
@@ -1746,14 +1745,18 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 		else stream->continuity_counter--;
 	}
 
-	gf_bs_write_int(bs,	0x47, 8); // sync byte
-	gf_bs_write_int(bs,	0, 1);    // error indicator
-	gf_bs_write_int(bs,	hdr_len ? 1 : 0, 1); // start ind
-	gf_bs_write_int(bs,	0, 1);	  // transport priority
-	gf_bs_write_int(bs,	stream->pid, 13); // pid
-	gf_bs_write_int(bs,	0, 2);    // scrambling
-	gf_bs_write_int(bs,	adaptation_field_control, 2);    // we do not use adaptation field for sections
-	gf_bs_write_int(bs,	stream->continuity_counter, 4);   // continuity counter
+	/*TS header: sync byte, no error, start indicator, no priority, pid, no scrambling, adaptation field control and continuity counter*/
+	packet[0] = 0x47;
+	packet[1] = (hdr_len ? 0x40 : 0) | ((stream->pid >> 8) & 0x1F);
+	packet[2] = stream->pid & 0xFF;
+	packet[3] = ((adaptation_field_control & 0x3) << 4) | (stream->continuity_counter & 0xF);
+	pos = 4;
+
+	/*only use a bitstream for adaptation field and PES header, plain payload packets are built with a single memcpy*/
+	bs = NULL;
+	if (hdr_len || (adaptation_field_control != GF_M2TS_ADAPTATION_NONE)) {
+		bs = gf_bs_new(packet+4, 184, GF_BITSTREAM_WRITE);
+	}
 
 	if (stream->continuity_counter < 15) stream->continuity_counter++;
 	else stream->continuity_counter=0;
@@ -1807,8 +1810,10 @@ void gf_m2ts_mux_pes_get_next_packet(GF_M2TS_Mux_Stream *stream, char *packet)
 	}
 	if (hdr_len) gf_m2ts_stream_add_pes_header(bs, stream);
 
-	pos = (u32) gf_bs_get_position(bs);
-	gf_bs_del(bs);
+	if (bs) {
+		pos += (u32) gf_bs_get_position(bs);
+		gf_bs_del(bs);
+	}
 
 
 	if (adaptation_field_control == GF_M2TS_ADAPTATION_ONLY) {
@@ -1962,6 +1967,11 @@ GF_Err gf_m2ts_output_ctrl(GF_ESInterface *_self, u32 ctrl_type, void *param)
 			GF_SAFEALLOC(stream->pck_reassembler, GF_M2TS_Packet);
 			if (!stream->pck_reassembler) {
 				GF_LOG(GF_LOG_ERROR, GF_LOG_CONTAINER, ("[MPEG-2 TS Muxer] PID %d: fail to allocate packet reassembler\n", stream->pid));
+				/*we own the buffer even if we cannot use it*/
+				if (esi_pck->flags & GF_ESI_DATA_TRANSFER) {
+					gf_free(esi_pck->data);
+					esi_pck->data = NULL;
+				}
 				return GF_OUT_OF_MEM;
 			}
 
@@ -1977,9 +1987,20 @@ GF_Err gf_m2ts_output_ctrl(GF_ESInterface *_self, u32 ctrl_type, void *param)
 
 		stream->force_new = esi_pck->flags & GF_ESI_DATA_AU_END ? GF_TRUE : GF_FALSE;
 
-		stream->pck_reassembler->data = (char*)gf_realloc(stream->pck_reassembler->data , sizeof(char)*(stream->pck_reassembler->data_len+esi_pck->data_len) );
-		memcpy(stream->pck_reassembler->data + stream->pck_reassembler->data_len, esi_pck->data, esi_pck->data_len);
-		stream->pck_reassembler->data_len += esi_pck->data_len;
+		/*buffer handed over by the producer, use it directly if nothing to concatenate*/
+		if ((esi_pck->flags & GF_ESI_DATA_TRANSFER) && !stream->pck_reassembler->data) {
+			stream->pck_reassembler->data = esi_pck->data;
+			stream->pck_reassembler->data_len = esi_pck->data_len;
+			esi_pck->data = NULL;
+		} else {
+			stream->pck_reassembler->data = (char*)gf_realloc(stream->pck_reassembler->data , sizeof(char)*(stream->pck_reassembler->data_len+esi_pck->data_len) );
+			memcpy(stream->pck_reassembler->data + stream->pck_reassembler->data_len, esi_pck->data, esi_pck->data_len);
+			stream->pck_reassembler->data_len += esi_pck->data_len;
+			if (esi_pck->flags & GF_ESI_DATA_TRANSFER) {
+				gf_free(esi_pck->data);
+				esi_pck->data = NULL;
+			}
+		}
 
 		stream->pck_reassembler->flags |= esi_pck->flags;
 		if (stream->force_new) {
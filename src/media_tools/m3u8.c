@@ -63,8 +63,22 @@ typedef struct _s_accumulated_attributes {
 	char *key_url;
 	bin128 key_iv;
 	Bool independant_segments;
+	/*media sequence range already known by the caller when reloading a live playlist*/
+	int known_media_seq_min, known_media_seq_max;
+	/*end time of the last skipped segment, used as start time of the first new one*/
+	u64 skipped_end_time;
 } s_accumulated_attributes;
 
+#define M3U8_BUF_SIZE 2048
+#define M3U8_MAX_ATTRIBUTES	16
+
+/*attributes of the current line, tokenized in place without allocation*/
+typedef struct _s_line_attributes {
+	char *values[M3U8_MAX_ATTRIBUTES+1];
+	u32 count;
+	char buffer[M3U8_BUF_SIZE + M3U8_MAX_ATTRIBUTES];
+} s_line_attributes;
+
 
 /********** playlist_element **********/
 
@@ -283,9 +297,9 @@ static void reset_attributes(s_accumulated_attributes *attributes)
 	attributes->key_method = DRM_NONE;
 }
 
-static char** extract_attributes(const char *name, const char *line, const int num_attributes) {
-	int sz, i, curr_attribute, start;
-	char **ret;
+static char** extract_attributes(const char *name, const char *line, s_line_attributes *attrs) {
+	int sz, i, start;
+	u32 pos;
 	u8 quote = 0;
 	int len = (u32) strlen(line);
 	start = (u32) strlen(name);
@@ -293,31 +307,38 @@ static char** extract_attributes(const char *name, const char *line, const int n
 		return NULL;
 	if (!safe_start_equals(name, line))
 		return NULL;
-	ret = gf_calloc((num_attributes + 1), sizeof(char*));
-	curr_attribute = 0;
+	attrs->count = 0;
+	attrs->values[0] = NULL;
+	pos = 0;
 	for (i=start; i<=len; i++) {
 		if (line[i] == '\0' || (!quote && line[i] == ',')  || (line[i] == quote)) {
 			u32 spaces = 0;
 			sz = i - start;
 			if (quote && (line[i] == quote))
 				sz++;
-			
+
 			while (line[start+spaces] == ' ')
 				spaces++;
 			if ((sz-spaces<=1) && (line[start+spaces]==',')) {
 				start = i+1;
 			} else {
 				if (!strncmp(&line[start+spaces], "\t", sz-spaces) || !strncmp(&line[start+spaces], "\n", sz-spaces)) {
+				} else if ((attrs->count < M3U8_MAX_ATTRIBUTES) && (pos + sz-spaces < sizeof(attrs->buffer))) {
+					/*values are copied back to back in the line buffer, no allocation*/
+					attrs->values[attrs->count] = attrs->buffer + pos;
+					memcpy(attrs->buffer + pos, &(line[start+spaces]), sz-spaces);
+					pos += sz-spaces;
+					attrs->buffer[pos++] = 0;
+					attrs->count++;
+					attrs->values[attrs->count] = NULL;
 				} else {
-					ret[curr_attribute] = gf_calloc( (1+sz-spaces), sizeof(char));
-					strncpy(ret[curr_attribute], &(line[start+spaces]), sz-spaces);
-					curr_attribute++;
+					GF_LOG(GF_LOG_WARNING, GF_LOG_DASH,("[M3U8] Too many attributes in %s, ignoring %.*s\n", name, sz-spaces, &line[start+spaces]));
 				}
 			}
 			start = i+1;
-			
+
 			if (start == len) {
-				return ret;
+				return attrs->values;
 			}
 		}
 		if ((line[i] == '\'') || (line[i] == '"'))  {
@@ -328,11 +349,10 @@ static char** extract_attributes(const char *name, const char *line, const int n
 			}
 		}
 	}
-	if (curr_attribute == 0) {
-		gf_free(ret);
+	if (attrs->count == 0) {
 		return NULL;
 	}
-	return ret;
+	return attrs->values;
 }
 
 #define M3U8_COMPATIBILITY_VERSION(v) \
@@ -341,8 +361,9 @@ static char** extract_attributes(const char *name, const char *line, const int n
 
 /**
  * Parses the attributes and accumulate into the attributes structure
+ * The returned attribute values point to the line attributes buffer and must not be freed
  */
-static char** parse_attributes(const char *line, s_accumulated_attributes *attributes) {
+static char** parse_attributes(const char *line, s_accumulated_attributes *attributes, s_line_attributes *attrs) {
 	int int_value, i;
 	double double_value;
 	char **ret;
@@ -360,7 +381,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 	/* reset not accumated attributes */
 	attributes->type = MEDIA_TYPE_UNKNOWN;
 
-	ret = extract_attributes("#EXT-X-TARGETDURATION:", line, 1);
+	ret = extract_attributes("#EXT-X-TARGETDURATION:", line, attrs);
 	if (ret) {
 		/* #EXT-X-TARGETDURATION:<seconds> */
 		if (ret[0]) {
@@ -372,7 +393,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-MEDIA-SEQUENCE:", line, 1);
+	ret = extract_attributes("#EXT-X-MEDIA-SEQUENCE:", line, attrs);
 	if (ret) {
 		/* #EXT-X-MEDIA-SEQUENCE:<number> */
 		if (ret[0]) {
@@ -385,7 +406,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-VERSION:", line, 1);
+	ret = extract_attributes("#EXT-X-VERSION:", line, attrs);
 	if (ret) {
 		/* #EXT-X-VERSION:<number> */
 		if (ret[0]) {
@@ -398,7 +419,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		}
 		return ret;
 	}
-	ret = extract_attributes("#EXTINF:", line, 2);
+	ret = extract_attributes("#EXTINF:", line, attrs);
 	if (ret) {
 		M3U8_COMPATIBILITY_VERSION(1);
 		/* #EXTINF:<duration>,<title> */
@@ -417,7 +438,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		}
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-KEY:", line, 4);
+	ret = extract_attributes("#EXT-X-KEY:", line, attrs);
 	if (ret) {
 		/* #EXT-X-KEY:METHOD=<method>[,URI="<URI>"] */
 		const char *method = "METHOD=";
@@ -437,27 +458,27 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-PROGRAM-DATE-TIME:", line, 1);
+	ret = extract_attributes("#EXT-X-PROGRAM-DATE-TIME:", line, attrs);
 	if (ret) {
 		/* #EXT-X-PROGRAM-DATE-TIME:<YYYY-MM-DDThh:mm:ssZ> */
 		if (ret[0]) attributes->playlist_utc_timestamp = gf_net_parse_date(ret[0]);
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-ALLOW-CACHE:", line, 1);
+	ret = extract_attributes("#EXT-X-ALLOW-CACHE:", line, attrs);
 	if (ret) {
 		/* #EXT-X-ALLOW-CACHE:<YES|NO> */
 		GF_LOG(GF_LOG_INFO, GF_LOG_DASH,("[M3U8] EXT-X-ALLOW-CACHE not supported.\n", line));
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-PLAYLIST-TYPE", line, 1);
+	ret = extract_attributes("#EXT-X-PLAYLIST-TYPE", line, attrs);
 	if (ret) {
 		if (ret[0] && !strcmp(ret[0], "VOD")) attributes->is_playlist_ended = GF_TRUE;
 		M3U8_COMPATIBILITY_VERSION(3);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-MAP", line, 4);
+	ret = extract_attributes("#EXT-X-MAP", line, attrs);
 	if (ret) {
 		/* #EXT-X-MAP:URI="<URI>"] */
 		i=0;
@@ -489,7 +510,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		M3U8_COMPATIBILITY_VERSION(3);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-STREAM-INF:", line, 10);
+	ret = extract_attributes("#EXT-X-STREAM-INF:", line, attrs);
 	if (ret) {
 		/* #EXT-X-STREAM-INF:[attribute=value][,attribute=value]* */
 		i = 0;
@@ -538,14 +559,14 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		}
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-DISCONTINUITY", line, 0);
+	ret = extract_attributes("#EXT-X-DISCONTINUITY", line, attrs);
 	if (ret) {
 		/* #EXT-X-DISCONTINUITY */
 		GF_LOG(GF_LOG_WARNING, GF_LOG_DASH,("[M3U8] EXT-X-DISCONTINUITY not supported.\n", line));
 		M3U8_COMPATIBILITY_VERSION(1);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-BYTERANGE:", line, 1);
+	ret = extract_attributes("#EXT-X-BYTERANGE:", line, attrs);
 	if (ret) {
 		/* #EXT-X-BYTERANGE:<begin@end> */
 		if (ret[0]) {
@@ -562,7 +583,7 @@ static char** parse_attributes(const char *line, s_accumulated_attributes *attri
 		M3U8_COMPATIBILITY_VERSION(4);
 		return ret;
 	}
-	ret = extract_attributes("#EXT-X-MEDIA:", line, 14);
+	ret = extract_attributes("#EXT-X-MEDIA:", line, attrs);
 	if (ret) {
 		/* #EXT-X-MEDIA:[TYPE={AUDIO,VIDEO}],[URI],[GROUP-ID],[LANGUAGE],[NAME],[DEFAULT={YES,NO}],[AUTOSELECT={YES,NO}] */
 		M3U8_COMPATIBILITY_VERSION(4);
@@ -744,15 +765,24 @@ static Stream* master_playlist_find_matching_stream(const MasterPlaylist *pl, co
 
 /********** sub_playlist **********/
 
-#define M3U8_BUF_SIZE 2048
-
 GF_EXPORT
 GF_Err gf_m3u8_parse_master_playlist(const char *file, MasterPlaylist **playlist, const char *baseURL)
 {
 	return gf_m3u8_parse_sub_playlist(file, playlist, baseURL, NULL, NULL);
 }
 
-GF_Err declare_sub_playlist(char *currentLine, const char *baseURL, s_accumulated_attributes *attribs, PlaylistElement *sub_playlist, MasterPlaylist **playlist, Stream *in_stream)
+/*creates a media segment element - if known segments were skipped before it, its start time is the end of the last skipped one*/
+static PlaylistElement *m3u8_media_element_new(const char *url, s_accumulated_attributes *attribs)
+{
+	PlaylistElement *e = playlist_element_new(TYPE_UNKNOWN, url, attribs);
+	if (e && !e->utc_start_time && attribs->skipped_end_time) {
+		e->utc_start_time = attribs->skipped_end_time;
+	}
+	attribs->skipped_end_time = 0;
+	return e;
+}
+
+GF_Err declare_sub_playlist(char *currentLine, const char *baseURL, s_accumulated_attributes *attribs, PlaylistElement *sub_playlist, MasterPlaylist **playlist, Stream *in_stream, Bool skip_segment)
 {
 	u32 i, iv, count;
 
@@ -763,12 +793,18 @@ GF_Err declare_sub_playlist(char *currentLine, const char *baseURL, s_accumulate
 		return GF_BAD_PARAM;
 	}
 
-	if (gf_url_is_local(fullURL)) {
+	if (skip_segment) {
+		/*segment already known: no element is created, we only keep track of its timing*/
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[M3U8] skipping known media segment %d %s\n", attribs->current_media_seq, fullURL));
+		attribs->skipped_end_time = (attribs->playlist_utc_timestamp ? attribs->playlist_utc_timestamp : attribs->skipped_end_time) + (u64) (1000*attribs->duration_in_seconds);
+	} else if (gf_url_is_local(fullURL)) {
 		fullURL = gf_url_concatenate(baseURL, fullURL);
 		assert(fullURL);
 	}
 
-	GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[M3U8] declaring %s %s\n", attribs->is_master_playlist ? "sub-playlist" : "media segment", fullURL));
+	if (!skip_segment) {
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[M3U8] declaring %s %s\n", attribs->is_master_playlist ? "sub-playlist" : "media segment", fullURL));
+	}
 
 	memset(attribs->key_iv, 0, sizeof(bin128) );
 	iv = gf_htonl(attribs->current_media_seq);
@@ -866,32 +902,39 @@ GF_Err declare_sub_playlist(char *currentLine, const char *baseURL, s_accumulate
 				assert(fullURL);
 				assert(curr_playlist->url && !curr_playlist->codecs);
 				curr_playlist->codecs = NULL;
-				subElement = playlist_element_new(TYPE_UNKNOWN, fullURL, attribs);
-				if (subElement == NULL) {
-					gf_m3u8_master_playlist_del(playlist);
-					playlist_element_del(curr_playlist);
-					return GF_OUT_OF_MEM;
-				}
-				gf_list_add(curr_playlist->element.playlist.elements, subElement);
 				gf_list_add(stream->variants, curr_playlist);
-				curr_playlist->element.playlist.computed_duration += subElement->duration_info;
+				if (skip_segment) {
+					curr_playlist->element.playlist.computed_duration += attribs->duration_in_seconds;
+				} else {
+					subElement = m3u8_media_element_new(fullURL, attribs);
+					if (subElement == NULL) {
+						gf_m3u8_master_playlist_del(playlist);
+						return GF_OUT_OF_MEM;
+					}
+					gf_list_add(curr_playlist->element.playlist.elements, subElement);
+					curr_playlist->element.playlist.computed_duration += subElement->duration_info;
+				}
 				assert(stream);
 				assert(stream->variants);
 				assert(curr_playlist);
 			} else {
-				PlaylistElement *subElement = playlist_element_new(TYPE_UNKNOWN, fullURL, attribs);
+				PlaylistElement *subElement;
 				if (curr_playlist->element_type != TYPE_PLAYLIST) {
 					curr_playlist->element_type = TYPE_PLAYLIST;
 					if (!curr_playlist->element.playlist.elements)
 						curr_playlist->element.playlist.elements = gf_list_new();
 				}
-				if (subElement == NULL) {
-					gf_m3u8_master_playlist_del(playlist);
-					playlist_element_del(curr_playlist);
-					return GF_OUT_OF_MEM;
+				if (skip_segment) {
+					curr_playlist->element.playlist.computed_duration += attribs->duration_in_seconds;
+				} else {
+					subElement = m3u8_media_element_new(fullURL, attribs);
+					if (subElement == NULL) {
+						gf_m3u8_master_playlist_del(playlist);
+						return GF_OUT_OF_MEM;
+					}
+					gf_list_add(curr_playlist->element.playlist.elements, subElement);
+					curr_playlist->element.playlist.computed_duration += subElement->duration_info;
 				}
-				gf_list_add(curr_playlist->element.playlist.elements, subElement);
-				curr_playlist->element.playlist.computed_duration += subElement->duration_info;
 			}
 		}
 
@@ -947,7 +990,7 @@ GF_Err declare_sub_playlist(char *currentLine, const char *baseURL, s_accumulate
 	return GF_OK;
 }
 
-GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, const char *baseURL, Stream *in_stream, PlaylistElement *sub_playlist)
+static GF_Err m3u8_parse_playlist(const char *file, MasterPlaylist **playlist, const char *baseURL, Stream *in_stream, PlaylistElement *sub_playlist, int known_media_seq_min, int known_media_seq_max)
 {
 	int len, i, currentLineNumber;
 	FILE *f = NULL;
@@ -955,6 +998,7 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 	u32 m3u8_size, m3u8pos;
 	char currentLine[M3U8_BUF_SIZE];
 	char **attributes = NULL;
+	s_line_attributes line_attributes;
 	s_accumulated_attributes attribs;
 
 	if (!strncmp(file, "gmem://", 7)) {
@@ -978,6 +1022,8 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 	}
 	currentLineNumber = 0;
 	reset_attributes(&attribs);
+	attribs.known_media_seq_min = known_media_seq_min;
+	attribs.known_media_seq_max = known_media_seq_max;
 	m3u8pos = 0;
 	while (1) {
 		char *eof;
@@ -1023,7 +1069,7 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 		if (currentLine[0] == '#') {
 			/* A comment or a directive */
 			if (strncmp("#EXT", currentLine, 4) == 0) {
-				attributes = parse_attributes(currentLine, &attribs);
+				attributes = parse_attributes(currentLine, &attribs, &line_attributes);
 				if (attributes == NULL) {
 					GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("[M3U8]Comment at line %d : %s\n", currentLineNumber, currentLine));
 				} else {
@@ -1031,13 +1077,9 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 					i = 0;
 					while (attributes[i] != NULL) {
 						GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, (" [%d]='%s'", i, attributes[i]));
-						gf_free(attributes[i]);
-						attributes[i] = NULL;
 						i++;
 					}
 					GF_LOG(GF_LOG_DEBUG, GF_LOG_DASH, ("\n"));
-					gf_free(attributes);
-					attributes = NULL;
 				}
 				if (attribs.is_playlist_ended) {
 					(*playlist)->playlist_needs_refresh = GF_FALSE;
@@ -1046,7 +1088,7 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 					(*playlist)->independent_segments = GF_TRUE;
 				}
 				if (attribs.mediaURL) {
-					GF_Err e = declare_sub_playlist(attribs.mediaURL, baseURL, &attribs, sub_playlist, playlist, in_stream);
+					GF_Err e = declare_sub_playlist(attribs.mediaURL, baseURL, &attribs, sub_playlist, playlist, in_stream, GF_FALSE);
 					gf_free(attribs.mediaURL);
 					attribs.mediaURL = NULL;
 					if (e != GF_OK) {
@@ -1057,7 +1099,15 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 			}
 		} else {
 			/*file encountered: sub-playlist or segment*/
-			GF_Err e = declare_sub_playlist(currentLine, baseURL, &attribs, sub_playlist, playlist, in_stream);
+			GF_Err e;
+			Bool skip = GF_FALSE;
+			/*live reload: segments already known by the caller are not declared again, unless the media sequence was reset*/
+			if (attribs.known_media_seq_max && attribs.is_media_segment && !attribs.is_master_playlist
+			        && (attribs.min_media_sequence >= attribs.known_media_seq_min)
+			        && (attribs.current_media_seq >= attribs.known_media_seq_min) && (attribs.current_media_seq <= attribs.known_media_seq_max)) {
+				skip = GF_TRUE;
+			}
+			e = declare_sub_playlist(currentLine, baseURL, &attribs, sub_playlist, playlist, in_stream, skip);
 			attribs.current_media_seq += 1;
 			if (e != GF_OK) {
 				if (f) gf_fclose(f);
@@ -1096,3 +1146,13 @@ GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, c
 	}
 	return GF_OK;
 }
+
+GF_Err gf_m3u8_parse_sub_playlist(const char *file, MasterPlaylist **playlist, const char *baseURL, Stream *in_stream, PlaylistElement *sub_playlist)
+{
+	return m3u8_parse_playlist(file, playlist, baseURL, in_stream, sub_playlist, 0, 0);
+}
+
+GF_Err gf_m3u8_parse_media_playlist_update(const char *file, MasterPlaylist **playlist, const char *baseURL, int known_media_seq_min, int known_media_seq_max)
+{
+	return m3u8_parse_playlist(file, playlist, baseURL, NULL, NULL, known_media_seq_min, known_media_seq_max);
+}
@@ -728,6 +728,9 @@ static const char *QCP_SMV_GUID = "\x75\x2B\x7C\x8D\x97\xA7\x46\xED\x98\x5E\xD5\
 #endif // GPAC_DISABLE_AV_PARSERS
 
 
+/*max amount of media data read and written at once when samples are exported as is*/
+#define EXPORT_RUN_SIZE	0x200000
+
 #define DUMP_AVCPARAM(_params) \
 		count = gf_list_count(_params); \
 		for (i=0;i<count;i++) { \
@@ -768,8 +771,10 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 	GF_BitStream *bs;
 	u32 track, i, di, count, m_type, m_stype, dsi_size, qcp_type;
 	Bool is_ogg, has_qcp_pad, is_vobsub;
-	u32 aac_type, aac_mode;
-	char *dsi;
+	u32 aac_type, aac_mode, nal_unit_size;
+	char *dsi, *run_buf;
+	GF_ISOSample *samp;
+	Bool is_nalu;
 	QCPRateTable rtable[8];
 	Bool is_stdout = GF_FALSE;
 	Bool is_webvtt = GF_FALSE;
@@ -1398,23 +1403,51 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 		qcp_type = needs_rate_octet ? 1 : 0;
 	}
 
+	nal_unit_size = 0;
+	if (avccfg) nal_unit_size= avccfg->nal_unit_size;
+	else if (svccfg) nal_unit_size = svccfg->nal_unit_size;
+	else if (mvccfg) nal_unit_size = mvccfg->nal_unit_size;
+	else if (hevccfg) nal_unit_size = hevccfg->nal_unit_size;
+	else if (lhvccfg) nal_unit_size = lhvccfg->nal_unit_size;
+	is_nalu = (avccfg || svccfg || mvccfg || hevccfg || lhvccfg) ? GF_TRUE : GF_FALSE;
+
+	/*samples written as is are copied by runs of contiguous samples*/
+	run_buf = NULL;
+	if (!is_nalu && !aac_mode && !qcp_type && !is_webvtt) {
+		run_buf = (char *)gf_malloc(sizeof(char) * EXPORT_RUN_SIZE);
+	}
+	/*the sample buffer is reused across samples*/
+	samp = gf_isom_sample_new();
+
 	/* Start exporting samples */
 	for (i=0; i<count; i++) {
-		GF_ISOSample *samp = gf_isom_get_sample(dumper->file, track, i+1, &di);
-		if (!samp) {
-			e = gf_isom_last_error(dumper->file);
-			break;
+		if (run_buf) {
+			u32 nb_run, run_size;
+			e = gf_isom_get_sample_run(dumper->file, track, i+1, count-i, run_buf, EXPORT_RUN_SIZE, &nb_run, &run_size);
+			if (!e) {
+				gf_bs_write_data(bs, run_buf, run_size);
+				i += nb_run-1;
+				gf_set_progress("Media Export", i+1, count);
+				if (dumper->flags & GF_EXPORT_DO_ABORT) break;
+				continue;
+			}
+			/*samples rewritten when fetched, or larger than the run buffer: use regular sample fetch*/
+			if (e==GF_NOT_SUPPORTED) {
+				gf_free(run_buf);
+				run_buf = NULL;
+			} else if (e!=GF_BUFFER_TOO_SMALL) {
+				break;
+			}
+			e = GF_OK;
 		}
+
+		e = gf_isom_get_sample_into(dumper->file, track, i+1, samp, &di);
+		if (e) break;
+
 		/*AVC sample to NALU*/
-		if (avccfg || svccfg || mvccfg || hevccfg || lhvccfg) {
-			u32 j, nal_size, remain, nal_unit_size;
+		if (is_nalu) {
+			u32 j, nal_size, remain;
 			char *ptr = samp->data;
-			nal_unit_size = 0;
-			if (avccfg) nal_unit_size= avccfg->nal_unit_size;
-			else if (svccfg) nal_unit_size = svccfg->nal_unit_size;
-			else if (mvccfg) nal_unit_size = mvccfg->nal_unit_size;
-			else if (hevccfg) nal_unit_size = hevccfg->nal_unit_size;
-			else if (lhvccfg) nal_unit_size = lhvccfg->nal_unit_size;
 
 			if (i && dsi && samp->IsRAP) {
 				gf_bs_write_data(bs, dsi, dsi_size);
@@ -1428,35 +1461,42 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 					break;
 				}
 				for (j=0; j<nal_unit_size; j++) {
-					nal_size |= ((u8) *ptr);
+					nal_size |= ((u8) ptr[j]);
 					if (j+1<nal_unit_size) nal_size<<=8;
-					remain--;
-					ptr++;
 				}
-				gf_bs_write_u32(bs, 1);
+				/*4-bytes NALU size: replace it with the start code in place, the sample is written at once*/
+				if (nal_unit_size==4) {
+					ptr[0] = ptr[1] = ptr[2] = 0;
+					ptr[3] = 1;
+				} else {
+					gf_bs_write_u32(bs, 1);
+				}
+				remain -= nal_unit_size;
+				ptr += nal_unit_size;
 				if (remain < nal_size) {
 					GF_LOG(GF_LOG_ERROR, GF_LOG_AUTHOR, ("Sample %d (size %d): Corrupted NAL Unit: size %d - bytes left %d\n", i+1, samp->dataLength, nal_size, remain) );
 					nal_size = remain;
 				}
-				gf_bs_write_data(bs, ptr, nal_size);
+				if (nal_unit_size!=4) gf_bs_write_data(bs, ptr, nal_size);
 				ptr += nal_size;
 				remain -= nal_size;
 			}
+			if (nal_unit_size==4) gf_bs_write_data(bs, samp->data, samp->dataLength - remain);
 		}
 		/*adts frame header*/
 		else if (aac_mode > 0) {
-			gf_bs_write_int(bs, 0xFFF, 12);/*sync*/
-			gf_bs_write_int(bs, (aac_mode==1) ? 1 : 0, 1);/*mpeg2 aac*/
-			gf_bs_write_int(bs, 0, 2); /*layer*/
-			gf_bs_write_int(bs, 1, 1); /* protection_absent*/
-			gf_bs_write_int(bs, aac_type, 2);
-			gf_bs_write_int(bs, a_cfg.base_sr_index, 4);
-			gf_bs_write_int(bs, 0, 1);
-			gf_bs_write_int(bs, a_cfg.nb_chan, 3);
-			gf_bs_write_int(bs, 0, 4);
-			gf_bs_write_int(bs, 7+samp->dataLength, 13);
-			gf_bs_write_int(bs, 0x7FF, 11);
-			gf_bs_write_int(bs, 0, 2);
+			u8 adts[7];
+			u32 frame_size = 7+samp->dataLength;
+			adts[0] = 0xFF;/*sync*/
+			/*sync, mpeg2 aac, layer 0, protection_absent*/
+			adts[1] = 0xF0 | ((aac_mode==1) ? 0x08 : 0) | 0x01;
+			adts[2] = (aac_type<<6) | (a_cfg.base_sr_index<<2) | ((a_cfg.nb_chan>>2) & 0x1);
+			adts[3] = ((a_cfg.nb_chan & 0x3) << 6) | ((frame_size>>11) & 0x3);
+			adts[4] = (frame_size>>3) & 0xFF;
+			/*buffer fullness 0x7FF, one raw data block*/
+			adts[5] = ((frame_size & 0x7) << 5) | 0x1F;
+			adts[6] = 0xFC;
+			gf_bs_write_data(bs, (char *) adts, 7);
 		}
 		/*fix rate octet for QCP*/
 		else if (qcp_type) {
@@ -1468,13 +1508,14 @@ GF_Err gf_media_export_native(GF_MediaExporter *dumper)
 				}
 			}
 		}
-		if (!avccfg && !svccfg && !mvccfg && !hevccfg && !lhvccfg &!is_webvtt) {
+		if (!is_nalu && !is_webvtt) {
 			gf_bs_write_data(bs, samp->data, samp->dataLength);
 		}
-		gf_isom_sample_del(&samp);
 		gf_set_progress("Media Export", i+1, count);
 		if (dumper->flags & GF_EXPORT_DO_ABORT) break;
 	}
+	gf_isom_sample_del(&samp);
+	if (run_buf) gf_free(run_buf);
 	if (has_qcp_pad) gf_bs_write_u8(bs, 0);
 exit:
 	if (avccfg) gf_odf_avc_cfg_del(avccfg);
@@ -301,12 +301,54 @@ static void gf_mpd_parse_segment_base_generic(GF_MPD *mpd, GF_MPD_SegmentBase *s
 	}
 }
 
+static void gf_mpd_parse_segment_timeline_entry_attr(GF_MPD_SegmentTimelineEntry *seg_tl_ent, char *name, char *value)
+{
+	if (!strcmp(name, "t"))
+		seg_tl_ent->start_time = gf_mpd_parse_long_int(value);
+	else if (!strcmp(name, "d"))
+		seg_tl_ent->duration = gf_mpd_parse_int(value);
+	else if (!strcmp(name, "r")) {
+		seg_tl_ent->repeat_count = gf_mpd_parse_int(value);
+		if (seg_tl_ent->repeat_count == (u32)-1)
+			seg_tl_ent->repeat_count--;
+	}
+}
+
+typedef struct
+{
+	GF_XMLNode *node;
+	GF_MPD_SegmentTimeline *timeline;
+} GF_MPD_ParsedTimeline;
+
+static GF_MPD_SegmentTimeline *gf_mpd_get_parsed_timeline(GF_MPD *mpd, GF_XMLNode *root)
+{
+	u32 i, count;
+	count = gf_list_count(mpd->parsed_timelines);
+	/*timelines are converted in document order, so this usually matches the first entry*/
+	for (i=0; i<count; i++) {
+		GF_MPD_ParsedTimeline *ptl = (GF_MPD_ParsedTimeline *)gf_list_get(mpd->parsed_timelines, i);
+		if (ptl->node == root) {
+			GF_MPD_SegmentTimeline *seg = ptl->timeline;
+			gf_list_rem(mpd->parsed_timelines, i);
+			gf_free(ptl);
+			return seg;
+		}
+	}
+	return NULL;
+}
+
 static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XMLNode *root)
 {
 	u32 i, j;
 	GF_XMLAttribute *att;
 	GF_XMLNode *child;
 	GF_MPD_SegmentTimeline *seg;
+
+	if (mpd->parsed_timelines) {
+		seg = gf_mpd_get_parsed_timeline(mpd, root);
+		if (seg) return seg;
+	}
+
 	GF_SAFEALLOC(seg, GF_MPD_SegmentTimeline);
 	if (!seg) return NULL;
 	seg->entries = gf_list_new();
@@ -322,15 +364,7 @@ static GF_MPD_SegmentTimeline *gf_mpd_parse_segment_timeline(GF_MPD *mpd, GF_XML
 
 			j = 0;
 			while ( (att = gf_list_enum(child->attributes, &j)) ) {
-				if (!strcmp(att->name, "t"))
-					seg_tl_ent->start_time = gf_mpd_parse_long_int(att->value);
-				else if (!strcmp(att->name, "d"))
-					seg_tl_ent->duration = gf_mpd_parse_int(att->value);
-				else if (!strcmp(att->name, "r")) {
-					seg_tl_ent->repeat_count = gf_mpd_parse_int(att->value);
-					if (seg_tl_ent->repeat_count == (u32)-1)
-						seg_tl_ent->repeat_count--;
-				}
+				gf_mpd_parse_segment_timeline_entry_attr(seg_tl_ent, att->name, att->value);
 			}
 		}
 	}
@@ -1113,6 +1147,178 @@ GF_Err gf_mpd_init_from_dom(GF_XMLNode *root, GF_MPD *mpd, const char *default_b
 	return gf_mpd_complete_from_dom(root, mpd, default_base_url);
 }
 
+typedef struct
+{
+	GF_MPD *mpd;
+	GF_SAXParser *sax;
+	GF_List *stack;
+	GF_XMLNode *root;
+	/*SegmentTimeline being loaded and depth of the current node below it*/
+	GF_MPD_ParsedTimeline *timeline;
+	u32 timeline_depth;
+	GF_Err last_error;
+} GF_MPD_Loader;
+
+static void gf_mpd_loader_node_start(void *sax_cbck, const char *node_name, const char *name_space, const GF_XMLAttribute *attributes, u32 nb_attributes)
+{
+	u32 i;
+	GF_XMLNode *node;
+	GF_MPD_Loader *loader = (GF_MPD_Loader *)sax_cbck;
+
+	if (loader->timeline) {
+		loader->timeline_depth++;
+		/*S entries are directly converted, anything else in the timeline is ignored as in gf_mpd_parse_segment_timeline*/
+		if ((loader->timeline_depth==1) && !strcmp(node_name, "S")) {
+			GF_XMLNode *tl_node = loader->timeline->node;
+			GF_MPD_SegmentTimelineEntry *seg_tl_ent;
+			if ((!name_space && tl_node->ns) || (name_space && (!tl_node->ns || strcmp(name_space, tl_node->ns))))
+				return;
+			GF_SAFEALLOC(seg_tl_ent, GF_MPD_SegmentTimelineEntry);
+			if (!seg_tl_ent) {
+				loader->last_error = GF_OUT_OF_MEM;
+				gf_xml_sax_suspend(loader->sax, GF_TRUE);
+				return;
+			}
+			gf_list_add(loader->timeline->timeline->entries, seg_tl_ent);
+			for (i=0; i<nb_attributes; i++) {
+				gf_mpd_parse_segment_timeline_entry_attr(seg_tl_ent, attributes[i].name, attributes[i].value);
+			}
+		}
+		return;
+	}
+	if (loader->root && !gf_list_count(loader->stack)) {
+		gf_xml_sax_suspend(loader->sax, GF_TRUE);
+		return;
+	}
+
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		loader->last_error = GF_OUT_OF_MEM;
+		gf_xml_sax_suspend(loader->sax, GF_TRUE);
+		return;
+	}
+	node->attributes = gf_list_new();
+	node->content = gf_list_new();
+	node->name = gf_strdup(node_name);
+	if (name_space) node->ns = gf_strdup(name_space);
+	for (i=0; i<nb_attributes; i++) {
+		GF_XMLAttribute *att;
+		GF_SAFEALLOC(att, GF_XMLAttribute);
+		if (!att) {
+			gf_xml_dom_node_del(node);
+			loader->last_error = GF_OUT_OF_MEM;
+			gf_xml_sax_suspend(loader->sax, GF_TRUE);
+			return;
+		}
+		att->name = gf_strdup(attributes[i].name);
+		att->value = gf_strdup(attributes[i].value);
+		gf_list_add(node->attributes, att);
+	}
+	if (!loader->root) loader->root = node;
+	else gf_list_add(((GF_XMLNode *)gf_list_last(loader->stack))->content, node);
+	gf_list_add(loader->stack, node);
+
+	if (!strcmp(node_name, "SegmentTimeline")) {
+		GF_SAFEALLOC(loader->timeline, GF_MPD_ParsedTimeline);
+		if (loader->timeline) GF_SAFEALLOC(loader->timeline->timeline, GF_MPD_SegmentTimeline);
+		if (!loader->timeline || !loader->timeline->timeline) {
+			if (loader->timeline) gf_free(loader->timeline);
+			loader->timeline = NULL;
+			loader->last_error = GF_OUT_OF_MEM;
+			gf_xml_sax_suspend(loader->sax, GF_TRUE);
+			return;
+		}
+		loader->timeline->node = node;
+		loader->timeline->timeline->entries = gf_list_new();
+		loader->timeline_depth = 0;
+		gf_list_add(loader->mpd->parsed_timelines, loader->timeline);
+	}
+}
+
+static void gf_mpd_loader_node_end(void *sax_cbck, const char *node_name, const char *name_space)
+{
+	GF_XMLNode *last;
+	GF_MPD_Loader *loader = (GF_MPD_Loader *)sax_cbck;
+
+	if (loader->timeline) {
+		if (loader->timeline_depth) {
+			loader->timeline_depth--;
+			return;
+		}
+		loader->timeline = NULL;
+	}
+	last = (GF_XMLNode *)gf_list_last(loader->stack);
+	if (!last || strcmp(last->name, node_name) || (!name_space && last->ns) || (name_space && (!last->ns || strcmp(last->ns, name_space)))) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Invalid node stack: closing node is %s but %s was expected\n", node_name, last ? last->name : "unknown"));
+		loader->last_error = GF_NON_COMPLIANT_BITSTREAM;
+		gf_xml_sax_suspend(loader->sax, GF_TRUE);
+		return;
+	}
+	gf_list_rem_last(loader->stack);
+}
+
+static void gf_mpd_loader_text_content(void *sax_cbck, const char *content, Bool is_cdata)
+{
+	GF_XMLNode *node, *last;
+	GF_MPD_Loader *loader = (GF_MPD_Loader *)sax_cbck;
+	if (loader->timeline) return;
+	last = (GF_XMLNode *)gf_list_last(loader->stack);
+	if (!last) return;
+
+	GF_SAFEALLOC(node, GF_XMLNode);
+	if (!node) {
+		loader->last_error = GF_OUT_OF_MEM;
+		gf_xml_sax_suspend(loader->sax, GF_TRUE);
+		return;
+	}
+	node->type = is_cdata ? GF_XML_CDATA_TYPE : GF_XML_TEXT_TYPE;
+	node->name = gf_strdup(content);
+	gf_list_add(last->content, node);
+}
+
+GF_EXPORT
+GF_Err gf_mpd_init_from_file(const char *file, GF_MPD *mpd, const char *default_base_url)
+{
+	GF_Err e;
+	GF_MPD_Loader loader;
+
+	if (!file || !mpd) return GF_BAD_PARAM;
+
+	memset(&loader, 0, sizeof(GF_MPD_Loader));
+	loader.mpd = mpd;
+	loader.stack = gf_list_new();
+	mpd->parsed_timelines = gf_list_new();
+	loader.sax = gf_xml_sax_new(gf_mpd_loader_node_start, gf_mpd_loader_node_end, gf_mpd_loader_text_content, &loader);
+
+	e = gf_xml_sax_parse_file(loader.sax, file, NULL);
+	if (e>0) e = GF_OK;
+	if (!e) e = loader.last_error;
+	if (e) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Failed to load %s: %s\n", file, gf_xml_sax_get_error(loader.sax) ));
+	} else if (!loader.root) {
+		e = GF_NON_COMPLIANT_BITSTREAM;
+	} else if (gf_list_count(loader.stack)) {
+		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[MPD] Failed to load %s: unterminated node %s\n", file, ((GF_XMLNode *)gf_list_last(loader.stack))->name));
+		e = GF_NON_COMPLIANT_BITSTREAM;
+	} else {
+		e = gf_mpd_init_from_dom(loader.root, mpd, default_base_url);
+	}
+
+	/*timelines not used during the conversion (e.g. in unknown elements)*/
+	while (gf_list_count(mpd->parsed_timelines)) {
+		GF_MPD_ParsedTimeline *ptl = (GF_MPD_ParsedTimeline *)gf_list_pop_back(mpd->parsed_timelines);
+		gf_mpd_segment_timeline_free(ptl->timeline);
+		gf_free(ptl);
+	}
+	gf_list_del(mpd->parsed_timelines);
+	mpd->parsed_timelines = NULL;
+
+	gf_xml_sax_del(loader.sax);
+	gf_list_del(loader.stack);
+	if (loader.root) gf_xml_dom_node_del(loader.root);
+	return e;
+}
+
 GF_EXPORT
 void gf_mpd_getter_del_session(GF_FileDownload *getter) {
 	if (!getter || !getter->del_session)
@@ -1797,8 +2003,9 @@ GF_Err gf_m3u8_to_mpd(const char *m3u8_file, const char *base_url,
 }
 
 GF_EXPORT
-GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDownload *getter, Bool *is_static, u64 *duration)
+GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDownload *getter, Bool *is_static, u64 *duration, u32 known_media_seq_min, u32 known_media_seq_max)
 {
+	const char *m3u8_file;
 	GF_Err e;
 	MasterPlaylist *pl = NULL;
 	Stream *stream;
@@ -1814,14 +2021,20 @@ GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDow
 	}
 
 	if (gf_url_is_local(rep->segment_list->xlink_href)) {
-		e = gf_m3u8_parse_master_playlist(rep->segment_list->xlink_href, &pl, rep->segment_list->xlink_href);
+		m3u8_file = rep->segment_list->xlink_href;
 	} else {
 		e = getter->new_session(getter, rep->segment_list->xlink_href);
 		if (e) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[DASH] Download failed for %s\n", rep->segment_list->xlink_href));
 			return e;
 		}
-		e = gf_m3u8_parse_master_playlist(getter->get_cache_name(getter), &pl, rep->segment_list->xlink_href);
+		m3u8_file = getter->get_cache_name(getter);
+	}
+	//live reload, only declare segments we don't know yet
+	if (known_media_seq_max) {
+		e = gf_m3u8_parse_media_playlist_update(m3u8_file, &pl, rep->segment_list->xlink_href, known_media_seq_min, known_media_seq_max);
+	} else {
+		e = gf_m3u8_parse_master_playlist(m3u8_file, &pl, rep->segment_list->xlink_href);
 	}
 	if (e) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_DASH, ("[M3U8] Failed to parse playlist %s\n", rep->segment_list->xlink_href));
@@ -1907,7 +2120,8 @@ GF_Err gf_m3u8_solve_representation_xlink(GF_MPD_Representation *rep, GF_FileDow
 		}
 	}
 
-	if (!gf_list_count(rep->segment_list->segment_URLs)) {
+	//when reloading, an empty list means no new segment and is kept for the merge with the known ones
+	if (!known_media_seq_max && !gf_list_count(rep->segment_list->segment_URLs)) {
 		gf_list_del(rep->segment_list->segment_URLs);
 		rep->segment_list->segment_URLs = NULL;
 	}
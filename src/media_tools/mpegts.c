@@ -31,6 +31,7 @@
 #include <gpac/constants.h>
 #include <gpac/internal/media_dev.h>
 #include <gpac/download.h>
+#include <gpac/trace.h>
 
 
 #ifndef GPAC_DISABLE_STREAMING
@@ -3480,8 +3481,7 @@ static GF_Err gf_m2ts_process_packet(GF_M2TS_Demuxer *ts, unsigned char *data)
 	return GF_OK;
 }
 
-GF_EXPORT
-GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
+static GF_Err m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 {
 	GF_Err e;
 	u32 pos, pck_size;
@@ -3543,6 +3543,16 @@ GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
 	return e;
 }
 
+GF_EXPORT
+GF_Err gf_m2ts_process_data(GF_M2TS_Demuxer *ts, char *data, u32 data_size)
+{
+	GF_Err e;
+	GF_TRACE_BEGIN(GF_LOG_CONTAINER, "m2ts demux");
+	e = m2ts_process_data(ts, data, data_size);
+	GF_TRACE_END(GF_LOG_CONTAINER, "m2ts demux");
+	return e;
+}
+
 GF_ESD *gf_m2ts_get_esd(GF_M2TS_ES *es)
 {
 	GF_ESD *esd;
@@ -4119,16 +4129,15 @@ static u32 gf_m2ts_demuxer_run(void *_p)
 				/*process chunk*/
 				if (is_rtp) {
 #ifndef GPAC_DISABLE_STREAMING
-					char *pck;
+					const char *pck;
 					seq_num = ((data[2] << 8) & 0xFF00) | (data[3] & 0xFF);
 					gf_rtp_reorderer_add(ch, (void *) data, size, seq_num);
 
-					pck = (char *) gf_rtp_reorderer_get(ch, &size);
+					pck = gf_rtp_reorderer_get_ex(ch, &size);
 					if (pck) {
-						gf_m2ts_process_data(ts, pck+12, size-12);
+						gf_m2ts_process_data(ts, (char *) pck+12, size-12);
 						if (record_to)
-							fwrite(data+12, size-12, 1, record_to);
-						gf_free(pck);
+							fwrite(pck+12, size-12, 1, record_to);
 					}
 #else
 					gf_m2ts_process_data(ts, data+12, size-12);
@@ -32,6 +32,7 @@
 #include "media_memory.h"
 #include "media_control.h"
 #include "input_sensor.h"
+#include <gpac/trace.h>
 
 GF_Err Codec_Load(GF_Codec *codec, GF_ESD *esd, u32 PL);
 GF_Err gf_codec_process_raw_media_pull(GF_Codec *codec, u32 TimeAvailable);
@@ -1713,6 +1714,7 @@ GF_Err gf_codec_process_ocr(GF_Codec *codec, u32 TimeAvailable)
 
 GF_Err gf_codec_process(GF_Codec *codec, u32 TimeAvailable)
 {
+	GF_Err e;
 	if (codec->Status == GF_ESM_CODEC_STOP) return GF_OK;
 #ifndef GPAC_DISABLE_VRML
 	codec->Muted = (codec->odm->media_ctrl && codec->odm->media_ctrl->control->mute) ? 1 : 0;
@@ -1720,7 +1722,11 @@ GF_Err gf_codec_process(GF_Codec *codec, u32 TimeAvailable)
 	codec->Muted = 0;
 #endif
 
-	return codec->process(codec, TimeAvailable);
+	GF_TRACE_BEGIN(GF_LOG_CODEC, "decode");
+	e = codec->process(codec, TimeAvailable);
+	GF_TRACE_END(GF_LOG_CODEC, "decode");
+	if (codec->CB) GF_TRACE_COUNTER(GF_LOG_CODEC, "composition units", codec->CB->UnitCount);
+	return e;
 }
 
 
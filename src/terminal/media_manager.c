@@ -28,6 +28,7 @@
 #include <gpac/internal/terminal_dev.h>
 #include "media_memory.h"
 #include <gpac/internal/compositor_dev.h>
+#include <gpac/trace.h>
 
 
 u32 MM_Loop(void *par);
@@ -286,7 +287,9 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 #endif
 
 //	GF_LOG(GF_LOG_DEBUG, GF_LOG_MEDIA, ("[Media Manager] Entering simultion step\n"));
+	GF_TRACE_BEGIN(GF_LOG_MEDIA, "handle services");
 	gf_term_handle_services(term);
+	GF_TRACE_END(GF_LOG_MEDIA, "handle services");
 
 #ifndef GF_DISABLE_LOG
 	term->compositor->networks_time = gf_sys_clock() - term->compositor->networks_time;
@@ -296,6 +299,7 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 	term->compositor->decoders_time = gf_sys_clock();
 #endif
 	gf_mx_p(term->mm_mx);
+	GF_TRACE_BEGIN(GF_LOG_MEDIA, "decoders");
 
 	count = gf_list_count(term->codecs);
 	time_left = term->frame_duration;
@@ -348,6 +352,8 @@ static u32 MM_SimulationStep_Decoder(GF_Terminal *term, u32 *nb_active_decs)
 			break;
 		}
 	}
+	GF_TRACE_END(GF_LOG_MEDIA, "decoders");
+	GF_TRACE_COUNTER(GF_LOG_MEDIA, "active decoders", *nb_active_decs);
 	gf_mx_v(term->mm_mx);
 #ifndef GF_DISABLE_LOG
 	term->compositor->decoders_time = gf_sys_clock() - term->compositor->decoders_time;
@@ -79,6 +79,15 @@ static GFINLINE void my_large_gf_free(void *ptr) {
 #endif
 
 
+/*makes sure the unit can hold size bytes, reusing its current buffer whenever large enough*/
+static void gf_cm_unit_alloc_data(GF_CMUnit *cu, u32 size)
+{
+	if (cu->data && (cu->alloc_size >= size)) return;
+	if (cu->data) my_large_gf_free(cu->data);
+	cu->data = (char*)my_large_alloc(size);
+	cu->alloc_size = cu->data ? size : 0;
+}
+
 static void gf_cm_unit_del(GF_CMUnit *cb, Bool no_data_allocation)
 {
 	if (!cb)
@@ -130,7 +139,10 @@ GF_CompositionMemory *gf_cm_new(u32 UnitSize, u32 capacity, Bool no_allocation)
 			cu->data = NULL;
 		} else {
 			cu->data = UnitSize ? (char*)my_large_alloc(sizeof(char)*UnitSize) : NULL;
-			if (cu->data) memset(cu->data, 0, sizeof(char)*UnitSize);
+			if (cu->data) {
+				memset(cu->data, 0, sizeof(char)*UnitSize);
+				cu->alloc_size = UnitSize;
+			}
 		}
 		prev = cu;
 		capacity --;
@@ -453,8 +465,8 @@ void gf_cm_resize(GF_CompositionMemory *cb, u32 newCapacity)
 			cu->frame = NULL;
 		}
 		if (!cb->no_allocation) {
-			my_large_gf_free(cu->data);
-			cu->data = (char*) my_large_alloc(newCapacity);
+			/*only reallocate when growing, shrinking (eg resolution switch) keeps the buffers*/
+			gf_cm_unit_alloc_data(cu, newCapacity);
 		} else {
 			cu->data = NULL;
 			if (cu->dataLength && cb->odm->raw_frame_sema) {
@@ -479,15 +491,37 @@ void gf_cm_resize(GF_CompositionMemory *cb, u32 newCapacity)
 void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 {
 	GF_CMUnit *cu, *prev;
-	u32 i;
+	u32 i, nb_buffers;
+	char **buffers = NULL;
+	u32 *buffer_sizes = NULL;
 	if (!Capacity || !UnitSize) return;
 
 	gf_odm_lock(cb->odm, 1);
 	if (cb->input) {
+		nb_buffers = 0;
+		/*keep the previous data buffers so that they can be reused by the new units*/
+		if (!cb->no_allocation && cb->Capacity) {
+			buffers = (char **)gf_malloc(sizeof(char *) * cb->Capacity);
+			buffer_sizes = (u32 *)gf_malloc(sizeof(u32) * cb->Capacity);
+			cu = cb->input;
+			while (buffers && buffer_sizes && (nb_buffers < cb->Capacity)) {
+				if (cu->data) {
+					buffers[nb_buffers] = cu->data;
+					buffer_sizes[nb_buffers] = cu->alloc_size;
+					nb_buffers++;
+					cu->data = NULL;
+					cu->alloc_size = 0;
+				}
+				cu = cu->next;
+				if (cu == cb->input) break;
+			}
+		}
 		/*break the loop and destroy*/
 		cb->input->prev->next = NULL;
 		gf_cm_unit_del(cb->input, cb->no_allocation);
 		cb->input = NULL;
+	} else {
+		nb_buffers = 0;
 	}
 
 	cu = NULL;
@@ -508,7 +542,16 @@ void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 		if (cb->no_allocation) {
 			cu->data = NULL;
 		} else {
-			cu->data = (char*)my_large_alloc(UnitSize);
+			u32 j;
+			for (j=0; j<nb_buffers; j++) {
+				if (buffers[j] && (buffer_sizes[j] >= UnitSize)) {
+					cu->data = buffers[j];
+					cu->alloc_size = buffer_sizes[j];
+					buffers[j] = NULL;
+					break;
+				}
+			}
+			if (!cu->data) gf_cm_unit_alloc_data(cu, UnitSize);
 		}
 		prev = cu;
 		Capacity --;
@@ -517,6 +560,13 @@ void gf_cm_reinit(GF_CompositionMemory *cb, u32 UnitSize, u32 Capacity)
 	cu->next = cb->input;
 	cb->input->prev = cu;
 	cb->output = cb->input;
+
+	/*release buffers too small or no longer needed*/
+	for (i=0; i<nb_buffers; i++) {
+		if (buffers[i]) my_large_gf_free(buffers[i]);
+	}
+	if (buffers) gf_free(buffers);
+	if (buffer_sizes) gf_free(buffer_sizes);
 	gf_odm_lock(cb->odm, 0);
 }
 
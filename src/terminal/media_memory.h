@@ -98,6 +98,8 @@ typedef struct _composition_unit {
 
 	u32 dataLength;
 	char* data;
+	/*allocated size of data, may be larger than the unit size of the composition memory after a resize*/
+	u32 alloc_size;
 
 	u64 sender_ntp;
 	
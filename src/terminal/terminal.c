@@ -270,7 +270,7 @@ static Bool term_check_locales(void *__self, const char *locales_parent_path, co
 	        (locales_parent_path && (locales_parent_path[0] != '/') && strstr(locales_parent_path, "://") && strnicmp(locales_parent_path, "file://", 7))) {
 		return 0;
 	}
-	opt = gf_cfg_get_key(loc->term->user->config, "Systems", "Language2CC");
+	opt = gf_cfg_get_key_by_handle(loc->term->cfg_language);
 	if (opt) {
 		if (!strcmp(opt, "*") || !strcmp(opt, "un") )
 			opt = NULL;
@@ -667,6 +667,9 @@ GF_Terminal *gf_term_new(GF_User *user)
 	gf_sys_init(GF_MemTrackerNone);
 
 	tmp->user = user;
+	tmp->cfg_time_slice = gf_cfg_get_key_handle(user->config, "Systems", "TimeSlice");
+	tmp->cfg_frame_rate = gf_cfg_get_key_handle(user->config, "Compositor", "FrameRate");
+	tmp->cfg_language = gf_cfg_get_key_handle(user->config, "Systems", "Language2CC");
 
 	if (user->init_flags & GF_TERM_NO_DECODER_THREAD) {
 		if (user->init_flags & GF_TERM_NO_VISUAL_THREAD) {
@@ -2253,13 +2256,13 @@ GF_Err gf_term_set_speed(GF_Terminal *term, Fixed speed)
 	if (speed<0)
 		speed = -speed;
 
-	opt = gf_cfg_get_key(term->user->config, "Systems", "TimeSlice");
+	opt = gf_cfg_get_key_by_handle(term->cfg_time_slice);
 	if (!opt) opt="30";
 	i = (u32) ( atoi(opt) / FIX2FLT(speed) );
 	if (!i) i = 1;
 	term->frame_duration = i;
 
-	opt = gf_cfg_get_key(term->user->config, "Compositor", "FrameRate");
+	opt = gf_cfg_get_key_by_handle(term->cfg_frame_rate);
 	fps = atoi(opt);
 	fps *= FIX2FLT(speed);
 	if (fps>100) fps = 1000;
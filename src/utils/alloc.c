@@ -191,6 +191,9 @@ enum
 
 size_t gpac_allocated_memory = 0;
 size_t gpac_nb_alloc_blocs = 0;
+/*allocations served by memory arenas, and number of blocks used to serve them*/
+static size_t gpac_arena_nb_allocs = 0;
+static size_t gpac_arena_nb_blocks = 0;
 
 #ifdef _WIN32_WCE
 #define assert(p)
@@ -825,6 +828,19 @@ static void print_memory_size()
 {
 	unsigned int level = gpac_nb_alloc_blocs ? GF_MEMORY_ERROR : GF_MEMORY_INFO;
 	GF_LOG(level, GF_LOG_MEMORY, ("[MemTracker] Total: %d bytes allocated in %d blocks\n", (u32) gpac_allocated_memory,  (u32) gpac_nb_alloc_blocs ));
+	if (gpac_arena_nb_allocs) {
+		GF_LOG(GF_MEMORY_INFO, GF_LOG_MEMORY, ("[MemTracker] Arenas: %d allocations served from %d blocks\n", (u32) gpac_arena_nb_allocs, (u32) gpac_arena_nb_blocks));
+	}
+}
+
+/*called by arenas when their allocations are released*/
+static void register_arena_stats(u32 nb_allocs, u32 nb_blocks)
+{
+	if (!gpac_allocations_lock) return;
+	gf_mx_p(gpac_allocations_lock);
+	gpac_arena_nb_allocs += nb_allocs;
+	gpac_arena_nb_blocks += nb_blocks;
+	gf_mx_v(gpac_allocations_lock);
 }
 
 GF_EXPORT
@@ -879,6 +895,89 @@ void gf_memory_print()
 #endif /*GPAC_MEMORY_TRACKING*/
 
 
+typedef struct __gf_arena_block
+{
+	struct __gf_arena_block *next;
+	u32 size, used;
+} GF_ArenaBlock;
+
+/*block header size, keeping block data aligned on 8 bytes*/
+#define ARENA_BLOCK_HDR	((sizeof(GF_ArenaBlock) + 7) & ~7)
+
+struct __gf_mem_arena
+{
+	u32 block_size;
+	/*head is the block currently used for allocations*/
+	GF_ArenaBlock *head;
+	u32 nb_allocs, nb_blocks;
+};
+
+GF_EXPORT
+GF_MemArena *gf_arena_new(u32 block_size)
+{
+	GF_MemArena *arena;
+	GF_SAFEALLOC(arena, GF_MemArena);
+	if (!arena) return NULL;
+	arena->block_size = block_size ? (block_size + 7) & ~7 : 4096;
+	return arena;
+}
+
+GF_EXPORT
+void gf_arena_reset(GF_MemArena *arena)
+{
+	if (!arena) return;
+	while (arena->head) {
+		GF_ArenaBlock *blk = arena->head;
+		arena->head = blk->next;
+		gf_free(blk);
+	}
+#ifdef GPAC_MEMORY_TRACKING
+	if (arena->nb_allocs) register_arena_stats(arena->nb_allocs, arena->nb_blocks);
+#endif
+	arena->nb_allocs = arena->nb_blocks = 0;
+}
+
+GF_EXPORT
+void gf_arena_del(GF_MemArena *arena)
+{
+	if (!arena) return;
+	gf_arena_reset(arena);
+	gf_free(arena);
+}
+
+GF_EXPORT
+void *gf_arena_alloc(GF_MemArena *arena, u32 size)
+{
+	char *ptr;
+	GF_ArenaBlock *blk;
+	if (!arena || !size || (size > 0xFFFFFFFF - ARENA_BLOCK_HDR - 7)) return NULL;
+	size = (size + 7) & ~7;
+
+	blk = arena->head;
+	if (!blk || (blk->size - blk->used < size)) {
+		u32 blk_size = (size > arena->block_size) ? size : arena->block_size;
+		blk = (GF_ArenaBlock *)gf_malloc(ARENA_BLOCK_HDR + blk_size);
+		if (!blk) return NULL;
+		blk->size = blk_size;
+		blk->used = 0;
+		/*oversized requests get their own block, the current block keeps serving small requests*/
+		if (arena->head && (blk_size > arena->block_size)) {
+			blk->next = arena->head->next;
+			arena->head->next = blk;
+		} else {
+			blk->next = arena->head;
+			arena->head = blk;
+		}
+		arena->nb_blocks++;
+	}
+	ptr = (char *)blk + ARENA_BLOCK_HDR + blk->used;
+	blk->used += size;
+	arena->nb_allocs++;
+	memset(ptr, 0, size);
+	return ptr;
+}
+
+
 /*gf_asprintf(): as_printf portable implementation*/
 #if defined(WIN32) || defined(_WIN32_WCE) || (defined (__SVR4) && defined (__sun))
 static GFINLINE int gf_vasprintf (char **strp, const char *fmt, va_list ap)
@@ -129,7 +129,7 @@ struct __DownloadedCacheEntryStruct
 	*/
 	FILE * writeFilePtr;
 	/**
-	* Bytes written during this cache session
+	* Bytes written during this cache session, not including data pending in the write-behind buffer
 	*/
 	u32 written_in_cache;
 	/**
@@ -164,6 +164,10 @@ struct __DownloadedCacheEntryStruct
 	Bool memory_stored;
 	u32 mem_allocated;
 	u8 *mem_storage;
+
+	/*write-behind buffer for disk caches: data is written to the cache file by blocks of write_buffer_alloc bytes*/
+	char *write_buffer;
+	u32 write_buffer_alloc, write_buffer_size;
 };
 
 Bool delete_cache_files(void *cbck, char *item_name, char *item_path, GF_FileEnumInfo *file_info) {
@@ -565,6 +569,47 @@ u32 gf_cache_get_content_length( const DownloadedCacheEntry entry)
 	return entry ? entry->contentLength : 0;
 }
 
+/*writes pending data of the write-behind buffer to the cache file*/
+static GF_Err gf_cache_flush_write_buffer(const DownloadedCacheEntry entry)
+{
+	u32 written;
+	if (!entry->write_buffer_size || !entry->writeFilePtr) return GF_OK;
+
+	written = (u32) gf_fwrite(entry->write_buffer, sizeof(char), entry->write_buffer_size, entry->writeFilePtr);
+	if (written != entry->write_buffer_size) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[CACHE] Error while writting %d bytes of data to cache : has written only %d bytes.", entry->write_buffer_size, written));
+		entry->write_buffer_size = 0;
+		return GF_IO_ERR;
+	}
+	entry->write_buffer_size = 0;
+	if (fflush(entry->writeFilePtr)) {
+		GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[CACHE] Error while flushing data bytes to cache file : %s.", entry->cache_filename));
+		return GF_IO_ERR;
+	}
+	entry->written_in_cache += written;
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[CACHE] Flushed %d bytes to cache\n", written));
+	return GF_OK;
+}
+
+u32 gf_cache_get_pending_write_size(const DownloadedCacheEntry entry)
+{
+	return entry ? entry->write_buffer_size : 0;
+}
+
+GF_Err gf_cache_set_write_buffer(const DownloadedCacheEntry entry, u32 size)
+{
+	CHECK_ENTRY;
+	if (entry->memory_stored) return GF_OK;
+	/*cannot change while writing*/
+	if (entry->write_buffer_size) return GF_BAD_PARAM;
+	if (entry->write_buffer_alloc != size) {
+		if (entry->write_buffer) gf_free(entry->write_buffer);
+		entry->write_buffer = NULL;
+		entry->write_buffer_alloc = size;
+	}
+	return GF_OK;
+}
+
 GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_DownloadSession * sess, Bool success )
 {
 	GF_Err e = GF_OK;
@@ -576,6 +621,7 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 		GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK,
 		       ("[CACHE] Closing file %s, %d bytes written.\n", entry->cache_filename, entry->written_in_cache));
 
+		e = gf_cache_flush_write_buffer(entry);
 		if (fflush( entry->writeFilePtr ) || gf_fclose( entry->writeFilePtr )) {
 			GF_LOG(GF_LOG_ERROR, GF_LOG_NETWORK, ("[CACHE] Failed to flush/close file on disk\n"));
 			e = GF_IO_ERR;
@@ -605,8 +651,9 @@ GF_Err gf_cache_close_write_cache( const DownloadedCacheEntry entry, const GF_Do
 		}
 
 #if defined(_BSD_SOURCE) || _XOPEN_SOURCE >= 500
-		/* On  UNIX, be sure to flush all the data */
-		sync();
+		/* On  UNIX, be sure to flush all the data - not done in write-behind mode, the file is consistent for readers once closed*/
+		if (!entry->write_buffer_alloc)
+			sync();
 #endif
 		entry->writeFilePtr = NULL;
 		if (GF_OK != e) {
@@ -635,6 +682,7 @@ GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_Dow
 
 		entry->written_in_cache = 0;
 	}
+	entry->write_buffer_size = 0;
 	entry->flags &= ~CORRUPTED;
 
 	if (entry->memory_stored) {
@@ -695,6 +743,38 @@ GF_Err gf_cache_write_to_cache( const DownloadedCacheEntry entry, const GF_Downl
 		return GF_OK;
 	}
 
+	if (entry->write_buffer_alloc) {
+		GF_Err e = GF_OK;
+		if (!entry->write_buffer) {
+			entry->write_buffer = (char*)gf_malloc(sizeof(char) * entry->write_buffer_alloc);
+			if (!entry->write_buffer) {
+				entry->write_buffer_alloc = 0;
+				goto write_direct;
+			}
+		}
+		if (entry->write_buffer_size + size > entry->write_buffer_alloc) {
+			e = gf_cache_flush_write_buffer(entry);
+		}
+		/*chunk larger than our buffer, write it directly*/
+		if (!e && (size > entry->write_buffer_alloc)) {
+			read = (u32) gf_fwrite(data, sizeof(char), size, entry->writeFilePtr);
+			if (read != size) e = GF_IO_ERR;
+			else if (fflush(entry->writeFilePtr)) e = GF_IO_ERR;
+			else entry->written_in_cache += size;
+		} else if (!e) {
+			memcpy(entry->write_buffer + entry->write_buffer_size, data, size);
+			entry->write_buffer_size += size;
+		}
+		if (e) {
+			gf_cache_close_write_cache(entry, sess, GF_FALSE);
+			gf_delete_file(entry->cache_filename);
+			return e;
+		}
+		GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[CACHE] Writing %d bytes to cache buffer\n", size));
+		return GF_OK;
+	}
+
+write_direct:
 	read = (u32) gf_fwrite(data, sizeof(char), size, entry->writeFilePtr);
 	if (read > 0)
 		entry->written_in_cache+= read;
@@ -826,6 +906,10 @@ GF_Err gf_cache_delete_entry ( const DownloadedCacheEntry entry )
 	if (entry->mem_storage) {
 		gf_free(entry->mem_storage);
 	}
+	if (entry->write_buffer) {
+		gf_free(entry->write_buffer);
+		entry->write_buffer = NULL;
+	}
 
 	if ( entry->cache_filename ) {
 		gf_free ( entry->cache_filename );
@@ -940,8 +1024,10 @@ s32 gf_cache_add_session_to_cache_entry(DownloadedCacheEntry entry, GF_DownloadS
 
 FILE *gf_cache_get_file_pointer(const DownloadedCacheEntry entry)
 {
-	if (entry) return entry->writeFilePtr;
-	return NULL;
+	if (!entry) return NULL;
+	/*make sure the file is up to date before handing it*/
+	gf_cache_flush_write_buffer(entry);
+	return entry->writeFilePtr;
 }
 
 void gf_cache_set_end_range(DownloadedCacheEntry entry, u64 range_end)
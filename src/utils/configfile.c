@@ -28,39 +28,124 @@
 
 #define MAX_INI_LINE			2046
 
-typedef struct
+/*number of hash buckets for sections in a config file, and for keys in a section*/
+#define CFG_HASH_SIZE	32
+
+typedef struct __tag_config_key
 {
 	char *name;
+	/*NULL if the key has been removed or only resolved as a handle - the key is then not listed in its section*/
 	char *value;
+	u32 hash;
+	struct __tag_config_key *next;
 } IniKey;
 
-typedef struct
+typedef struct __ini_section
 {
 	char *section_name;
+	/*listed keys, in file order*/
 	GF_List *keys;
+	u32 hash;
+	/*all keys of the section, including removed ones, so that key handles stay valid until the config is destroyed*/
+	IniKey *key_hash[CFG_HASH_SIZE];
+	/*section is not listed (removed, or only created by a key handle)*/
+	Bool hidden;
+	struct __ini_section *next;
 } IniSection;
 
 struct __tag_config
 {
 	char *fileName;
+	/*listed sections, in file order*/
 	GF_List *sections;
 	Bool hasChanged, skip_changes;
+	IniSection *sec_hash[CFG_HASH_SIZE];
 };
 
+static u32 cfg_hash(const char *name)
+{
+	u32 hash = 5381;
+	while (*name) {
+		hash = ((hash << 5) + hash) + (u8) *name;
+		name++;
+	}
+	return hash;
+}
+
+static IniSection *cfg_find_section(GF_Config *iniFile, const char *secName, u32 hash)
+{
+	IniSection *sec = iniFile->sec_hash[hash % CFG_HASH_SIZE];
+	while (sec) {
+		if ((sec->hash == hash) && !strcmp(secName, sec->section_name)) return sec;
+		sec = sec->next;
+	}
+	return NULL;
+}
+
+static IniSection *cfg_new_section(GF_Config *iniFile, const char *secName, u32 hash, Bool hidden)
+{
+	IniSection *sec;
+	GF_SAFEALLOC(sec, IniSection);
+	if (!sec) return NULL;
+	sec->section_name = gf_strdup(secName);
+	sec->keys = gf_list_new();
+	sec->hash = hash;
+	sec->hidden = hidden;
+	sec->next = iniFile->sec_hash[hash % CFG_HASH_SIZE];
+	iniFile->sec_hash[hash % CFG_HASH_SIZE] = sec;
+	if (!hidden) gf_list_add(iniFile->sections, sec);
+	return sec;
+}
+
+static IniKey *cfg_find_key(IniSection *sec, const char *keyName, u32 hash)
+{
+	IniKey *key = sec->key_hash[hash % CFG_HASH_SIZE];
+	while (key) {
+		if ((key->hash == hash) && !strcmp(keyName, key->name)) return key;
+		key = key->next;
+	}
+	return NULL;
+}
+
+/*creates an unlisted key with no value*/
+static IniKey *cfg_new_key(IniSection *sec, const char *keyName, u32 hash)
+{
+	IniKey *key;
+	GF_SAFEALLOC(key, IniKey);
+	if (!key) return NULL;
+	key->name = gf_strdup(keyName);
+	key->hash = hash;
+	key->next = sec->key_hash[hash % CFG_HASH_SIZE];
+	sec->key_hash[hash % CFG_HASH_SIZE] = key;
+	return key;
+}
+
+/*unlists all keys of the section, keys are kept for handles*/
+static void cfg_reset_section(IniSection *sec)
+{
+	IniKey *k;
+	while (gf_list_count(sec->keys)) {
+		k = (IniKey *) gf_list_get(sec->keys, 0);
+		if (k->value) gf_free(k->value);
+		k->value = NULL;
+		gf_list_rem(sec->keys, 0);
+	}
+}
 
 static void DelSection(IniSection *ptr)
 {
+	u32 i;
 	IniKey *k;
 	if (!ptr) return;
-	if (ptr->keys) {
-		while (gf_list_count(ptr->keys)) {
-			k = (IniKey *) gf_list_get(ptr->keys, 0);
+	if (ptr->keys) gf_list_del(ptr->keys);
+	for (i=0; i<CFG_HASH_SIZE; i++) {
+		while (ptr->key_hash[i]) {
+			k = ptr->key_hash[i];
+			ptr->key_hash[i] = k->next;
 			if (k->value) gf_free(k->value);
 			if (k->name) gf_free(k->name);
 			gf_free(k);
-			gf_list_rem(ptr->keys, 0);
 		}
-		gf_list_del(ptr->keys);
 	}
 	if (ptr->section_name) gf_free(ptr->section_name);
 	gf_free(ptr);
@@ -71,16 +156,18 @@ static void DelSection(IniSection *ptr)
  * \param iniFile The structure to clear
  */
 static void gf_cfg_clear(GF_Config * iniFile) {
+	u32 i;
 	IniSection *p;
 	if (!iniFile) return;
-	if (iniFile->sections) {
-		while (gf_list_count(iniFile->sections)) {
-			p = (IniSection *) gf_list_get(iniFile->sections, 0);
+	for (i=0; i<CFG_HASH_SIZE; i++) {
+		while (iniFile->sec_hash[i]) {
+			p = iniFile->sec_hash[i];
+			iniFile->sec_hash[i] = p->next;
 			DelSection(p);
-			gf_list_rem(iniFile->sections, 0);
 		}
-		gf_list_del(iniFile->sections);
 	}
+	if (iniFile->sections)
+		gf_list_del(iniFile->sections);
 	if (iniFile->fileName)
 		gf_free(iniFile->fileName);
 	memset((void *)iniFile, 0, sizeof(GF_Config));
@@ -147,14 +234,15 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 
 		/* new section */
 		if (line[0] == '[') {
-			p = (IniSection *) gf_malloc(sizeof(IniSection));
-			p->keys = gf_list_new();
-			p->section_name = gf_strdup(line + 1);
-			p->section_name[strlen(line) - 2] = 0;
-			while (p->section_name[strlen(p->section_name) - 1] == ']' || p->section_name[strlen(p->section_name) - 1] == ' ') p->section_name[strlen(p->section_name) - 1] = 0;
-			gf_list_add(tmp->sections, p);
+			char *name = line + 1;
+			name[strlen(line) - 2] = 0;
+			while (name[strlen(name) - 1] == ']' || name[strlen(name) - 1] == ' ') name[strlen(name) - 1] = 0;
+			/*sections declared several times are merged*/
+			p = cfg_find_section(tmp, name, cfg_hash(name));
+			if (!p) p = cfg_new_section(tmp, name, cfg_hash(name), GF_FALSE);
 		}
 		else if (strlen(line) && (strchr(line, '=') != NULL) ) {
+			u32 hash;
 			if (!p) {
 				gf_list_del(tmp->sections);
 				gf_free(tmp->fileName);
@@ -164,23 +252,18 @@ GF_Err gf_cfg_parse_config_file(GF_Config * tmp, const char * filePath, const ch
 				return GF_IO_ERR;
 			}
 
-			k = (IniKey *) gf_malloc(sizeof(IniKey));
-			memset((void *)k, 0, sizeof(IniKey));
 			ret = strchr(line, '=');
-			if (ret) {
-				ret[0] = 0;
-				k->name = gf_strdup(line);
-				while (k->name[strlen(k->name) - 1] == ' ') k->name[strlen(k->name) - 1] = 0;
-				ret[0] = '=';
-				ret += 1;
-				while (ret[0] == ' ') ret++;
-				if ( ret[0] != 0) {
-					k->value = gf_strdup(ret);
-					while (k->value[strlen(k->value) - 1] == ' ') k->value[strlen(k->value) - 1] = 0;
-				} else {
-					k->value = gf_strdup("");
-				}
-			}
+			ret[0] = 0;
+			while (strlen(line) && (line[strlen(line) - 1] == ' ')) line[strlen(line) - 1] = 0;
+			ret += 1;
+			while (ret[0] == ' ') ret++;
+			while (strlen(ret) && (ret[strlen(ret) - 1] == ' ')) ret[strlen(ret) - 1] = 0;
+
+			/*only the first declaration of a key is kept*/
+			hash = cfg_hash(line);
+			if (cfg_find_key(p, line, hash)) continue;
+			k = cfg_new_key(p, line, hash);
+			k->value = gf_strdup(ret);
 			gf_list_add(p->keys, k);
 		}
 	}
@@ -285,22 +368,38 @@ void gf_cfg_remove(GF_Config *iniFile)
 GF_EXPORT
 const char *gf_cfg_get_key(GF_Config *iniFile, const char *secName, const char *keyName)
 {
-	u32 i;
 	IniSection *sec;
 	IniKey *key;
 
-	i=0;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) goto get_key;
-	}
-	return NULL;
+	sec = cfg_find_section(iniFile, secName, cfg_hash(secName));
+	if (!sec) return NULL;
+	key = cfg_find_key(sec, keyName, cfg_hash(keyName));
+	return key ? key->value : NULL;
+}
 
-get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i)) ) {
-		if (!strcmp(key->name, keyName)) return key->value;
-	}
-	return NULL;
+GF_EXPORT
+GF_ConfigKey *gf_cfg_get_key_handle(GF_Config *iniFile, const char *secName, const char *keyName)
+{
+	u32 hash;
+	IniSection *sec;
+	IniKey *key;
+
+	if (!iniFile || !secName || !keyName) return NULL;
+	hash = cfg_hash(secName);
+	sec = cfg_find_section(iniFile, secName, hash);
+	if (!sec) sec = cfg_new_section(iniFile, secName, hash, GF_TRUE);
+	if (!sec) return NULL;
+
+	hash = cfg_hash(keyName);
+	key = cfg_find_key(sec, keyName, hash);
+	if (!key) key = cfg_new_key(sec, keyName, hash);
+	return key;
+}
+
+GF_EXPORT
+const char *gf_cfg_get_key_by_handle(GF_ConfigKey *key)
+{
+	return key ? key->value : NULL;
 }
 
 GF_EXPORT
@@ -328,7 +427,7 @@ get_key:
 GF_EXPORT
 GF_Err gf_cfg_set_key(GF_Config *iniFile, const char *secName, const char *keyName, const char *keyValue)
 {
-	u32 i;
+	u32 hash;
 	Bool has_changed = GF_TRUE;
 	IniSection *sec;
 	IniKey *key;
@@ -337,43 +436,43 @@ GF_Err gf_cfg_set_key(GF_Config *iniFile, const char *secName, const char *keyNa
 
 	if (!strnicmp(secName, "temp", 4)) has_changed = GF_FALSE;
 
-	i=0;
-	while ((sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) goto get_key;
+	hash = cfg_hash(secName);
+	sec = cfg_find_section(iniFile, secName, hash);
+	if (!sec) {
+		/* need a new section */
+		sec = cfg_new_section(iniFile, secName, hash, GF_FALSE);
+		if (!sec) return GF_OUT_OF_MEM;
+		if (has_changed) iniFile->hasChanged = GF_TRUE;
+	} else if (sec->hidden) {
+		sec->hidden = GF_FALSE;
+		gf_list_add(iniFile->sections, sec);
+		if (has_changed) iniFile->hasChanged = GF_TRUE;
 	}
-	/* need a new key */
-	sec = (IniSection *) gf_malloc(sizeof(IniSection));
-	sec->section_name = gf_strdup(secName);
-	sec->keys = gf_list_new();
-	if (has_changed) iniFile->hasChanged = GF_TRUE;
-	gf_list_add(iniFile->sections, sec);
 
-get_key:
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) goto set_value;
+	hash = cfg_hash(keyName);
+	key = cfg_find_key(sec, keyName, hash);
+	if (!key || !key->value) {
+		if (!keyValue) return GF_OK;
+		/* need a new key */
+		if (!key) key = cfg_new_key(sec, keyName, hash);
+		if (!key) return GF_OUT_OF_MEM;
+		key->value = gf_strdup("");
+		if (has_changed) iniFile->hasChanged = GF_TRUE;
+		gf_list_add(sec->keys, key);
 	}
-	if (!keyValue) return GF_OK;
-	/* need a new key */
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
-	key->name = gf_strdup(keyName);
-	key->value = gf_strdup("");
-	if (has_changed) iniFile->hasChanged = GF_TRUE;
-	gf_list_add(sec->keys, key);
 
-set_value:
 	if (!keyValue) {
+		/*the key is only unlisted, handles to it remain valid*/
 		gf_list_del_item(sec->keys, key);
-		if (key->name) gf_free(key->name);
-		if (key->value) gf_free(key->value);
-		gf_free(key);
+		gf_free(key->value);
+		key->value = NULL;
 		if (has_changed) iniFile->hasChanged = GF_TRUE;
 		return GF_OK;
 	}
 	/* same value, don't update */
 	if (!strcmp(key->value, keyValue)) return GF_OK;
 
-	if (key->value) gf_free(key->value);
+	gf_free(key->value);
 	key->value = gf_strdup(keyValue);
 	if (has_changed) iniFile->hasChanged = GF_TRUE;
 	return GF_OK;
@@ -396,68 +495,53 @@ const char *gf_cfg_get_section_name(GF_Config *iniFile, u32 secIndex)
 GF_EXPORT
 u32 gf_cfg_get_key_count(GF_Config *iniFile, const char *secName)
 {
-	u32 i = 0;
-	IniSection *sec;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i)) ) {
-		if (!strcmp(secName, sec->section_name)) return gf_list_count(sec->keys);
-	}
-	return 0;
+	IniSection *sec = cfg_find_section(iniFile, secName, cfg_hash(secName));
+	return sec ? gf_list_count(sec->keys) : 0;
 }
 
 GF_EXPORT
 const char *gf_cfg_get_key_name(GF_Config *iniFile, const char *secName, u32 keyIndex)
 {
-	u32 i = 0;
-	IniSection *sec;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i) ) ) {
-		if (!strcmp(secName, sec->section_name)) {
-			IniKey *key = (IniKey *) gf_list_get(sec->keys, keyIndex);
-			return key ? key->name : NULL;
-		}
-	}
-	return NULL;
+	IniKey *key;
+	IniSection *sec = cfg_find_section(iniFile, secName, cfg_hash(secName));
+	if (!sec) return NULL;
+	key = (IniKey *) gf_list_get(sec->keys, keyIndex);
+	return key ? key->name : NULL;
 }
 
 GF_EXPORT
 void gf_cfg_del_section(GF_Config *iniFile, const char *secName)
 {
-	u32 i;
 	IniSection *p;
 	if (!iniFile) return;
 
-	i = 0;
-	while ((p = (IniSection*)gf_list_enum(iniFile->sections, &i))) {
-		if (!strcmp(secName, p->section_name)) {
-			DelSection(p);
-			gf_list_rem(iniFile->sections, i-1);
-			iniFile->hasChanged = GF_TRUE;
-			return;
-		}
-	}
+	p = cfg_find_section(iniFile, secName, cfg_hash(secName));
+	if (!p || p->hidden) return;
+	/*the section and its keys are only unlisted, handles to them remain valid*/
+	cfg_reset_section(p);
+	p->hidden = GF_TRUE;
+	gf_list_del_item(iniFile->sections, p);
+	iniFile->hasChanged = GF_TRUE;
 }
 
 GF_EXPORT
 GF_Err gf_cfg_insert_key(GF_Config *iniFile, const char *secName, const char *keyName, const char *keyValue, u32 index)
 {
-	u32 i;
+	u32 hash;
 	IniSection *sec;
 	IniKey *key;
 
 	if (!iniFile || !secName || !keyName|| !keyValue) return GF_BAD_PARAM;
 
-	i=0;
-	while ( (sec = (IniSection *) gf_list_enum(iniFile->sections, &i) ) ) {
-		if (!strcmp(secName, sec->section_name)) break;
-	}
-	if (!sec) return GF_BAD_PARAM;
+	sec = cfg_find_section(iniFile, secName, cfg_hash(secName));
+	if (!sec || sec->hidden) return GF_BAD_PARAM;
 
-	i=0;
-	while ( (key = (IniKey *) gf_list_enum(sec->keys, &i) ) ) {
-		if (!strcmp(key->name, keyName)) return GF_BAD_PARAM;
-	}
+	hash = cfg_hash(keyName);
+	key = cfg_find_key(sec, keyName, hash);
+	if (key && key->value) return GF_BAD_PARAM;
 
-	key = (IniKey *) gf_malloc(sizeof(IniKey));
-	key->name = gf_strdup(keyName);
+	if (!key) key = cfg_new_key(sec, keyName, hash);
+	if (!key) return GF_OUT_OF_MEM;
 	key->value = gf_strdup(keyValue);
 	gf_list_insert(sec->keys, key, index);
 	iniFile->hasChanged = GF_TRUE;
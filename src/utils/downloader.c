@@ -94,6 +94,16 @@ typedef struct
 } GF_HTTPHeader;
 
 
+/*!idle connection kept by the download manager for reuse by later sessions on the same host*/
+typedef struct
+{
+	char *server_name;
+	u16 port;
+	GF_Socket *sock;
+	/*time at which the connection was released, in ms*/
+	u32 idle_since;
+} GF_DMIdleConnection;
+
 /**
  * This structure handles partial downloads
  */
@@ -180,6 +190,12 @@ struct __gf_download_session
 	u32 nb_left_in_chunk;
 
 	u64 request_start_time;
+	/*set when the last reply has been completely read and the connection can be reused*/
+	Bool sock_reusable;
+	/*set when the socket comes from the idle connection pool of the download manager*/
+	Bool sock_from_pool;
+	/*set when a reused connection failed, the next connection shall not come from the pool*/
+	Bool skip_pool;
 	/*private extension*/
 	void *ext;
 
@@ -201,6 +217,13 @@ struct __gf_download_manager
 	Bool disable_cache, simulate_no_connection, allow_offline_cache, clean_cache;
 	u32 limit_data_rate, read_buf_size;
 	u64 max_cache_size;
+	/*size of the write-behind buffer of disk cache entries, 0 to write each received chunk*/
+	u32 cache_write_buffer;
+	/*idle HTTP connections, protected by conn_mx*/
+	GF_List *idle_connections;
+	GF_Mutex *conn_mx;
+	/*max idle connections kept per host (0 disables the pool), idle timeout in ms, max active connections per host (0 for no limit)*/
+	u32 max_idle_per_host, idle_timeout, max_host_connections;
 	Bool allow_broken_certificate;
 	
 	GF_List *skip_proxy_servers;
@@ -281,6 +304,23 @@ GF_Err gf_cache_open_write_cache( const DownloadedCacheEntry entry, const GF_Dow
  */
 FILE *gf_cache_get_file_pointer(const DownloadedCacheEntry entry);
 
+/**
+ * \brief Sets the write-behind buffer size of a disk cache entry
+ * Received data is written to the cache file by blocks of the given size rather than chunk by chunk.
+ * Readers of the cache file only see the data once flushed, at the latest when the cache is closed.
+ * \param entry The entry to use
+ * \param size buffer size in bytes, 0 to disable
+ * \return GF_OK is everything went fine, GF_BAD_PARAM if data is pending in the current buffer
+ */
+GF_Err gf_cache_set_write_buffer(const DownloadedCacheEntry entry, u32 size);
+
+/**
+ * \brief Gets the amount of received data not yet written to the cache file
+ * \param entry The entry to use
+ * \return number of bytes pending in the write-behind buffer
+ */
+u32 gf_cache_get_pending_write_size(const DownloadedCacheEntry entry);
+
 /*modify end range when chaining byte-range requests*/
 void gf_cache_set_end_range(DownloadedCacheEntry entry, u64 range_end);
 
@@ -586,6 +626,8 @@ static void gf_dm_configure_cache(GF_DownloadSession *sess)
 		entry = gf_dm_find_cached_entry_by_url(sess);
 		if (!entry) {
 			entry = gf_cache_create_entry(sess->dm, sess->dm->cache_directory, sess->orig_url, sess->range_start, sess->range_end, (sess->flags&GF_NETIO_SESSION_MEMORY_CACHE) ? GF_TRUE : GF_FALSE);
+			if (sess->dm->cache_write_buffer)
+				gf_cache_set_write_buffer(entry, sess->dm->cache_write_buffer);
 			gf_mx_p( sess->dm->cache_mx );
 			gf_list_add(sess->dm->cache_entries, entry);
 			gf_mx_v( sess->dm->cache_mx );
@@ -684,6 +726,111 @@ static void gf_dm_clear_headers(GF_DownloadSession *sess)
 }
 
 
+static void gf_dm_idle_connection_del(GF_DMIdleConnection *conn)
+{
+	gf_sk_del(conn->sock);
+	gf_free(conn->server_name);
+	gf_free(conn);
+}
+
+/*moves the socket of the session to the idle connection pool. Only plain HTTP connections without proxy are pooled*/
+static Bool gf_dm_release_connection(GF_DownloadSession *sess)
+{
+	u32 i, count, nb_host;
+	GF_DMIdleConnection *conn;
+	GF_DownloadManager *dm = sess->dm;
+
+	if (!dm || !dm->max_idle_per_host || !sess->sock || !sess->sock_reusable || !sess->server_name) return GF_FALSE;
+	if (sess->proxy_enabled==1) return GF_FALSE;
+#ifdef GPAC_HAS_SSL
+	if (sess->ssl) return GF_FALSE;
+#endif
+
+	gf_mx_p(dm->conn_mx);
+	nb_host = 0;
+	count = gf_list_count(dm->idle_connections);
+	for (i=0; i<count; i++) {
+		conn = (GF_DMIdleConnection*)gf_list_get(dm->idle_connections, i);
+		if ((conn->port == sess->port) && !strcmp(conn->server_name, sess->server_name)) nb_host++;
+	}
+	if (nb_host >= dm->max_idle_per_host) {
+		gf_mx_v(dm->conn_mx);
+		return GF_FALSE;
+	}
+	GF_SAFEALLOC(conn, GF_DMIdleConnection);
+	if (!conn) {
+		gf_mx_v(dm->conn_mx);
+		return GF_FALSE;
+	}
+	conn->server_name = gf_strdup(sess->server_name);
+	conn->port = sess->port;
+	conn->sock = sess->sock;
+	conn->idle_since = gf_sys_clock();
+	gf_list_add(dm->idle_connections, conn);
+	gf_mx_v(dm->conn_mx);
+
+	GF_LOG(GF_LOG_DEBUG, GF_LOG_NETWORK, ("[HTTP] Keeping idle connection to %s:%d for reuse\n", sess->server_name, sess->port));
+	sess->sock = NULL;
+	sess->sock_reusable = GF_FALSE;
+	return GF_TRUE;
+}
+
+/*gets an idle connection to the session host if any, discarding expired or closed ones*/
+static GF_Socket *gf_dm_get_idle_connection(GF_DownloadSession *sess)
+{
+	u32 i, now;
+	GF_Socket *sock = NULL;
+	GF_DownloadManager *dm = sess->dm;
+
+	if (!dm || !dm->max_idle_per_host || !sess->server_name) return NULL;
+	if (sess->flags & GF_DOWNLOAD_SESSION_USE_SSL) return NULL;
+
+	now = gf_sys_clock();
+	gf_mx_p(dm->conn_mx);
+	for (i=0; i<gf_list_count(dm->idle_connections); i++) {
+		GF_DMIdleConnection *conn = (GF_DMIdleConnection*)gf_list_get(dm->idle_connections, i);
+		if (dm->idle_timeout && (now - conn->idle_since > dm->idle_timeout)) {
+			gf_list_rem(dm->idle_connections, i);
+			i--;
+			gf_dm_idle_connection_del(conn);
+			continue;
+		}
+		if (!sock && (conn->port == sess->port) && !strcmp(conn->server_name, sess->server_name)) {
+			/*an idle connection shall have nothing to read, otherwise it was closed by the server*/
+			GF_Err e = gf_sk_probe(conn->sock);
+			gf_list_rem(dm->idle_connections, i);
+			i--;
+			if (e == GF_IP_NETWORK_EMPTY) {
+				sock = conn->sock;
+				conn->sock = NULL;
+				gf_free(conn->server_name);
+				gf_free(conn);
+			} else {
+				gf_dm_idle_connection_del(conn);
+			}
+		}
+	}
+	gf_mx_v(dm->conn_mx);
+	return sock;
+}
+
+/*returns the number of sessions currently using a connection to the session host*/
+static u32 gf_dm_get_host_connections(GF_DownloadSession *sess)
+{
+	u32 i, count, nb_active = 0;
+	gf_mx_p(sess->dm->cache_mx);
+	count = gf_list_count(sess->dm->sessions);
+	for (i=0; i<count; i++) {
+		GF_DownloadSession *a_sess = (GF_DownloadSession*)gf_list_get(sess->dm->sessions, i);
+		if (a_sess==sess) continue;
+		if (!a_sess->sock || !a_sess->server_name) continue;
+		if ((a_sess->status < GF_NETIO_CONNECTED) || (a_sess->status >= GF_NETIO_DISCONNECTED)) continue;
+		if ((a_sess->port == sess->port) && !strcmp(a_sess->server_name, sess->server_name)) nb_active++;
+	}
+	gf_mx_v(sess->dm->cache_mx);
+	return nb_active;
+}
+
 static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 {
 	assert( sess );
@@ -705,6 +852,9 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 
 	gf_mx_p(sess->mx);
 
+	if (!force_close && !(sess->flags & GF_NETIO_SESSION_PERSISTENT)) {
+		gf_dm_release_connection(sess);
+	}
 	if (force_close || !(sess->flags & GF_NETIO_SESSION_PERSISTENT)) {
 #ifdef GPAC_HAS_SSL
 		if (sess->ssl) {
@@ -728,6 +878,19 @@ static void gf_dm_disconnect(GF_DownloadSession *sess, Bool force_close)
 	gf_mx_v(sess->mx);
 }
 
+/*the server may close a pooled connection while it is idle, which is only detected once the request is sent.
+Closes the connection and restarts the session on a new connection, only once since the new one is not taken from the pool*/
+static Bool gf_dm_retry_on_new_connection(GF_DownloadSession *sess, GF_Err e)
+{
+	if (!sess->sock_from_pool) return GF_FALSE;
+	GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Reused connection to %s failed (%s), retrying on a new connection\n", sess->server_name, gf_error_to_string(e)));
+	gf_dm_disconnect(sess, GF_TRUE);
+	sess->sock_from_pool = GF_FALSE;
+	sess->skip_pool = GF_TRUE;
+	sess->status = GF_NETIO_SETUP;
+	return GF_TRUE;
+}
+
 GF_EXPORT
 void gf_dm_sess_del(GF_DownloadSession *sess)
 {
@@ -739,6 +902,12 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		sess->destroy = GF_TRUE;
 		return;
 	}
+	/*persistent sessions keep their socket once done, give it back to the pool*/
+	if (sess->status >= GF_NETIO_DISCONNECTED) {
+		gf_mx_p(sess->mx);
+		gf_dm_release_connection(sess);
+		gf_mx_v(sess->mx);
+	}
 	gf_dm_disconnect(sess, GF_TRUE);
 	gf_dm_clear_headers(sess);
 
@@ -751,7 +920,11 @@ void gf_dm_sess_del(GF_DownloadSession *sess)
 		sess->th = NULL;
 	}
 
-	if (sess->dm) gf_list_del_item(sess->dm->sessions, sess);
+	if (sess->dm) {
+		gf_mx_p(sess->dm->cache_mx);
+		gf_list_del_item(sess->dm->sessions, sess);
+		gf_mx_v(sess->dm->cache_mx);
+	}
 
 	gf_dm_remove_cache_entry_from_session(sess);
 	sess->cache_entry = NULL;
@@ -1194,7 +1367,9 @@ GF_DownloadSession *gf_dm_sess_new(GF_DownloadManager *dm, const char *url, u32
 	sess = gf_dm_sess_new_simple(dm, url, dl_flags, user_io, usr_cbk, e);
 	if (sess) {
 		sess->dm = dm;
+		gf_mx_p(dm->cache_mx);
 		gf_list_add(dm->sessions, sess);
+		gf_mx_v(dm->cache_mx);
 	}
 	return sess;
 }
@@ -1295,6 +1470,27 @@ static void gf_dm_connect(GF_DownloadSession *sess)
 
 	if (!sess->sock) {
 		sess->num_retry = 40;
+		sess->sock_reusable = GF_FALSE;
+		sess->sock_from_pool = GF_FALSE;
+		/*limit the number of concurrent connections to the host, retry later*/
+		if (sess->dm && sess->dm->max_host_connections && sess->server_name && (gf_dm_get_host_connections(sess) >= sess->dm->max_host_connections)) {
+			sess->status = GF_NETIO_SETUP;
+			gf_sleep(1);
+			return;
+		}
+		if (!sess->skip_pool)
+			sess->sock = gf_dm_get_idle_connection(sess);
+		sess->skip_pool = GF_FALSE;
+		if (sess->sock) {
+			GF_LOG(GF_LOG_INFO, GF_LOG_NETWORK, ("[HTTP] Reusing idle connection to %s:%d\n", sess->server_name, sess->port));
+			sess->sock_from_pool = GF_TRUE;
+			sess->connect_time = 0;
+			sess->status = GF_NETIO_SETUP;
+			gf_dm_sess_notify_state(sess, sess->status, GF_OK);
+			sess->status = GF_NETIO_CONNECTED;
+			gf_dm_sess_notify_state(sess, GF_NETIO_CONNECTED, GF_OK);
+			return;
+		}
 		sess->sock = gf_sk_new(GF_SOCK_TYPE_TCP);
 	}
 
@@ -1751,6 +1947,8 @@ GF_DownloadManager *gf_dm_new(GF_Config *cfg)
 	dm->partial_downloads = gf_list_new();
 	dm->cfg = cfg;
 	dm->cache_mx = gf_mx_new("download_manager_cache_mx");
+	dm->idle_connections = gf_list_new();
+	dm->conn_mx = gf_mx_new("download_manager_connections_mx");
 	default_cache_dir = NULL;
 	gf_mx_p( dm->cache_mx );
 	if (cfg)
@@ -1847,6 +2045,22 @@ retry_cache:
 	}
 
 
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "CacheWriteBuffer");
+		if (opt) dm->cache_write_buffer = 1024 * atoi(opt);
+	}
+
+	dm->max_idle_per_host = 4;
+	dm->idle_timeout = 10000;
+	if (cfg) {
+		opt = gf_cfg_get_key(cfg, "Downloader", "MaxIdleConnectionsPerHost");
+		if (opt) dm->max_idle_per_host = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "IdleConnectionTimeout");
+		if (opt) dm->idle_timeout = atoi(opt);
+		opt = gf_cfg_get_key(cfg, "Downloader", "MaxConnectionsPerHost");
+		if (opt) dm->max_host_connections = atoi(opt);
+	}
+
 	dm->head_timeout = 5000;
 	if (cfg) {
 		opt = gf_cfg_get_key(cfg, "Downloader", "HTTPHeadTimeout");
@@ -1911,6 +2125,14 @@ void gf_dm_del(GF_DownloadManager *dm)
 	}
 	gf_list_del(dm->sessions);
 	dm->sessions = NULL;
+	while (gf_list_count(dm->idle_connections)) {
+		GF_DMIdleConnection *conn = (GF_DMIdleConnection*)gf_list_pop_back(dm->idle_connections);
+		gf_dm_idle_connection_del(conn);
+	}
+	gf_list_del(dm->idle_connections);
+	dm->idle_connections = NULL;
+	gf_mx_del(dm->conn_mx);
+	dm->conn_mx = NULL;
 	assert( dm->skip_proxy_servers );
 	while (gf_list_count(dm->skip_proxy_servers)) {
 		char *serv = (char*)gf_list_get(dm->skip_proxy_servers, 0);
@@ -2116,6 +2338,7 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 	u32 nbBytes, remaining, hdr_size;
 	u8 *data;
 	Bool flush_chunk = GF_FALSE;
+	Bool extra_data = GF_FALSE;
 	GF_NETIO_Parameter par;
 
 	nbBytes = payload_size;
@@ -2169,6 +2392,7 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 		if (sess->total_size && (sess->bytes_done > sess->total_size)) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_NETWORK, ("[HTTP] url %s received more bytes than planned!! Got %d bytes vs %d content length\n", gf_cache_get_url(sess->cache_entry), sess->bytes_done , sess->total_size ));
 			sess->bytes_done = sess->total_size;
+			extra_data = GF_TRUE;
 		}
 
 		if (sess->icy_metaint > 0)
@@ -2188,6 +2412,9 @@ static GFINLINE void gf_dm_data_received(GF_DownloadSession *sess, u8 *payload,
 	}
 
 	if (sess->total_size && (sess->bytes_done == sess->total_size)) {
+		/*the connection can be reused if the reply has been consumed exactly*/
+		if (!sess->connection_close && !extra_data && !sess->chunked && !sess->icy_metaint)
+			sess->sock_reusable = GF_TRUE;
 		gf_dm_disconnect(sess, GF_FALSE);
 		par.msg_type = GF_NETIO_DATA_TRANSFERED;
 		par.error = GF_OK;
@@ -2280,7 +2507,14 @@ GF_Err gf_dm_sess_get_stats(GF_DownloadSession * sess, const char **server, cons
 		if (sess->total_size==SIZE_IN_STREAM) *total_size  = 0;
 		else *total_size = sess->total_size;
 	}
-	if (bytes_done) *bytes_done = sess->bytes_done;
+	if (bytes_done) {
+		*bytes_done = sess->bytes_done;
+		/*only report what readers of the cache file can see*/
+		if (sess->use_cache_file && sess->cache_entry) {
+			u32 pending = gf_cache_get_pending_write_size(sess->cache_entry);
+			*bytes_done = (*bytes_done > pending) ? *bytes_done - pending : 0;
+		}
+	}
 	if (bytes_per_sec) *bytes_per_sec = sess->bytes_per_sec;
 	if (net_status) *net_status = sess->status;
 	if (sess->status == GF_NETIO_DISCONNECTED) return GF_EOS;
@@ -2362,6 +2596,7 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 		gf_dm_configure_cache(sess);
 		sess->needs_cache_reconfig = 0;
 	}
+	sess->sock_reusable = GF_FALSE;
 	if (sess->from_cache_only) {
 		sess->request_start_time = gf_sys_clock_high_res();
 		sess->req_hdr_size = 0;
@@ -2598,6 +2833,8 @@ static GF_Err http_send_headers(GF_DownloadSession *sess, char * sHTTP) {
 	}
 
 	if (e) {
+		if (gf_dm_retry_on_new_connection(sess, e))
+			return GF_OK;
 		sess->status = GF_NETIO_STATE_ERROR;
 		sess->last_error = e;
 		gf_dm_sess_notify_state(sess, GF_NETIO_STATE_ERROR, e);
@@ -2762,6 +2999,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 	s32 LinePos, Pos;
 	u32 rsp_code, ContentLength, first_byte, last_byte, total_size, range, no_range;
 	Bool connection_closed = GF_FALSE;
+	Bool connection_keep_alive = GF_FALSE;
 	char buf[1025];
 	char comp[400];
 	GF_Err e;
@@ -2810,6 +3048,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 			continue;
 		/*socket has been closed while configuring, retry (not sure if the server got the GET)*/
 		case GF_IP_CONNECTION_CLOSED:
+			if (!bytesRead && gf_dm_retry_on_new_connection(sess, e))
+				return GF_OK;
 			if (sess->http_read_type == HEAD) {
 				/* Some servers such as shoutcast directly close connection if HEAD or an unknown method is issued */
 				sess->server_only_understand_get = GF_TRUE;
@@ -2828,6 +3068,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 			if (!res) return GF_OK;
 			break;
 		default:
+			if (!bytesRead && gf_dm_retry_on_new_connection(sess, e))
+				return GF_OK;
 			goto exit;
 		}
 		bytesRead += res;
@@ -2869,6 +3111,10 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		e = GF_REMOTE_SERVICE_ERROR;
 		goto exit;
 	}
+	/*HTTP/1.0 connections are closed after the reply unless keep-alive is signaled*/
+	else if (!strncmp("HTTP/1.0", comp, 8)) {
+		connection_closed = GF_TRUE;
+	}
 	Pos = gf_token_get(buf, Pos, " ", comp, 400);
 	if (Pos <= 0) {
 		e = GF_REMOTE_SERVICE_ERROR;
@@ -2993,6 +3239,8 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		else if (!stricmp(hdrp->name, "Connection") ) {
 			if (strstr(hdrp->value, "close"))
 				connection_closed = GF_TRUE;
+			else if (strstr(hdrp->value, "eep-alive"))
+				connection_keep_alive = GF_TRUE;
 		}
 
 		if (sess->status==GF_NETIO_DISCONNECTED) return GF_OK;
@@ -3042,6 +3290,7 @@ static GF_Err wait_for_header_and_parse(GF_DownloadSession *sess, char * sHTTP)
 		}
 	}
 	//remember if we can keep the session alive after the transfer is done
+	if (connection_keep_alive && !strncmp(sHTTP, "HTTP/1.0", 8)) connection_closed = GF_FALSE;
 	sess->connection_close = connection_closed;
 
 	switch (rsp_code) {
@@ -24,6 +24,8 @@
  */
 
 #include <gpac/tools.h>
+#include <gpac/thread.h>
+#include <gpac/trace.h>
 
 #if defined(WIN32) && !defined(GPAC_CONFIG_WIN32)
 #include <windows.h>
@@ -485,6 +487,281 @@ gf_log_cbk gf_log_set_callback(void *usr_cbk, gf_log_cbk cbk)
 }
 #endif
 
+#ifndef GPAC_DISABLE_TRACE
+
+#define GF_TRACE_DEFAULT_SIZE	0x10000
+
+/*binary trace event, formatted only when dumped*/
+typedef struct
+{
+	u64 timestamp;
+	const char *name;
+	s64 value;
+	u32 type;
+	u32 tool;
+} GF_TraceEvent;
+
+/*ring buffer of events of one thread, only written by its thread*/
+typedef struct __trace_buffer
+{
+	u32 th_id;
+	char th_name[64];
+	GF_TraceEvent *events;
+	u32 size;
+	/*total number of events written, the ring only holds the last size ones*/
+	volatile u32 nb_written;
+	struct __trace_buffer *next;
+} GF_TraceBuffer;
+
+static Bool trace_on = GF_FALSE;
+static u32 trace_size = GF_TRACE_DEFAULT_SIZE;
+/*incremented each time buffers are destroyed, to invalidate the per-thread buffer pointers*/
+static u32 trace_generation = 1;
+static GF_TraceBuffer *trace_buffers = NULL;
+static GF_Mutex *trace_mx = NULL;
+
+#if defined(_MSC_VER)
+#define GF_TRACE_TLS	__declspec(thread)
+#elif defined(__GNUC__) && !defined(GPAC_IPHONE) && !defined(GPAC_ANDROID)
+#define GF_TRACE_TLS	__thread
+#endif
+
+#ifdef GF_TRACE_TLS
+static GF_TRACE_TLS GF_TraceBuffer *trace_th_buffer = NULL;
+static GF_TRACE_TLS u32 trace_th_generation = 0;
+#endif
+
+static GF_TraceBuffer *trace_get_buffer()
+{
+	const char *name;
+	GF_TraceBuffer *buf;
+	u32 th_id;
+
+#ifdef GF_TRACE_TLS
+	if (trace_th_buffer && (trace_th_generation == trace_generation)) return trace_th_buffer;
+#endif
+
+	th_id = gf_th_id();
+#ifndef GF_TRACE_TLS
+	/*buffers are only prepended once initialized, no need to lock for browsing*/
+	buf = trace_buffers;
+	while (buf) {
+		if (buf->th_id == th_id) return buf;
+		buf = buf->next;
+	}
+#endif
+
+	/*first event of this thread, register a new buffer*/
+	GF_SAFEALLOC(buf, GF_TraceBuffer);
+	if (!buf) return NULL;
+	buf->size = trace_size;
+	buf->events = (GF_TraceEvent *)gf_malloc(sizeof(GF_TraceEvent) * buf->size);
+	if (!buf->events) {
+		gf_free(buf);
+		return NULL;
+	}
+	buf->th_id = th_id;
+	name = gf_th_name(0);
+	if (name) strncpy(buf->th_name, name, 63);
+
+	gf_mx_p(trace_mx);
+	buf->next = trace_buffers;
+	trace_buffers = buf;
+	gf_mx_v(trace_mx);
+
+#ifdef GF_TRACE_TLS
+	trace_th_buffer = buf;
+	trace_th_generation = trace_generation;
+#endif
+	return buf;
+}
+
+static void trace_del_buffers()
+{
+	while (trace_buffers) {
+		GF_TraceBuffer *buf = trace_buffers;
+		trace_buffers = buf->next;
+		gf_free(buf->events);
+		gf_free(buf);
+	}
+	trace_generation++;
+}
+
+GF_EXPORT
+GF_Err gf_trace_start(u32 nb_events_per_thread)
+{
+	GF_TraceBuffer *buf;
+	if (!nb_events_per_thread) nb_events_per_thread = GF_TRACE_DEFAULT_SIZE;
+	if (!trace_mx) trace_mx = gf_mx_new("Trace");
+	if (!trace_mx) return GF_OUT_OF_MEM;
+
+	trace_on = GF_FALSE;
+	gf_mx_p(trace_mx);
+	/*other threads may still be writing in their buffer, existing buffers are kept and the new size only applies to buffers created from now on*/
+	trace_size = nb_events_per_thread;
+	for (buf = trace_buffers; buf; buf = buf->next) {
+		buf->nb_written = 0;
+	}
+	gf_mx_v(trace_mx);
+	trace_on = GF_TRUE;
+	return GF_OK;
+}
+
+GF_EXPORT
+void gf_trace_stop()
+{
+	trace_on = GF_FALSE;
+}
+
+GF_EXPORT
+Bool gf_trace_is_on()
+{
+	return trace_on;
+}
+
+GF_EXPORT
+void gf_trace_event(GF_TraceEventType type, GF_LOG_Tool tool, const char *name, s64 value)
+{
+	GF_TraceEvent *evt;
+	GF_TraceBuffer *buf;
+	if (!trace_on) return;
+
+	buf = trace_get_buffer();
+	if (!buf) return;
+	evt = &buf->events[buf->nb_written % buf->size];
+	evt->timestamp = gf_sys_clock_high_res();
+	evt->name = name;
+	evt->value = value;
+	evt->type = type;
+	evt->tool = tool;
+	buf->nb_written++;
+}
+
+static void trace_dump_string(FILE *f, const char *str)
+{
+	while (*str) {
+		if ((*str == '"') || (*str == '\\')) fputc('\\', f);
+		if ((u8) *str >= 0x20) fputc(*str, f);
+		str++;
+	}
+}
+
+GF_EXPORT
+GF_Err gf_trace_dump(const char *file_name)
+{
+	GF_TraceBuffer *buf;
+	Bool first = GF_TRUE;
+	FILE *f;
+	if (!trace_mx) return GF_BAD_PARAM;
+	f = gf_fopen(file_name, "wt");
+	if (!f) return GF_IO_ERR;
+
+	fprintf(f, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[");
+	gf_mx_p(trace_mx);
+	for (buf = trace_buffers; buf; buf = buf->next) {
+		u32 i, nb_written = buf->nb_written;
+
+		fprintf(f, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%u,\"args\":{\"name\":\"", first ? "" : ",", buf->th_id);
+		trace_dump_string(f, buf->th_name);
+		fprintf(f, "\"}}");
+		first = GF_FALSE;
+
+		for (i = (nb_written > buf->size) ? nb_written - buf->size : 0; i < nb_written; i++) {
+			char ph;
+			GF_TraceEvent *evt = &buf->events[i % buf->size];
+			switch (evt->type) {
+			case GF_TRACE_EVT_BEGIN:
+				ph = 'B';
+				break;
+			case GF_TRACE_EVT_END:
+				ph = 'E';
+				break;
+			case GF_TRACE_EVT_COUNTER:
+				ph = 'C';
+				break;
+			case GF_TRACE_EVT_FLOW_START:
+				ph = 's';
+				break;
+			case GF_TRACE_EVT_FLOW_END:
+				ph = 'f';
+				break;
+			default:
+				ph = 'i';
+				break;
+			}
+			fprintf(f, ",\n{\"name\":\"");
+			trace_dump_string(f, evt->name);
+			fprintf(f, "\",\"cat\":\"%s\",\"ph\":\"%c\",\"ts\":"LLU",\"pid\":1,\"tid\":%u",
+			        (evt->tool < GF_LOG_TOOL_MAX) ? global_log_tools[evt->tool].name : "gpac", ph, evt->timestamp, buf->th_id);
+
+			switch (evt->type) {
+			case GF_TRACE_EVT_COUNTER:
+				fprintf(f, ",\"args\":{\"value\":"LLD"}", evt->value);
+				break;
+			case GF_TRACE_EVT_FLOW_START:
+				fprintf(f, ",\"id\":"LLD, evt->value);
+				break;
+			case GF_TRACE_EVT_FLOW_END:
+				fprintf(f, ",\"id\":"LLD",\"bp\":\"e\"", evt->value);
+				break;
+			case GF_TRACE_EVT_INSTANT:
+				fprintf(f, ",\"s\":\"t\"");
+				break;
+			default:
+				break;
+			}
+			fprintf(f, "}");
+		}
+	}
+	gf_mx_v(trace_mx);
+	fprintf(f, "\n]}\n");
+	gf_fclose(f);
+	return GF_OK;
+}
+
+/*called upon gf_sys_close*/
+void gf_trace_close()
+{
+	trace_on = GF_FALSE;
+	if (!trace_mx) return;
+	gf_mx_p(trace_mx);
+	trace_del_buffers();
+	gf_mx_v(trace_mx);
+	gf_mx_del(trace_mx);
+	trace_mx = NULL;
+}
+
+#else
+
+GF_EXPORT
+GF_Err gf_trace_start(u32 nb_events_per_thread)
+{
+	return GF_NOT_SUPPORTED;
+}
+GF_EXPORT
+void gf_trace_stop()
+{
+}
+GF_EXPORT
+Bool gf_trace_is_on()
+{
+	return GF_FALSE;
+}
+GF_EXPORT
+void gf_trace_event(GF_TraceEventType type, GF_LOG_Tool tool, const char *name, s64 value)
+{
+}
+GF_EXPORT
+GF_Err gf_trace_dump(const char *file_name)
+{
+	return GF_NOT_SUPPORTED;
+}
+void gf_trace_close()
+{
+}
+
+#endif /*GPAC_DISABLE_TRACE*/
+
 static char szErrMsg[20];
 
 GF_EXPORT
@@ -321,11 +321,32 @@ const char **gf_modules_get_module_directories(GF_ModuleManager *pm, u32* num_di
 	return pm->dirs;
 }
 
+/*the cache entry of a module is followed by the size and date of the module file it was built from*/
+static void module_cache_signature(ModuleInstance *inst, char *szSig)
+{
+	if (inst->ifce_reg) szSig[0] = 0;
+	else sprintf(szSig, "["LLU":"LLU"]", inst->file_size, inst->file_mtime);
+}
+
+static void module_set_cache(ModuleInstance *inst, const char *value)
+{
+	char *key;
+	char szSig[64];
+	module_cache_signature(inst, szSig);
+	key = (char*)gf_malloc(sizeof(char) * (strlen(value) + strlen(szSig) + 2));
+	strcpy(key, value);
+	if (key[0] && (key[strlen(key)-1] != ' ')) strcat(key, " ");
+	strcat(key, szSig);
+	gf_cfg_set_key(inst->plugman->cfg, "PluginsCache", inst->name, key);
+	gf_free(key);
+}
+
 GF_EXPORT
 GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug, u32 InterfaceFamily)
 {
 	const char *opt;
 	char szKey[32];
+	char szSig[64];
 	ModuleInstance *inst;
 	GF_BaseInterface *ifce;
 
@@ -348,6 +369,12 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 		return NULL;
 	}
 	opt = gf_cfg_get_key(pm->cfg, "PluginsCache", inst->name);
+	/*module file has changed (or entry from an older version), rebuild its cache entry*/
+	module_cache_signature(inst, szSig);
+	if (opt && szSig[0] && !strstr(opt, szSig)) {
+		GF_LOG(GF_LOG_INFO, GF_LOG_CORE, ("[Core] Module %s has changed, refreshing its cache entry\n", inst->name));
+		opt = NULL;
+	}
 	if (opt) {
 		const char * ifce_str = gf_4cc_to_str(InterfaceFamily);
 		snprintf(szKey, 32, "%s:yes", ifce_str ? ifce_str : "(null)");
@@ -358,13 +385,13 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 	}
 	if (!gf_modules_load_library(inst)) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[Core] Cannot load library %s\n", inst->name));
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+		module_set_cache(inst, "Invalid Plugin");
 		gf_mx_v(pm->mutex);
 		return NULL;
 	}
 	if (!inst->query_func) {
 		GF_LOG(GF_LOG_ERROR, GF_LOG_CORE, ("[Core] Library %s missing GPAC export symbols\n", inst->name));
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+		module_set_cache(inst, "Invalid Plugin");
 		goto err_exit;
 	}
 
@@ -376,13 +403,13 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 		const u32 *si = inst->query_func();
 		if (!si) {
 			GF_LOG(GF_LOG_WARNING, GF_LOG_CORE, ("[Core] GPAC module %s has no supported interfaces - disabling\n", inst->name));
-			gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, "Invalid Plugin");
+			module_set_cache(inst, "Invalid Plugin");
 			goto err_exit;
 		}
 		i=0;
 		while (si[i]) i++;
 
-		key = (char*)gf_malloc(sizeof(char) * 10 * i);
+		key = (char*)gf_malloc(sizeof(char) * (10 * i + 1));
 		key[0] = 0;
 		i=0;
 		while (si[i]) {
@@ -391,7 +418,7 @@ GF_BaseInterface *gf_modules_load_interface(GF_ModuleManager *pm, u32 whichplug,
 			if (InterfaceFamily==si[i]) found = GF_TRUE;
 			i++;
 		}
-		gf_cfg_set_key(pm->cfg, "PluginsCache", inst->name, key);
+		module_set_cache(inst, key);
 		gf_free(key);
 		if (!found) goto err_exit;
 	}
@@ -53,6 +53,8 @@ typedef struct
 	LoadInterface load_func;
 	ShutdownInterface destroy_func;
 	char* dir;
+	/*size and modification date of the module file, used to validate the module cache entry*/
+	u64 file_size, file_mtime;
 } ModuleInstance;
 
 
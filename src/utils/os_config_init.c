@@ -570,6 +570,9 @@ static GF_Config *create_default_config(char *file_path)
 	gf_cfg_set_key(cfg, "FontEngine", "FontDirectory", szPath);
 
 	gf_cfg_set_key(cfg, "Downloader", "CleanCache", "200M");
+	/*idle HTTP connections are kept for reuse, set MaxIdleConnectionsPerHost to 0 to disable*/
+	gf_cfg_set_key(cfg, "Downloader", "MaxIdleConnectionsPerHost", "4");
+	gf_cfg_set_key(cfg, "Downloader", "IdleConnectionTimeout", "10000");
 	gf_cfg_set_key(cfg, "Compositor", "AntiAlias", "All");
 	gf_cfg_set_key(cfg, "Compositor", "FrameRate", "30.0");
 	/*use power-of-2 emulation in OpenGL if no rectangular texture extension*/
@@ -821,6 +821,8 @@ void gf_sys_init(GF_MemTrackerType mem_tracker_type)
 	}
 }
 
+void gf_trace_close();
+
 GF_EXPORT
 void gf_sys_close()
 {
@@ -830,6 +832,8 @@ void gf_sys_close()
 		/*prevent any call*/
 		last_update_time = 0xFFFFFFFF;
 
+		gf_trace_close();
+
 #if defined(WIN32) && !defined(_WIN32_WCE)
 		timeEndPeriod(1);
 
@@ -52,7 +52,7 @@
 
 #endif
 
-
+GF_EXPORT
 GF_Err gf_rmdir(char *DirPathName)
 {
 #if defined (_WIN32_WCE)
@@ -149,6 +149,7 @@ static Bool delete_dir(void *cbck, char *item_name, char *item_path, GF_FileEnum
 	return GF_FALSE;
 }
 
+GF_EXPORT
 GF_Err gf_cleanup_dir(char* DirPathName)
 {
 	Bool directory_clean_mode;
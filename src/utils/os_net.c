@@ -1225,6 +1225,40 @@ GF_Err gf_sk_receive(GF_Socket *sock, char *buffer, u32 length, u32 startFrom, u
 }
 
 
+GF_EXPORT
+GF_Err gf_sk_probe(GF_Socket *sock)
+{
+	s32 res;
+	char c;
+#ifndef __SYMBIAN32__
+	s32 ready;
+	struct timeval timeout;
+	fd_set Group;
+#endif
+	if (!sock || !sock->socket) return GF_BAD_PARAM;
+
+#ifndef __SYMBIAN32__
+	FD_ZERO(&Group);
+	FD_SET(sock->socket, &Group);
+	timeout.tv_sec = 0;
+	timeout.tv_usec = 0;
+
+	ready = select((int) sock->socket+1, &Group, NULL, NULL, &timeout);
+	if (ready == SOCKET_ERROR) return GF_IP_NETWORK_FAILURE;
+	if (!ready || !FD_ISSET(sock->socket, &Group)) return GF_IP_NETWORK_EMPTY;
+#endif
+	res = (s32) recv(sock->socket, &c, 1, MSG_PEEK);
+	if (res > 0) return GF_OK;
+	if (res == 0) return GF_IP_CONNECTION_CLOSED;
+	switch (LASTSOCKERROR) {
+	case EAGAIN:
+		return GF_IP_NETWORK_EMPTY;
+	default:
+		return GF_IP_CONNECTION_CLOSED;
+	}
+}
+
+GF_EXPORT
 GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 {
 	s32 i;
@@ -1236,6 +1270,7 @@ GF_Err gf_sk_listen(GF_Socket *sock, u32 MaxConnection)
 	return GF_OK;
 }
 
+GF_EXPORT
 GF_Err gf_sk_accept(GF_Socket *sock, GF_Socket **newConnection)
 {
 	u32 client_address_size;
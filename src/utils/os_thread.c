@@ -410,6 +410,16 @@ u32 gf_th_id()
 #endif
 }
 
+GF_EXPORT
+const char *gf_th_name(u32 th_id)
+{
+#ifndef GPAC_DISABLE_LOG
+	return log_th_name(th_id);
+#else
+	return NULL;
+#endif
+}
+
 
 /*********************************************************************
 						OS-Specific Mutex Object
@@ -43,6 +43,70 @@
 #define XML_INPUT_SIZE	4096
 
 
+#if defined(WIN32) && !defined(__GNUC__)
+# include <intrin.h>
+# define GPAC_HAS_SSE2
+#else
+# ifdef __SSE2__
+#  include <emmintrin.h>
+#  define GPAC_HAS_SSE2
+# endif
+#endif
+
+#ifdef GPAC_HAS_SSE2
+static GFINLINE u32 xml_popcount16(u32 v)
+{
+	v = v - ((v >> 1) & 0x5555);
+	v = (v & 0x3333) + ((v >> 2) & 0x3333);
+	v = (v + (v >> 4)) & 0x0F0F;
+	return (v + (v >> 8)) & 0x1F;
+}
+
+static GFINLINE u32 xml_first_bit(u32 v)
+{
+#if defined(WIN32) && !defined(__GNUC__)
+	unsigned long idx;
+	_BitScanForward(&idx, v);
+	return (u32) idx;
+#else
+	return (u32) __builtin_ctz(v);
+#endif
+}
+#endif
+
+/*returns the offset of the first c1 or c2 char in buf[0, len[ (len if none), adding the line feeds found before it to nb_lines*/
+static u32 xml_sax_scan_delimiter(const char *buf, u32 len, char c1, char c2, u32 *nb_lines)
+{
+	u32 i = 0, lines = 0;
+#ifdef GPAC_HAS_SSE2
+	__m128i v1 = _mm_set1_epi8(c1);
+	__m128i v2 = _mm_set1_epi8(c2);
+	__m128i vlf = _mm_set1_epi8('\n');
+
+	while (i + 16 <= len) {
+		__m128i data = _mm_loadu_si128((const __m128i *) (buf + i));
+		u32 found = (u32) _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(data, v1), _mm_cmpeq_epi8(data, v2)));
+		u32 lf = (u32) _mm_movemask_epi8(_mm_cmpeq_epi8(data, vlf));
+		if (found) {
+			u32 pos = xml_first_bit(found);
+			lines += xml_popcount16(lf & ((1<<pos) - 1));
+			*nb_lines += lines;
+			return i + pos;
+		}
+		lines += xml_popcount16(lf);
+		i += 16;
+	}
+#endif
+	for (; i<len; i++) {
+		char c = buf[i];
+		if ((c==c1) || (c==c2)) break;
+		if (c=='\n') lines++;
+	}
+	*nb_lines += lines;
+	return i;
+}
+
+
 static GF_Err gf_xml_sax_parse_intern(GF_SAXParser *parser, char *current);
 
 static char *xml_translate_xml_string(char *str)
@@ -203,6 +267,10 @@ static GF_XMLSaxAttribute *xml_get_sax_attribute(GF_SAXParser *parser)
 static void xml_sax_swap(GF_SAXParser *parser)
 {
 	if (parser->current_pos && ((parser->sax_state==SAX_STATE_TEXT_CONTENT) || (parser->sax_state==SAX_STATE_COMMENT) ) ) {
+		/*only compact once at least half of the buffer is consumed, so that each byte is moved a bounded number of times
+		instead of moving the remaining data after each node*/
+		if (parser->line_size >= 2*parser->current_pos) return;
+
 		if (parser->line_size >= parser->current_pos) {
 			parser->line_size -= parser->current_pos;
 			parser->file_pos += parser->current_pos;
@@ -726,7 +794,6 @@ static GF_Err xml_sax_parse(GF_SAXParser *parser, Bool force_parse)
 	u32 i = 0;
 	Bool is_text;
 	u32 is_end;
-	u8 c;
 	char *elt, sep;
 	u32 cdata_sep;
 
@@ -741,22 +808,18 @@ restart:
 			is_text = GF_TRUE;
 		case SAX_STATE_ELEMENT:
 			elt = NULL;
-			i=0;
-			while ((c = parser->buffer[parser->current_pos+i]) !='<') {
-				if ((parser->init_state==2) && (c ==']')) {
-					parser->sax_state = SAX_STATE_ATT_NAME;
-					parser->current_pos+=i+1;
-					goto restart;
-				}
-				i++;
-				if (c=='\n') parser->line++;
-
-				if (parser->current_pos+i==parser->line_size) {
-					if ((parser->line_size>=2*XML_INPUT_SIZE) && !parser->init_state)
-						parser->sax_state = SAX_STATE_SYNTAX_ERROR;
+			/*look for next markup, ']' also ends the DOCTYPE internal subset*/
+			i = xml_sax_scan_delimiter(parser->buffer + parser->current_pos, parser->line_size - parser->current_pos, '<', (parser->init_state==2) ? ']' : '<', &parser->line);
+			if (parser->current_pos+i==parser->line_size) {
+				if ((parser->line_size - parser->current_pos >= 2*XML_INPUT_SIZE) && !parser->init_state)
+					parser->sax_state = SAX_STATE_SYNTAX_ERROR;
 
-					goto exit;
-				}
+				goto exit;
+			}
+			if (parser->buffer[parser->current_pos+i] == ']') {
+				parser->sax_state = SAX_STATE_ATT_NAME;
+				parser->current_pos+=i+1;
+				goto restart;
 			}
 			if (is_text && i) {
 				xml_sax_store_text(parser, i);
@@ -770,7 +833,7 @@ restart:
 			cdata_sep = 0;
 			while (1) {
 				char c = parser->buffer[parser->current_pos+1+i];
-				if (!strncmp(parser->buffer+parser->current_pos+1+i, "!--", 3)) {
+				if ((c=='!') && (parser->buffer[parser->current_pos+2+i]=='-') && (parser->buffer[parser->current_pos+3+i]=='-')) {
 					parser->sax_state = SAX_STATE_COMMENT;
 					i += 3;
 					break;
@@ -0,0 +1,43 @@
+#!/bin/sh
+
+#@parallel_test imports the given sources sequentially and with -parallel, and checks both outputs are the same
+parallel_test ()
+{
+test_begin "mp4box-parallel-$2"
+
+if [ $test_skip  = 1 ] ; then
+ return
+fi
+
+seqfile="$TEMP_DIR/$2-seq.mp4"
+parfile="$TEMP_DIR/$2-par.mp4"
+
+do_test "$MP4BOX $1 -new $seqfile" "sequential"
+do_hash_test $seqfile "sequential"
+
+do_test "$MP4BOX -parallel $1 -new $parfile" "parallel"
+do_hash_test $parfile "parallel"
+
+#compare hashes of sequential and parallel imports
+do_compare_file_hashes $seqfile $parfile
+rv=$?
+
+if [ $rv != 0 ] ; then
+result="Hash is not the same between sequential and parallel imports"
+fi
+
+test_end
+}
+
+#create our test file
+mp4file="$TEMP_DIR/source_media.mp4"
+$MP4BOX -add $MEDIA_DIR/auxiliary_files/enst_video.h264 -add $MEDIA_DIR/auxiliary_files/enst_audio.aac -new $mp4file 2> /dev/null
+
+parallel_test "-add $MEDIA_DIR/auxiliary_files/enst_video.h264 -add $MEDIA_DIR/auxiliary_files/enst_audio.aac" "raw"
+
+#the audio track keeps its ID, the video track ID is allocated after it
+parallel_test "-add $mp4file#audio -add $MEDIA_DIR/auxiliary_files/enst_video.h264" "track-id"
+
+parallel_test "-add $mp4file -add $MEDIA_DIR/auxiliary_files/enst_audio.aac" "mp4-and-raw"
+
+rm $mp4file 2> /dev/null